@@ -8,7 +8,7 @@
   *          The goal of the library is to provide the functionalities for touch sensing
   *			 to prototypes. Library derived from Azoteq's IQS266 library example.
   **********************************************************************************
-  * @attention  Requires standard Arduino Libraries: Arduino.h, Wire.h.
+  * @attention  Requires standard Arduino Libraries: Arduino.h, Wire.h (unless another transport is set with setTransport).
   */
 
   // Include Files
@@ -18,9 +18,15 @@
 /*                                                CONSTRUCTORS                                                */
 /**************************************************************************************************************/
 IQS7222::IQS7222() {
-
+    // Channels without an electrode in the layout are reported as -1
+    for (uint8_t i = 0; i < IQS7222_NUM_CHANNELS; i++)
+        channelTest[i] = (layoutChannels() & (0x01 << i)) ? (int8_t)i : -1;
+    clearTouch();
 }
 
+// Bus clocks probed by probeClock, slowest first
+static const uint32_t busClocks[BUS_NUM_CLOCKS] = { BUS_CLOCK_STANDARD, BUS_CLOCK_FAST, BUS_CLOCK_FAST_PLUS };
+
 /**************************************************************************************************************/
 /*                                              PUBLIC METHODS                                                */
 /**************************************************************************************************************/
@@ -35,6 +41,7 @@ IQS7222::IQS7222() {
   *         Receiving a true return value only means that the IQS device responded to the request for communication.
   *         Receiving a false return value means that initialization did not take place at all.
   *         If communication is successfully established then it is unlikely than initialization will fail.
+  *         The setup is written at 100kHz, the fastest reliable clock is then selected with probeClock.
   */
 bool IQS7222::begin(uint8_t deviceAddressIn, uint8_t readyPinIn)
 {
@@ -42,37 +49,125 @@ bool IQS7222::begin(uint8_t deviceAddressIn, uint8_t readyPinIn)
     _readyPin = readyPinIn;
 
     // Initialize I2C communication
-    Wire.begin();
-    Wire.setClock(400000);
+    _transport->begin();
+    setClockIndex(0);
 
     // Request communication and run ATI routine.
     bool response = false;
     response = requestComms();
     if (response)
     {
-        Serial.println("Initial Setup Begin");
+        IQS7222_LOG("Initial Setup Begin");
         acknowledgeReset(RESTART);
-        initialSetup(STOP);
-        Serial.println("Initial Setup Complete");
+        initialSetup(RESTART);
+        probeClock(STOP);
+        IQS7222_LOG("Initial Setup Complete");
         //autoTune(STOP);
     }
     return response;
 }
 
+/**
+  * @name   setTransport
+  * @brief  Method to select the bus transport used to communicate with the device.
+  * @param  transport -> The transport, e.g. a Linux i2c-dev or mock transport. wireTransport is used by default.
+  * @retval None.
+  * @notes  Must be called before begin, the transport is not copied and must outlive the driver.
+  */
+void IQS7222::setTransport(IQS7222_transport& transport)
+{
+    _transport = &transport;
+}
+
+/**
+  * @name   probeClock
+  * @brief  Method to select the fastest bus clock, up to 1MHz, at which the device is read back reliably.
+  * @param  stopOrRestart -> A boolean which specifies whether the communication window should remain open or be closed after transfer.
+  *                           False keeps it open, true closes it. Use the STOP and RESTART definitions.
+  * @retval The selected bus clock in Hz.
+  * @notes  Must be called inside a communication window. Starting at 100kHz, the cycle and button setup blocks are read
+  *         back BUS_PROBE_READS times at each clock and compared with the active profile (or with each other when no
+  *         profile is loaded). The first clock which fails ends the probe and the previous clock is kept, clocks which
+  *         the transport does not support are skipped. The clock is lowered again at runtime if failures accumulate.
+  */
+uint32_t IQS7222::probeClock(bool stopOrRestart)
+{
+    uint8_t selected = _clockIndex;
+
+    for (uint8_t index = 0; index < BUS_NUM_CLOCKS; index++)
+    {
+        // Clocks the transport cannot set are skipped, e.g. a Linux adapter only runs at its kernel clock
+        if (!setClockIndex(index))
+            continue;
+
+        bool reliable = true;
+        for (uint8_t read = 0; (read < BUS_PROBE_READS) && reliable; read++)
+            reliable = verifyBlock(0, RESTART) && verifyBlock(PROFILE_BUTTON_BLOCK, RESTART);
+        if (!reliable)
+            break;
+        selected = index;
+    }
+
+    setClockIndex(selected);
+    _busTransactions = 0;
+    _busErrors = 0;
+    if (stopOrRestart == STOP)
+        endWindow();
+
+    IQS7222_LOG("Bus clock: %lu Hz", (unsigned long)busClocks[selected]);
+    return busClocks[selected];
+}
+
+/**
+  * @name   getClock
+  * @brief  Method which returns the bus clock in use.
+  * @param  None.
+  * @retval The bus clock in Hz.
+  * @notes  None.
+  */
+uint32_t IQS7222::getClock(void)
+{
+    return busClocks[_clockIndex];
+}
+
 /**
   * @name   beginHeadless
   * @brief  Method to initialize the IQS7222 device with the device address without a ready pin.
   * @param  deviceAddress -> The address of the IQS7222 device.
   * @retval Returns true if communication has been successfully established, returns false if not.
-  * @notes  Not implemented yet
+  * @notes  Without a ready pin the device is addressed directly until it acknowledges, with the delay between attempts
+  *         doubled from POLL_BACKOFF_MIN up to POLL_BACKOFF_MAX, for as long as requestComms would wait for a window.
+  *         The setup is written at 100kHz, the fastest reliable clock is then selected with probeClock.
+  *         Read the reports with pollReport afterwards.
   */
 bool IQS7222::beginHeadless(uint8_t deviceAddressIn)
 {
+    uint8_t transferBytes[2];
+    uint32_t backoff = POLL_BACKOFF_MIN;
+    uint32_t start;
+
     _deviceAddress = deviceAddressIn;
 
     // Initialize I2C communication
-    Wire.begin();
-    Wire.setClock(400000);
+    _transport->begin();
+    setClockIndex(0);
+
+    start = micros();
+    while (!readRandomBytes(SYS_FLAGS, 2, transferBytes, RESTART))
+    {
+        if ((micros() - start) >= ((uint32_t)READY_RETRIES * READY_RETRY_TIME))
+            return false;
+        delayMicroseconds(backoff);
+        backoff = min(backoff * 2, (uint32_t)POLL_BACKOFF_MAX);
+    }
+
+    IQS7222_LOG("Initial Setup Begin");
+    acknowledgeReset(RESTART);
+    initialSetup(RESTART);
+    probeClock(STOP);
+    IQS7222_LOG("Initial Setup Complete");
+    beginPolling();
+    return true;
 }
 
 /**
@@ -90,6 +185,9 @@ bool IQS7222::requestComms(void)
     bool response = false;        // The return value. Is set to true if a response is received within 100ms.
     uint16_t notReadyCount = 0;  // Increments every time the loop executes to keep track of how long the request is going on.
 
+    IQS7222_COUNT(rdyRequests, 1);
+    IQS7222_PROBE_START(rdyStart);
+
     // Pull the ready bus LOW to let the IQS7222 device know you want to communicate.
     toggleReady();
 
@@ -100,28 +198,223 @@ bool IQS7222::requestComms(void)
         delayMicroseconds(100);
 
         if ((notReadyCount % 1000) == 0)
+        {
+            IQS7222_COUNT(rdyTimeouts, 1);
             return response;
+        }
         if ((notReadyCount % 100) == 0)
             toggleReady();
     }
+    IQS7222_PROBE_STOP(PROBE_RDY_WAIT, rdyStart, 0, 0);
+    _readyTick = micros();
+    _readySeen = true;
     response = true;
     return response;
 }
 
+/**
+  * @name   beginAsync
+  * @brief  Method to start the initialisation of the IQS7222 device as a cooperative operation.
+  * @param  deviceAddress -> The address of the IQS7222 device.
+  *         readyPin      -> The Arduino pin connected to the ready pin of the IQS7222 device.
+  * @retval Returns true if the operation was started, returns false if another operation is in progress.
+  * @notes  Performs the same steps as begin without blocking: call tick until it returns STEP_DONE or STEP_FAILED.
+  *         The initial setup, with the unused conversion cycles disabled, is written at 100kHz one block per tick and
+  *         the bus clock is then probed with one read-back per tick, as by probeClock. All of it happens inside a
+  *         single communication window, the ticks must follow each other closely enough for the device not to close
+  *         it, e.g. a 1kHz control loop. Without an initialisation header only the reset is acknowledged and the clock
+  *         stays at 100kHz, call probeClock once a profile is applied.
+  */
+bool IQS7222::beginAsync(uint8_t deviceAddressIn, uint8_t readyPinIn)
+{
+    if (_asyncOp != ASYNC_NONE)
+        return false;
+
+    _deviceAddress = deviceAddressIn;
+    _readyPin = readyPinIn;
+
+    // Initialize I2C communication
+    _transport->begin();
+    setClockIndex(0);
+
+    return startAsync(ASYNC_BEGIN);
+}
+
+/**
+  * @name   requestCommsAsync
+  * @brief  Method to start a communication request as a cooperative operation.
+  * @param  None.
+  * @retval Returns true if the operation was started, returns false if another operation is in progress.
+  * @notes  Performs the same steps as requestComms without blocking: tick returns STEP_DONE once the communication window
+  *         is open and STEP_FAILED after READY_RETRIES unanswered requests.
+  */
+bool IQS7222::requestCommsAsync(void)
+{
+    return startAsync(ASYNC_REQUEST_COMMS);
+}
+
+/**
+  * @name   autoTuneAsync
+  * @brief  Method to start a recalibration (ATI) of the IQS7222 device as a cooperative operation.
+  * @param  None.
+  * @retval Returns true if the operation was started, returns false if another operation is in progress.
+  * @notes  Requests a communication window and runs autoTune in it, call tick until it returns STEP_DONE or STEP_FAILED.
+  *         The ATI results are cached by serviceEvent when the device reports the ATI event.
+  */
+bool IQS7222::autoTuneAsync(void)
+{
+    return startAsync(ASYNC_AUTO_TUNE);
+}
+
+/**
+  * @name   tick
+  * @brief  Method which advances the cooperative operation in progress by at most one step.
+  * @param  None.
+  * @retval STEP_IDLE if no operation is in progress, STEP_BUSY while it is in progress, then STEP_DONE or STEP_FAILED once.
+  * @notes  A step is one READY pin edge, one READY pin poll or one register transaction, so a tick never waits.
+  *         Call it from the control loop, e.g. at 1kHz, instead of the blocking begin, requestComms and autoTune.
+  */
+STEP_STATUS IQS7222::tick(void)
+{
+    uint32_t now = micros();
+
+    if (_asyncOp == ASYNC_NONE)
+        return STEP_IDLE;
+
+    switch (_asyncStep)
+    {
+    case ASYNC_RDY_PULL:
+        // Pull the ready bus LOW to let the IQS7222 device know you want to communicate.
+        pinMode(_readyPin, OUTPUT);
+        digitalWrite(_readyPin, LOW);
+        _asyncTime = now;
+        _asyncStep = ASYNC_RDY_RELEASE;
+        return STEP_BUSY;
+
+    case ASYNC_RDY_RELEASE:
+        if ((now - _asyncTime) < READY_PULSE_TIME)
+            return STEP_BUSY;
+        digitalWrite(_readyPin, HIGH);
+        pinMode(_readyPin, INPUT);
+        _asyncTime = now;
+        _asyncStep = ASYNC_RDY_WAIT;
+        return STEP_BUSY;
+
+    case ASYNC_RDY_WAIT:
+        if (digitalRead(_readyPin))
+        {
+            if ((now - _asyncTime) < READY_RETRY_TIME)
+                return STEP_BUSY;
+            if (++_asyncIndex >= READY_RETRIES)
+            {
+                IQS7222_COUNT(rdyTimeouts, 1);
+                return finishAsync(STEP_FAILED);
+            }
+            _asyncStep = ASYNC_RDY_PULL;
+            return STEP_BUSY;
+        }
+        _asyncIndex = 0;
+        if (_asyncOp == ASYNC_REQUEST_COMMS)
+            return finishAsync(STEP_DONE);
+        _asyncStep = (_asyncOp == ASYNC_BEGIN) ? ASYNC_ACK_READ : ASYNC_ATI_READ;
+        return STEP_BUSY;
+
+    case ASYNC_ACK_READ:
+        IQS7222_LOG("Initial Setup Begin");
+        // Same transactions as acknowledgeReset, one per tick
+        if (!readRandomBytes(CONTROL_SETTING, 2, _asyncBytes, RESTART))
+            return finishAsync(STEP_FAILED);
+        _asyncStep = ASYNC_ACK_WRITE;
+        return STEP_BUSY;
+
+    case ASYNC_ACK_WRITE:
+        _asyncBytes[0] |= ACK_RESET_BIT;
+#if defined(IQS7222_HAS_DEFAULT_PROFILE)
+        writeRandomBytes(CONTROL_SETTING, 2, _asyncBytes, RESTART);
+        profileDefault(_profile);
+        disableCycles(_profile, ~layoutCycles);
+        _profileValid = true;
+        _asyncStep = ASYNC_SETUP;
+        return STEP_BUSY;
+#else
+        writeRandomBytes(CONTROL_SETTING, 2, _asyncBytes, STOP);
+        return finishAsync(STEP_DONE);
+#endif
+
+    case ASYNC_SETUP:
+        if (_asyncIndex < (PROFILE_NUM_BLOCKS - 1))
+        {
+            writeProfileBlock(_asyncIndex, 0, profileBlocks[_asyncIndex].length, RESTART);
+            _asyncIndex++;
+            return STEP_BUSY;
+        }
+        writeProfileBlock(_asyncIndex, 0, profileBlocks[_asyncIndex].length, RESTART);
+        _asyncIndex = 0;
+        _asyncRead = 0;
+        _asyncClock = _clockIndex;
+        _asyncStep = ASYNC_PROBE;
+        return STEP_BUSY;
+
+    case ASYNC_PROBE:
+        // Clocks the transport cannot set are skipped, the first clock which fails a read-back ends the probe
+        if ((_asyncRead == 0) && !setClockIndex(_asyncIndex))
+        {
+            if (++_asyncIndex >= BUS_NUM_CLOCKS)
+                _asyncStep = ASYNC_END;
+            return STEP_BUSY;
+        }
+        if (!verifyBlock((_asyncRead & 0x01) ? PROFILE_BUTTON_BLOCK : 0, RESTART))
+        {
+            _asyncStep = ASYNC_END;
+            return STEP_BUSY;
+        }
+        if (++_asyncRead >= (2 * BUS_PROBE_READS))
+        {
+            _asyncClock = _asyncIndex;
+            _asyncRead = 0;
+            if (++_asyncIndex >= BUS_NUM_CLOCKS)
+                _asyncStep = ASYNC_END;
+        }
+        return STEP_BUSY;
+
+    case ASYNC_END:
+        setClockIndex(_asyncClock);
+        _busTransactions = 0;
+        _busErrors = 0;
+        endWindow();
+        IQS7222_LOG("Bus clock: %lu Hz", (unsigned long)busClocks[_asyncClock]);
+        IQS7222_LOG("Initial Setup Complete");
+        return finishAsync(STEP_DONE);
+
+    case ASYNC_ATI_READ:
+        // Same transactions as autoTune, one per tick
+        if (!readRandomBytes(CONTROL_SETTING, 1, _asyncBytes, RESTART))
+            return finishAsync(STEP_FAILED);
+        _asyncStep = ASYNC_ATI_WRITE;
+        return STEP_BUSY;
+
+    case ASYNC_ATI_WRITE:
+        _asyncBytes[0] |= REDO_ATI_BIT;
+        writeRandomBytes(CONTROL_SETTING, 1, _asyncBytes, STOP);
+        return finishAsync(STEP_DONE);
+    }
+    return finishAsync(STEP_FAILED);
+}
+
 /**
   * @name checkReset
   * @brief  A method which checks if the device has reset and returns the reset status.
   * @param  None.
-  * @retval Returns true if a reset has occurred, false if no reset has occurred.
-  * @notes  If a reset has occurred the device settings should be reloaded using the begin function.
-  *     After new device settings have been reloaded the acknowledge reset function can be used
-  *     to clear the reset flag.
+  * @retval Returns true if a reset has occurred, false if no reset has occurred or the flags could not be read.
+  * @notes  If a reset has occurred the device settings should be reloaded using recoverReset.
+  *     serviceEvent and updateStream check the reset flag of every report and recover automatically.
   */
 bool IQS7222::checkReset(bool stopOrRestart)
 {
     uint8_t transferBytes[1]; // A temporary array to hold the byte to be transferred.
     // Read the System Flags from the IQS7222.
-    readRandomBytes(SYS_FLAGS, 1, transferBytes, stopOrRestart);
+    if (!readRandomBytes(SYS_FLAGS, 1, transferBytes, stopOrRestart))
+        return false;
     transferBytes[0] &= SHOW_RESET_BIT;
     // Return the reset status.
     if (transferBytes[0] != 0)
@@ -143,13 +436,74 @@ bool IQS7222::checkReset(bool stopOrRestart)
 void IQS7222::acknowledgeReset(bool stopOrRestart)
 {
     uint8_t transferBytes[2]; // A temporary array to hold the bytes to be transferred.
-    readRandomBytes(CONTROL_SETTING, 2, transferBytes, RESTART);
+    if (!readRandomBytes(CONTROL_SETTING, 2, transferBytes, RESTART))
+        return;
     // Write the Ack Reset bit to 1 to clear the Show Reset Flag.
     transferBytes[0] |= ACK_RESET_BIT;
     // Write the new byte to the System Flags address.
     writeRandomBytes(CONTROL_SETTING, 2, transferBytes, stopOrRestart);
 }
 
+/**
+  * @name   recoverReset
+  * @brief  A method which restores the device configuration after an unexpected reset, e.g. a brown-out.
+  * @param  stopOrRestart -> A boolean which specifies whether the communication window should remain open or be closed after transfer.
+  *                           False keeps it open, true closes it. Use the STOP and RESTART definitions.
+  * @retval None.
+  * @notes  The register image of the active profile is written back with one burst per block. The image includes the
+  *         ATI results stored by cacheAtiResults and the runtime changes mirrored from other writes, e.g. the interface
+  *         mode and event mask, so event delivery resumes without a new ATI. The reset flag is then acknowledged.
+  *         The number of resets and the last recovery time are reported by getStats.
+  */
+void IQS7222::recoverReset(bool stopOrRestart)
+{
+    IQS7222_PROBE_START(recoveryStart);
+
+    if (_profileValid)
+    {
+        for (uint8_t i = 0; i < PROFILE_NUM_BLOCKS; i++)
+            writeProfileBlock(i, 0, profileBlocks[i].length, RESTART);
+    }
+    acknowledgeReset(stopOrRestart);
+
+    // Drop the touch state, it has been lost with the reset
+    touch.flagByte = 0;
+    for (auto& channel : event_channel)
+        channel = false;
+    _streamTouch = 0;
+    clearTouch();
+
+    IQS7222_COUNT(resets, 1);
+#if defined(IQS7222_ENABLE_STATS)
+    _stats.recoveryTime = IQS7222_PROBE_CLOCK() - recoveryStart;
+#endif
+    IQS7222_PROBE_STOP(PROBE_SETUP, recoveryStart, 0, PROFILE_NUM_BLOCKS);
+}
+
+/**
+  * @name   cacheAtiResults
+  * @brief  A method which reads the multipliers and compensation found by the ATI of every channel into the active profile.
+  * @param  stopOrRestart -> A boolean which specifies whether the communication window should remain open or be closed after transfer.
+  *                           False keeps it open, true closes it. Use the STOP and RESTART definitions.
+  * @retval None.
+  * @notes  Called automatically by serviceEvent on an ATI event. The cached values are restored by recoverReset.
+  *         A channel whose read fails keeps its previous values.
+  */
+void IQS7222::cacheAtiResults(bool stopOrRestart)
+{
+    if (!_profileValid)
+        return;
+
+    for (uint8_t i = 0; i < PROFILE_NUM_CHANNELS; i++)
+    {
+        const Profile_block& block = profileBlocks[PROFILE_CHANNEL_BLOCK + i];
+        uint8_t transferBytes[4];
+        // Multipliers and compensation are the third and fourth words of the channel setup
+        if (readRandomBytes(block.address + 2, 4, transferBytes, (i == (PROFILE_NUM_CHANNELS - 1)) ? stopOrRestart : RESTART))
+            memcpy(&_profile.image[block.offset + 4], transferBytes, 4);
+    }
+}
+
 /**
   * @name   autoTune
   * @brief  A method which sets the REDO_ATI_BIT in order to force the IQS7222 device to run the
@@ -163,7 +517,8 @@ void IQS7222::autoTune(bool stopOrRestart)
 {
     uint8_t transferBytes[1]; // Array to store the bytes transferred.
 
-    readRandomBytes(CONTROL_SETTING, 1, transferBytes, RESTART);
+    if (!readRandomBytes(CONTROL_SETTING, 1, transferBytes, RESTART))
+        return;
     // Mask the settings with the REDO_ATI_BIT.
     transferBytes[0] |= REDO_ATI_BIT;  // This is the bit required to start an ATI routine.
     // Write the new byte to the required device.
@@ -182,7 +537,8 @@ void IQS7222::softReset(bool stopOrRestart)
 {
     uint8_t transferBytes[1]; // Array to store the bytes transferred.
 
-    readRandomBytes(CONTROL_SETTING, 1, transferBytes, RESTART);
+    if (!readRandomBytes(CONTROL_SETTING, 1, transferBytes, RESTART))
+        return;
     // Mask the settings with the REDO_ATI_BIT.
     transferBytes[0] |= REDO_ATI_BIT;  // This is the bit required to start an ATI routine.
     // Write the new byte to the required device.
@@ -191,39 +547,25 @@ void IQS7222::softReset(bool stopOrRestart)
 
 /**
   * @name   printCounts
-  * @brief  A method which reads the current channel counts and prints them in the Serial Monitor
+  * @brief  A method which reads the current channel counts and prints them to the logging sink
   * @param  stopOrRestart -> A boolean which specifies whether the communication window should remain open or be closed after transfer.
   *                           False keeps it open, true closes it. Use the STOP and RESTART definitions.
   * @retval None.
-  * @notes  None.
+  * @notes  Nothing is printed unless IQS7222_LOG_SINK is defined, see IQS7222_log.h.
   */
 void IQS7222::printCounts(bool stopOrRestart)
 {
     uint8_t transferBytes[20]; // Array to store the bytes transferred.
-    readRandomBytes(CH0_COUNTS, 20, transferBytes, STOP);
-   /* for (size_t i = 0; i < 9; i++)
-    {
-        Serial.print(transferBytes[i]);
-        Serial.print(",");
-    
-    Serial.println(transferBytes[9]);*/
-    Serial.print("CH1:");
-    Serial.print((transferBytes[3] << 8) + transferBytes[2]);
-    Serial.print(",");
-    Serial.print("CH2:");
-    Serial.print((transferBytes[5] << 8) + transferBytes[4]);
-    Serial.print(",");
-    Serial.print("CH3:");
-    Serial.print((transferBytes[7] << 8) + transferBytes[6]);
-    Serial.print(",");
-    Serial.print("CH6:");
-    Serial.print((transferBytes[13] << 8) + transferBytes[12]);
-    Serial.print(",");
-    Serial.print("CH7:");
-    Serial.print((transferBytes[15] << 8) + transferBytes[14]);
-    Serial.print(",");
-    Serial.print("CH8:");
-    Serial.println((transferBytes[17] << 8) + transferBytes[16]);
+    if (!readRandomBytes(CH0_COUNTS, 20, transferBytes, stopOrRestart))
+        return;
+
+    IQS7222_LOG("CH1:%u,CH2:%u,CH3:%u,CH6:%u,CH7:%u,CH8:%u",
+        (unsigned int)((transferBytes[3] << 8) + transferBytes[2]),
+        (unsigned int)((transferBytes[5] << 8) + transferBytes[4]),
+        (unsigned int)((transferBytes[7] << 8) + transferBytes[6]),
+        (unsigned int)((transferBytes[13] << 8) + transferBytes[12]),
+        (unsigned int)((transferBytes[15] << 8) + transferBytes[14]),
+        (unsigned int)((transferBytes[17] << 8) + transferBytes[16]));
 }
 
 
@@ -238,368 +580,1775 @@ void IQS7222::printCounts(bool stopOrRestart)
 void IQS7222::getTouchEvents(bool stopOrRestart)
 {
     uint8_t transferBytes[2];
-    readRandomBytes(TOUCH_FLAGS, 2, transferBytes, stopOrRestart);
+    if (!readRandomBytes(TOUCH_FLAGS, 2, transferBytes, stopOrRestart))
+        return;
 
+    IQS7222_PROBE_START(decodeStart);
     uint16_t byteData = (transferBytes[1] << 8) + transferBytes[0];
 
     touch.flagByte = byteData;
-    
-    //for (size_t i = 0; i < 10; i++)
-    //{
-    //    if (touch.channel_array[i] == 1)
-    //    {
-    //        Serial.print((String)"ch" + i + ": " + touch.channel_array[i] + "; ");
-    //    }
-    //    
-    //}
+    IQS7222_PROBE_STOP(PROBE_DECODE, decodeStart, TOUCH_FLAGS, 2);
 }
 
 /**
   * @name   setEventMask
-  * @brief  A method which reads the events flags
+  * @brief  A method which selects the events which trigger a communication window in event mode.
   * @param  mask ->  Use the EVENT_MASK enumerator to specify the events to be enabled.
   *         numEvents -> An integer to indicate the number of elements in the mask array to be iterated upon to add to the EVENT_SETUP mask. 
   *         stopOrRestart -> A boolean which specifies whether the communication window should remain open or be closed after transfer.
   *                           False keeps it open, true closes it. Use the STOP and RESTART definitions.
   * @retval None.
-  * @notes  None.
+  * @notes  Events which are not in the array are disabled.
   */
 void IQS7222::setEventMask(EVENT_MASK mask[], uint8_t numEvents, bool stopOrRestart)
 {
-    uint8_t transferBytes[2];
-    
-    readRandomBytes(EVENT_SETUP, 2, transferBytes, RESTART);
-    
-    transferBytes[0] &= ~0x3;
-    transferBytes[1] &= ~0x30;
+    uint16_t events = 0;
 
     for (int i = 0; i < numEvents; i++)
-    {
-
-        transferBytes[0] |= (mask[i] & 0xFF00);
-        transferBytes[1] |= ((mask[i] & 0xFF) >> 8);
+        events |= mask[i];
 
-    }
-
-    writeRandomBytes(EVENT_SETUP, 2, transferBytes, stopOrRestart);
-    
-    Serial.println((transferBytes[1] << 8) + transferBytes[0], BIN);
+    setEventMask(events, stopOrRestart);
 }
 
 /**
-  * @name   setInterface
-  * @brief  A method which writes to the events flags
-  * @param  mode ->  Use the INTERFACE_MODE enumerator to specify the mode to be enabled. 
+  * @name   setEventMask
+  * @brief  A method which selects the events which trigger a communication window in event mode.
+  * @param  events -> The EVENT_MASK values of the events to be enabled combined with a bitwise OR, e.g. (TOUCH | PROX).
   *         stopOrRestart -> A boolean which specifies whether the communication window should remain open or be closed after transfer.
   *                           False keeps it open, true closes it. Use the STOP and RESTART definitions.
   * @retval None.
-  * @notes  Change pin to OUTPUT, pull LOW, delay, pull HIGH, change pin back to INPUT.
+  * @notes  The prox and touch enables are held in the low byte of EVENT_SETUP, the ATI and power enables in the high byte.
+  *         Other bits of the register are preserved.
   */
-void IQS7222::setInterface(INTERFACE_MODE mode, bool stopOrRestart)
+void IQS7222::setEventMask(uint16_t events, bool stopOrRestart)
 {
-    uint8_t transferBytes[1];
-    readRandomBytes(CONTROL_SETTING, 1, transferBytes, RESTART);
-
-    transferBytes[0] &= ~0xC0;
-    transferBytes[0] |= mode;
+    uint8_t transferBytes[2];
 
-    writeRandomBytes(CONTROL_SETTING, 1, transferBytes, stopOrRestart);
-}
+    if (!readRandomBytes(EVENT_SETUP, 2, transferBytes, RESTART))
+        return;
 
-/**
-  * @name   getEventFlags
-  * @brief  A method which reads the event flags
-  * @param  stopOrRestart -> A boolean which specifies whether the communication window should remain open or be closed after transfer.
-  *                           False keeps it open, true closes it. Use the STOP and RESTART definitions.
-  * @retval 16bit integer containing the different events - see EVENT_MASK for exact bit
-  * @notes  None.
-  */
-uint16_t IQS7222::getEventFlags(bool stopOrRestart)
-{
-    uint8_t transferBytes[2];
+    transferBytes[0] &= ~(PROX | TOUCH);
+    transferBytes[1] &= ~((POWER | ATI) >> 8);
+    transferBytes[0] |= (events & (PROX | TOUCH));
+    transferBytes[1] |= ((events & (POWER | ATI)) >> 8);
 
-    readRandomBytes(EVENT_FLAGS, 2, transferBytes, stopOrRestart);
+    writeRandomBytes(EVENT_SETUP, 2, transferBytes, stopOrRestart);
 
-    return uint16_t((transferBytes[1] << 8) + transferBytes[0]);
+    _eventMask = events & (POWER | ATI | TOUCH | PROX);
 }
 
 /**
-  * @name   getTouchChannel
-  * @brief  A method which reads the touch channel flags
-  * @param  stopOrRestart -> A boolean which specifies whether the communication window should remain open or be closed after transfer.
+  * @name   beginEventMode
+  * @brief  A method which programs the wanted events and switches the device to event mode.
+  * @param  events -> The EVENT_MASK values of the events to be enabled combined with a bitwise OR, e.g. (TOUCH | PROX).
+  *         stopOrRestart -> A boolean which specifies whether the communication window should remain open or be closed after transfer.
   *                           False keeps it open, true closes it. Use the STOP and RESTART definitions.
-  * @retval 16bit integer containing the flags for channel 0 through 9 - bit 10 to 15 are unassigned
-  * @notes  None.
+  * @retval None.
+  * @notes  Must be called inside a communication window, e.g. after requestComms.
+  *         Once in event mode the device only opens a window when one of the events occurs, the MCU should then
+  *         only access the bus when eventPending returns true.
   */
-uint16_t IQS7222::getTouchChannel(bool stopOrRestart)
+void IQS7222::beginEventMode(uint16_t events, bool stopOrRestart)
 {
-    uint8_t transferBytes[2];
-
-    readRandomBytes(TOUCH_FLAGS, 2, transferBytes, stopOrRestart);
-
-    return uint16_t((transferBytes[1] << 8) + transferBytes[0]);
+    setEventMask(events, RESTART);
+    setInterface(EVENT, stopOrRestart);
 }
 
 /**
-  * @name   ackowledgeEvent
-  * @brief  A method which reads the events and touch channel flags and updates the relevant parameters when the RDY line is pulled down.
-  * @param  stopOrRestart -> A boolean which specifies whether the communication window should remain open or be closed after transfer.
-  *                           False keeps it open, true closes it. Use the STOP and RESTART definitions.
-  * @retval None.
-  * @notes  None.
+  * @name   eventPending
+  * @brief  A method which checks if the device has opened a communication window.
+  * @param  None.
+  * @retval Returns true if the RDY line is LOW, returns false if not.
+  * @notes  No I2C traffic is generated, call this method as often as needed while idle. The first call which sees the
+  *         line LOW stamps the readyTick of the next report.
   */
-void IQS7222::ackowledgeEvent(bool stopOrRestart)
+bool IQS7222::eventPending(void)
 {
-    uint8_t transferBytes[2] = { 0,0 };
-
-    readRandomBytes(EVENT_FLAGS, 1, transferBytes, RESTART);
+    if (digitalRead(_readyPin) != LOW)
+        return false;
 
-    if (transferBytes[0] & TOUCH)
+    if (!_readySeen)
     {
-        readRandomBytes(TOUCH_FLAGS, 2, transferBytes, stopOrRestart);
-
-        uint16_t event_checking = (transferBytes[1] << 8) + transferBytes[0];
-        int index = 0;
-
-        while (index < 9) {
-            if (event_checking & 0x01) {
-                if (event_channel[index] == 1)
-                {
-                    Serial.println((String)"Channel " + index + " touch released");
-                    event_channel[index] = 0;
-                }
-                else
-                {
-                    Serial.println((String)"Channel " + index + "touch");
-                    event_channel[index] = 1;
-                }
-            }
-
-            index++;
-            event_checking = event_checking >> 1;
-        }
-        for (size_t i = 0; i < 10; i++)
-        {
-            Serial.print((String)" CH" + i + ": " + event_channel[i]);
-        }
-        Serial.println(" ");
+        _readyTick = micros();
+        _readySeen = true;
     }
+    return true;
 }
 
 /**
-  * @name   verifyEvent
-  * @brief  A method which verifies if channels that are marked as active are still active after a period of time
-  * @param  stopOrRestart -> A boolean which specifies whether the communication window should remain open or be closed after transfer.
-  *                           False keeps it open, true closes it. Use the STOP and RESTART definitions.
-  * @retval None.
-  * @notes  None.
+  * @name   waitForEvent
+  * @brief  A method which waits for the device to open a communication window.
+  * @param  timeout -> Maximum time to wait in milliseconds, 0 waits forever.
+  * @retval Returns true if a window has been opened, returns false if the timeout expired.
+  * @notes  No I2C traffic is generated while waiting, yield is called so that the core can idle or run other tasks.
   */
-void IQS7222::verifyEvent(bool stopOrRestart)
+bool IQS7222::waitForEvent(uint32_t timeout)
 {
-    uint8_t countBytes[20];
-    readRandomBytes(CH0_COUNTS, 20, countBytes, RESTART);
-    uint8_t LTABytes[20];
-    readRandomBytes(CH0_ATI, 20, countBytes, stopOrRestart);
+    uint32_t start = millis();
 
-    // if no channel has a count value greater than what is expected for a touch then all of of the active channels are set to false
-    if (compareCounts(countBytes, LTABytes, 10, 0))
+    while (!eventPending())
     {
-        for (size_t i = 0; i < 10; i++)
-        {
-            Serial.println("Resetting channel touch flags");
-            event_channel[i] = false;
-        }
+        if ((timeout != 0) && ((millis() - start) >= timeout))
+            return false;
+        yield();
     }
-
+    return true;
 }
 
 /**
-  * @name   setAtiValues
-  * @brief  A method which sets the ATI values (base or target) for a specific channel.
-  * @param  baseOrTarget -> A boolean which specifies whether the BASE value or the TARGET value should be change. True modifies the BASE
-  *                         and false modifies the TARGET value of the channel.
-  *         channel -> An integer value from 0 to 5 of the selected channel needed to be modified.
-  *         value -> An integer value, if BASE value between 0-31, if TARGET between 0-255.
+  * @name   serviceEvent
+  * @brief  A method which reads the flags of the signalled event and updates the touch state.
+  * @param  snapshot -> The structure which will receive the decoded flags.
   *         stopOrRestart -> A boolean which specifies whether the communication window should remain open or be closed after transfer.
   *                           False keeps it open, true closes it. Use the STOP and RESTART definitions.
-  * @retval None.
-  * @notes  None.
+  * @retval Returns true if the event was read into snapshot, returns false if the device did not respond.
+  * @notes  Call inside the communication window opened by the device. The system and event flags are read with a
+  *         single burst, the prox and touch flags and the slider outputs are only read if a prox or touch event is
+  *         signalled, or with the system flags in one burst when the transport closes the window after every read
+  *         (keepsWindow). ATI and power events are fully described by the system flags. The signalled events are returned
+  *         in snapshot.eventFlags, see EVENT_MASK. The decoded event is published to readState, a failed read is
+  *         neither decoded nor published.
   */
-void IQS7222::setAtiValues(bool baseOrTarget, uint8_t channel, uint8_t value, bool stopOrRestart)
+bool IQS7222::serviceEvent(Sensor_snapshot& snapshot, bool stopOrRestart)
 {
-    uint8_t transferBytes[2];
-    uint8_t channelAdd[6] = { 0x100, 0x600, 0x200, 0x700, 0x300, 0x800 };
+    uint8_t transferBytes[STREAM_REPORT_SIZE];
+    bool wholeReport = !_transport->keepsWindow();
+    bool channelEvent;
 
-    uint16_t channelRegister = CH0_ATI | channelAdd[channel];
+    snapshot.readyTick = takeReadyTick(micros());
+    snapshot.proxFlags = 0;
+    snapshot.touchFlags = touch.flagByte;
+    snapshot.countsMask = 0;
 
-    readRandomBytes(channelRegister, 2, transferBytes, RESTART);
+    // A transport which closes the window after every read gets the whole report in one burst
+    if (!readRandomBytes(SYS_FLAGS, wholeReport ? STREAM_REPORT_SIZE : 4, transferBytes, RESTART))
+        return false;
+    snapshot.systemFlags = (transferBytes[1] << 8) + transferBytes[0];
+    snapshot.eventFlags = (transferBytes[3] << 8) + transferBytes[2];
 
-    if (baseOrTarget) 
+    if (snapshot.systemFlags & SHOW_RESET_BIT)
     {
-        if (value < 0x20)
-            transferBytes[0] = (value << 3);
-    } 
-    else 
+        recoverReset(stopOrRestart);
+        snapshot.touchFlags = 0;
+        snapshot.readTick = micros();
+        publishState(snapshot, false);
+        return true;
+    }
+    if (snapshot.eventFlags & ATI)
+        cacheAtiResults(RESTART);
+
+    channelEvent = (snapshot.eventFlags & (PROX | TOUCH)) != 0;
+    if (!channelEvent)
     {
-        if (value < 0x100)
-            transferBytes[1] = value;
+        if (stopOrRestart == STOP)
+            endWindow();
+        snapshot.readTick = micros();
+        publishState(snapshot, false);
+        return true;
     }
-    
-    writeRandomBytes(channelRegister, 2, transferBytes, stopOrRestart);
+    if (!wholeReport && !readRandomBytes(PROX_FLAGS, STREAM_REPORT_SIZE - 4, &transferBytes[4], stopOrRestart))
+        return false;
+
+    IQS7222_PROBE_START(decodeStart);
+    snapshot.proxFlags = (transferBytes[5] << 8) + transferBytes[4];
+    snapshot.touchFlags = (transferBytes[7] << 8) + transferBytes[6];
+    snapshot.slider[0] = (transferBytes[9] << 8) + transferBytes[8];
+    snapshot.slider[1] = (transferBytes[11] << 8) + transferBytes[10];
+    touch.flagByte = snapshot.touchFlags;
+    for (uint8_t i = 0; i < IQS7222_NUM_CHANNELS; i++)
+        event_channel[i] = (snapshot.touchFlags >> i) & 0x01;
+    IQS7222_PROBE_STOP(PROBE_DECODE, decodeStart, PROX_FLAGS, STREAM_REPORT_SIZE - 4);
+
+    snapshot.readTick = micros();
+    publishState(snapshot, true);
+    return true;
 }
 
 /**
-  * @name   setAtiValues
-  * @brief  A method which sets the ATI values (base or target) for a specific channel.
-  * @param  baseOrTarget -> A boolean which specifies whether the BASE value or the TARGET value should be change. True modifies the BASE
-  *                         and false modifies the TARGET value of the channel.
-  *         channel -> An array of integer values from 0 to 5 of the selected channel needed to be modified.
-  *         numChannels -> Number of channels that are being modified at once.
-  *         value -> An integer value, if BASE value between 0-31, if TARGET between 0-255.
-  *         stopOrRestart -> A boolean which specifies whether the communication window should remain open or be closed after transfer.
+  * @name   beginStreamTouch
+  * @brief  A method which switches the device to the stream in touch interface.
+  * @param  stopOrRestart -> A boolean which specifies whether the communication window should remain open or be closed after transfer.
   *                           False keeps it open, true closes it. Use the STOP and RESTART definitions.
   * @retval None.
-  * @notes  None.
+  * @notes  Must be called inside a communication window. The device then streams a window every report while a touch
+  *         is active and only opens windows for the enabled events otherwise, use updateStream in every window.
   */
-void IQS7222::setAtiValues(bool baseOrTarget, uint8_t channel[], uint8_t numChannels, uint8_t value, bool stopOrRestart)
+void IQS7222::beginStreamTouch(bool stopOrRestart)
 {
-    for (size_t i = 0; i < (numChannels - 1); i++)
-        setAtiValues(baseOrTarget, channel[i], value, RESTART);
-    setAtiValues(baseOrTarget, channel[numChannels-1], value, stopOrRestart);
+    _streamTouch = 0;
+    setInterface(STREAM_TOUCH, stopOrRestart);
 }
 
 /**
-  * @name   addTouch
-  * @brief  A method which adds the current touch channel to an array of previous events. 
-  * @param  None.
-  * @retval None.
-  * @notes  None.
+  * @name   updateStream
+  * @brief  A method which reads one report of the stream in touch pipeline.
+  * @param  snapshot -> The structure which will receive the decoded flags, counts and LTA.
+  *         stopOrRestart -> A boolean which specifies whether the communication window should remain open or be closed after transfer.
+  *                           False keeps it open, true closes it. Use the STOP and RESTART definitions.
+  * @retval Returns true if the report was read into snapshot, returns false if the device did not respond.
+  * @notes  While the panel is idle only the flags are read in a single burst. While a touch is active, and for the report
+  *         following its release, the counts and LTA of the touched channels and their neighbours are also read, they
+  *         are marked in snapshot.countsMask. A failed read is neither decoded nor published.
   */
-void IQS7222::addTouch(void)
+bool IQS7222::updateStream(Sensor_snapshot& snapshot, bool stopOrRestart)
 {
-    uint8_t transferBytes[1];
-    readRandomBytes(TOUCH_FLAGS, 1, transferBytes, RESTART);
+    uint8_t transferBytes[STREAM_REPORT_SIZE];
 
-    for (size_t i = 0; i < 8; i++)
+    snapshot.readyTick = takeReadyTick(micros());
+    if (!readStreamReport(transferBytes, snapshot, stopOrRestart))
+        return false;
+    return decodeStream(transferBytes, snapshot, stopOrRestart);
+}
+
+/**
+  * @name   beginPolling
+  * @brief  A method which starts reading the reports without the ready pin, see pollReport.
+  * @param  None.
+  * @retval None.
+  * @notes  The report period is seeded from the normal power report rate of the active profile, or POLL_DEFAULT_PERIOD,
+  *         and the first poll is due one period from now. Called by beginHeadless, call it again after the report
+  *         rates are changed.
+  */
+void IQS7222::beginPolling(void)
+{
+    _pollPeriod = POLL_DEFAULT_PERIOD;
+    if (_profileValid)
+    {
+        uint16_t npOffset = PROFILE_SYSTEM_OFFSET + (NP_REPORT - CONTROL_SETTING) * 2;
+        uint32_t npReport = (_profile.image[npOffset + 1] << 8) + _profile.image[npOffset];
+        _pollPeriod = constrain(npReport * 1000, (uint32_t)POLL_MIN_PERIOD, (uint32_t)POLL_MAX_PERIOD);
+    }
+    _pollInterval = _pollPeriod;
+    _pollLast = micros();
+    _pollNext = _pollLast + _pollInterval;
+    _pollBackoff = POLL_BACKOFF_MIN;
+    _pollMisses = 0;
+    _pollHits = 0;
+    _pollAnchored = false;
+}
+
+/**
+  * @name   pollReport
+  * @brief  A method which reads the next report of the stream pipeline without the ready pin.
+  * @param  snapshot -> The structure which will receive the decoded flags, counts and LTA.
+  *         stopOrRestart -> A boolean which specifies whether the communication window should remain open or be closed after transfer.
+  *                           False keeps it open, true closes it. Use the STOP and RESTART definitions.
+  * @retval Returns true if a report was read into snapshot, returns false if no report was due, the device did not
+  *         acknowledge the poll or the counts of the report could not be read.
+  * @notes  Call as often as needed, it never waits and only addresses the device once a report is due. A poll is a
+  *         single read attempt of the flags, the device does not acknowledge it outside its communication window.
+  *         A missed poll is retried after POLL_BACKOFF_MIN, doubled at every miss up to POLL_BACKOFF_MAX. The next poll
+  *         is scheduled one interval after the last report. The interval is shortened by 1/2^POLL_PERIOD_SHIFT when a poll
+  *         hits on its first attempt, so the polls drift towards the opening of the windows. A hit after a miss marks an
+  *         opening: the learnt period is moved towards the time since the previous opening divided by the reports read
+  *         in between, and the interval is reset to it. After more than POLL_RESYNC_HITS first attempt hits in a row the
+  *         period is instead taken from the time since the previous report, as windows may have been skipped. The polls
+  *         thus track the report rate of the current power mode.
+  *         Missed polls are not counted as bus errors.
+  *         Reports are then processed as by updateStream, the device must be in a stream interface.
+  */
+bool IQS7222::pollReport(Sensor_snapshot& snapshot, bool stopOrRestart)
+{
+    uint8_t transferBytes[STREAM_REPORT_SIZE];
+    uint32_t now = micros();
+    bool success;
+
+    if ((int32_t)(now - _pollNext) < 0)
+        return false;
+
+    IQS7222_COUNT(pollAttempts, 1);
+    _readAttempts = 1;
+    success = readStreamReport(transferBytes, snapshot, stopOrRestart);
+    _readAttempts = TRANSPORT_READ_ATTEMPTS;
+
+    if (!success)
+    {
+        IQS7222_COUNT(pollMisses, 1);
+        if (_pollMisses != 0xFF)
+            _pollMisses++;
+        _pollNext = now + _pollBackoff;
+        _pollBackoff = min(_pollBackoff * 2, (uint32_t)POLL_BACKOFF_MAX);
+        return false;
+    }
+
+    // A hit on the first attempt only bounds the period from above, probe a shorter one. A hit after a miss marks the
+    // opening of a window, every report read since the previous such hit took one window.
+    if (_pollHits != 0xFF)
+        _pollHits++;
+    if (_pollMisses == 0)
+    {
+        _pollInterval -= _pollInterval >> POLL_PERIOD_SHIFT;
+    }
+    else
+    {
+        // After a run of first attempt hits, windows may have been skipped: the device has sped up, the interval has
+        // just shrunk below its period and the time since the previous report is the best estimate
+        if (_pollHits > POLL_RESYNC_HITS)
+            _pollPeriod = now - _pollLast;
+        else if (_pollAnchored)
+            _pollPeriod += ((int32_t)((now - _pollAnchor) / _pollHits) - (int32_t)_pollPeriod) >> POLL_FILTER_SHIFT;
+        _pollPeriod = constrain(_pollPeriod, (uint32_t)POLL_MIN_PERIOD, (uint32_t)POLL_MAX_PERIOD);
+        _pollInterval = _pollPeriod;
+        _pollAnchor = now;
+        _pollAnchored = true;
+        _pollHits = 0;
+    }
+    _pollInterval = max(_pollInterval, (uint32_t)POLL_MIN_PERIOD);
+
+    _pollLast = now;
+    _pollNext = now + _pollInterval;
+    _pollBackoff = POLL_BACKOFF_MIN;
+    _pollMisses = 0;
+
+    // The acknowledged poll is the first sight of the window
+    _readySeen = false;
+    snapshot.readyTick = now;
+    return decodeStream(transferBytes, snapshot, stopOrRestart);
+}
+
+/**
+  * @name   getPollPeriod
+  * @brief  A method which returns the report period learnt by pollReport.
+  * @param  None.
+  * @retval The report period in microseconds.
+  * @notes  None.
+  */
+uint32_t IQS7222::getPollPeriod(void)
+{
+    return _pollPeriod;
+}
+
+/**
+  * @name   formatSnapshot
+  * @brief  A method which formats a report as a line for the host, see utils/latency_monitor.py.
+  * @param  snapshot -> The report returned by updateStream, pollReport or serviceEvent.
+  *         buffer   -> The array which will receive the line, SNAPSHOT_LINE_SIZE bytes are always enough.
+  *         length   -> The size of the buffer.
+  * @retval Number of characters written, excluding the terminating null, 0 if the buffer is too small.
+  * @notes  The line is SNAPSHOT_LINE_PREFIX followed by the readyTick, the readTick, the micros() of the call (sendTick)
+  *         in decimal and the system, event, prox and touch flags in hex and the slider outputs in decimal, separated by
+  *         commas and ended by a newline. Call it just before sending the line so that the host can correlate the
+  *         sendTick with its arrival.
+  */
+size_t IQS7222::formatSnapshot(const Sensor_snapshot& snapshot, char buffer[], size_t length)
+{
+    int written = snprintf(buffer, length, SNAPSHOT_LINE_PREFIX ",%lu,%lu,%lu,%04X,%04X,%04X,%04X,%u,%u\n",
+        (unsigned long)snapshot.readyTick, (unsigned long)snapshot.readTick, (unsigned long)micros(),
+        snapshot.systemFlags, snapshot.eventFlags, snapshot.proxFlags, snapshot.touchFlags,
+        snapshot.slider[0], snapshot.slider[1]);
+
+    if ((written < 0) || ((size_t)written >= length))
+    {
+        if (length != 0)
+            buffer[0] = '\0';
+        return 0;
+    }
+    return written;
+}
+
+/**
+  * @name   readState
+  * @brief  A method which copies the decoded device state published after the last report.
+  * @param  state -> The structure which will receive the state.
+  * @retval Number of reports published so far, modulo the counter size, compare with stateVersion to skip unchanged states.
+  * @notes  Safe to call from any thread or interrupt while the driver is reading reports, it never blocks the driver and
+  *         only copies again if a report was published during the copy. Prefer it to the public touch members when the
+  *         reports are read in another context.
+  */
+Seqlock_count IQS7222::readState(Sensor_state& state) const
+{
+    return _state.read(state);
+}
+
+/**
+  * @name   stateVersion
+  * @brief  A method which returns the number of reports published so far.
+  * @param  None.
+  * @retval Number of reports, modulo the counter size.
+  * @notes  Does not copy the state, safe to call from any context.
+  */
+Seqlock_count IQS7222::stateVersion(void) const
+{
+    return _state.version();
+}
+
+/**
+  * @name   beginWakePipeline
+  * @brief  A method which starts the prox triggered wake pipeline with only the prox events armed.
+  * @param  stopOrRestart -> A boolean which specifies whether the communication window should remain open or be closed after transfer.
+  *                           False keeps it open, true closes it. Use the STOP and RESTART definitions.
+  * @retval None.
+  * @notes  Must be called inside a communication window once the profile has been applied. The device is put in event mode
+  *         and left to drop to ULP through its own timeouts, call updateWakePipeline in every window it opens.
+  *         Called again while the pipeline is out of IDLE, the LP report rate kept on entering PREWARM is restored.
+  */
+void IQS7222::beginWakePipeline(bool stopOrRestart)
+{
+    uint16_t lpOffset = PROFILE_SYSTEM_OFFSET + (LP_REPORT - CONTROL_SETTING) * 2;
+
+    // The mirrored image holds the raised rate outside of IDLE
+    if (_wakeStage == WAKE_IDLE)
+    {
+        _wakeLpReport[0] = _profile.image[lpOffset];
+        _wakeLpReport[1] = _profile.image[lpOffset + 1];
+    }
+    else
+    {
+        writeRandomBytes(LP_REPORT, 2, _wakeLpReport, RESTART);
+    }
+    _wakeStage = WAKE_IDLE;
+
+    beginEventMode(PROX, stopOrRestart);
+}
+
+/**
+  * @name   updateWakePipeline
+  * @brief  A method which services one communication window of the wake pipeline and moves between its stages.
+  * @param  snapshot -> The structure which will receive the decoded flags, and the counts while a touch is active.
+  *         stopOrRestart -> A boolean which specifies whether the communication window should remain open or be closed after transfer.
+  *                           False keeps it open, true closes it. Use the STOP and RESTART definitions.
+  * @retval The stage of the pipeline after the window, see WAKE_STAGE.
+  * @notes  The stage is kept if the report could not be read.
+  *         IDLE -> PREWARM on a prox event: the touch events are armed, the LP report rate is raised to the NP report rate
+  *         and the gesture history is cleared so that the first touch is recognised without delay.
+  *         PREWARM -> ACTIVE on a touch event: the device streams in touch and updateStream reads the counts.
+  *         A touch seen while IDLE goes through the PREWARM arming before ACTIVE.
+  *         ACTIVE -> PREWARM once the touch is released, PREWARM -> IDLE once the prox is released. A report which
+  *         releases both while ACTIVE goes straight back to IDLE.
+  */
+WAKE_STAGE IQS7222::updateWakePipeline(Sensor_snapshot& snapshot, bool stopOrRestart)
+{
+    uint8_t transferBytes[2];
+
+    if (_wakeStage == WAKE_ACTIVE)
+    {
+        if (!updateStream(snapshot, RESTART))
+            return _wakeStage;
+        if ((snapshot.touchFlags == 0) && (snapshot.proxFlags == 0))
+        {
+            // Both released in the same report, no prox event will follow to unwind PREWARM
+            _wakeStage = WAKE_IDLE;
+            setInterface(EVENT, RESTART);
+            writeRandomBytes(LP_REPORT, 2, _wakeLpReport, RESTART);
+            setEventMask(PROX, stopOrRestart);
+        }
+        else if (snapshot.touchFlags == 0)
+        {
+            _wakeStage = WAKE_PREWARM;
+            setInterface(EVENT, stopOrRestart);
+        }
+        else if (stopOrRestart == STOP)
+        {
+            endWindow();
+        }
+        return _wakeStage;
+    }
+
+    if (!serviceEvent(snapshot, RESTART))
+        return _wakeStage;
+
+    // A touch seen while idle is armed as a prox first, so that the PREWARM settings are in place once it is released
+    if ((_wakeStage == WAKE_IDLE) && ((snapshot.proxFlags | snapshot.touchFlags) != 0))
+    {
+        _wakeStage = WAKE_PREWARM;
+        clearTouch();
+        transferBytes[0] = _profile.image[PROFILE_SYSTEM_OFFSET + (NP_REPORT - CONTROL_SETTING) * 2];
+        transferBytes[1] = _profile.image[PROFILE_SYSTEM_OFFSET + (NP_REPORT - CONTROL_SETTING) * 2 + 1];
+        writeRandomBytes(LP_REPORT, 2, transferBytes, RESTART);
+        setEventMask(PROX | TOUCH, (snapshot.touchFlags != 0) ? RESTART : stopOrRestart);
+        if (snapshot.touchFlags == 0)
+            return _wakeStage;
+    }
+
+    if (snapshot.touchFlags != 0)
+    {
+        _wakeStage = WAKE_ACTIVE;
+        beginStreamTouch(stopOrRestart);
+    }
+    else if ((_wakeStage == WAKE_PREWARM) && (snapshot.eventFlags & PROX) && (snapshot.proxFlags == 0))
+    {
+        _wakeStage = WAKE_IDLE;
+        writeRandomBytes(LP_REPORT, 2, _wakeLpReport, RESTART);
+        setEventMask(PROX, stopOrRestart);
+    }
+    else if (stopOrRestart == STOP)
+    {
+        endWindow();
+    }
+    return _wakeStage;
+}
+
+/**
+  * @name   setInterface
+  * @brief  A method which writes to the events flags
+  * @param  mode ->  Use the INTERFACE_MODE enumerator to specify the mode to be enabled. 
+  *         stopOrRestart -> A boolean which specifies whether the communication window should remain open or be closed after transfer.
+  *                           False keeps it open, true closes it. Use the STOP and RESTART definitions.
+  * @retval None.
+  * @notes  Change pin to OUTPUT, pull LOW, delay, pull HIGH, change pin back to INPUT.
+  */
+void IQS7222::setInterface(INTERFACE_MODE mode, bool stopOrRestart)
+{
+    uint8_t transferBytes[1];
+    if (!readRandomBytes(CONTROL_SETTING, 1, transferBytes, RESTART))
+        return;
+
+    transferBytes[0] &= ~0xC0;
+    transferBytes[0] |= mode;
+
+    writeRandomBytes(CONTROL_SETTING, 1, transferBytes, stopOrRestart);
+}
+
+/**
+  * @name   getEventFlags
+  * @brief  A method which reads the event flags
+  * @param  stopOrRestart -> A boolean which specifies whether the communication window should remain open or be closed after transfer.
+  *                           False keeps it open, true closes it. Use the STOP and RESTART definitions.
+  * @retval 16bit integer containing the different events - see EVENT_MASK for exact bit, 0 if the read failed
+  * @notes  None.
+  */
+uint16_t IQS7222::getEventFlags(bool stopOrRestart)
+{
+    uint8_t transferBytes[2];
+
+    if (!readRandomBytes(EVENT_FLAGS, 2, transferBytes, stopOrRestart))
+        return 0;
+
+    return uint16_t((transferBytes[1] << 8) + transferBytes[0]);
+}
+
+/**
+  * @name   getTouchChannel
+  * @brief  A method which reads the touch channel flags
+  * @param  stopOrRestart -> A boolean which specifies whether the communication window should remain open or be closed after transfer.
+  *                           False keeps it open, true closes it. Use the STOP and RESTART definitions.
+  * @retval 16bit integer containing the flags for channel 0 through 9 - bit 10 to 15 are unassigned, 0 if the read failed
+  * @notes  None.
+  */
+uint16_t IQS7222::getTouchChannel(bool stopOrRestart)
+{
+    uint8_t transferBytes[2];
+
+    if (!readRandomBytes(TOUCH_FLAGS, 2, transferBytes, stopOrRestart))
+        return 0;
+
+    return uint16_t((transferBytes[1] << 8) + transferBytes[0]);
+}
+
+/**
+  * @name   ackowledgeEvent
+  * @brief  A method which reads the events and touch channel flags and updates the relevant parameters when the RDY line is pulled down.
+  * @param  stopOrRestart -> A boolean which specifies whether the communication window should remain open or be closed after transfer.
+  *                           False keeps it open, true closes it. Use the STOP and RESTART definitions.
+  * @retval None.
+  * @notes  None.
+  */
+void IQS7222::ackowledgeEvent(bool stopOrRestart)
+{
+    uint8_t transferBytes[2] = { 0,0 };
+
+    if (!readRandomBytes(EVENT_FLAGS, 1, transferBytes, RESTART))
+        return;
+
+    if (transferBytes[0] & TOUCH)
+    {
+        if (!readRandomBytes(TOUCH_FLAGS, 2, transferBytes, stopOrRestart))
+            return;
+
+        IQS7222_PROBE_START(decodeStart);
+        uint16_t event_checking = (transferBytes[1] << 8) + transferBytes[0];
+        int index = 0;
+
+        while (index < IQS7222_NUM_CHANNELS) {
+            if (event_checking & 0x01) {
+                if (event_channel[index] == 1)
+                {
+                    IQS7222_LOG("Channel %d touch released", index);
+                    event_channel[index] = 0;
+                }
+                else
+                {
+                    IQS7222_LOG("Channel %d touch", index);
+                    event_channel[index] = 1;
+                }
+            }
+
+            index++;
+            event_checking = event_checking >> 1;
+        }
+        IQS7222_LOG("Active channels: 0x%04X", (unsigned int)activeChannels());
+        IQS7222_PROBE_STOP(PROBE_DECODE, decodeStart, TOUCH_FLAGS, 2);
+    }
+}
+
+/**
+  * @name   activeChannels
+  * @brief  A method which packs the event_channel array into a bit mask.
+  * @param  None.
+  * @retval 16bit integer with bit n set if channel n is marked as active.
+  * @notes  No I2C traffic is generated.
+  */
+uint16_t IQS7222::activeChannels(void)
+{
+    uint16_t mask = 0;
+
+    for (uint8_t i = 0; i < IQS7222_NUM_CHANNELS; i++)
+    {
+        if (event_channel[i])
+            mask |= (0x01 << i);
+    }
+    return mask;
+}
+
+/**
+  * @name   verifyEvent
+  * @brief  A method which verifies if channels that are marked as active are still active after a period of time
+  * @param  stopOrRestart -> A boolean which specifies whether the communication window should remain open or be closed after transfer.
+  *                           False keeps it open, true closes it. Use the STOP and RESTART definitions.
+  * @retval None.
+  * @notes  None.
+  */
+void IQS7222::verifyEvent(bool stopOrRestart)
+{
+    uint8_t countBytes[2 * IQS7222_NUM_CHANNELS];
+    if (!readRandomBytes(CH0_COUNTS, 2 * IQS7222_NUM_CHANNELS, countBytes, RESTART))
+        return;
+    uint8_t LTABytes[2 * IQS7222_NUM_CHANNELS];
+    if (!readRandomBytes(CH0_LTA, 2 * IQS7222_NUM_CHANNELS, LTABytes, stopOrRestart))
+        return;
+
+    // if no channel has a count value greater than what is expected for a touch then all of of the active channels are set to false
+    if (compareCounts(countBytes, LTABytes, IQS7222_NUM_CHANNELS, 0))
+    {
+        IQS7222_LOG("Resetting channel touch flags");
+        for (size_t i = 0; i < IQS7222_NUM_CHANNELS; i++)
+            event_channel[i] = false;
+    }
+
+}
+
+/**
+  * @name   setAtiValues
+  * @brief  A method which sets the ATI values (base or target) for a specific channel.
+  * @param  baseOrTarget -> A boolean which specifies whether the BASE value or the TARGET value should be change. True modifies the BASE
+  *                         and false modifies the TARGET value of the channel.
+  *         channel -> An integer value from 0 to 5 of the selected channel needed to be modified.
+  *         value -> An integer value, if BASE value between 0-31, if TARGET between 0-255.
+  *         stopOrRestart -> A boolean which specifies whether the communication window should remain open or be closed after transfer.
+  *                           False keeps it open, true closes it. Use the STOP and RESTART definitions.
+  * @retval None.
+  * @notes  None.
+  */
+void IQS7222::setAtiValues(bool baseOrTarget, uint8_t channel, uint8_t value, bool stopOrRestart)
+{
+    uint8_t transferBytes[2];
+    uint16_t channelAdd[6] = { 0x100, 0x600, 0x200, 0x700, 0x300, 0x800 };
+
+    uint16_t channelRegister = CH0_ATI | channelAdd[channel];
+
+    if (!readRandomBytes(channelRegister, 2, transferBytes, RESTART))
+        return;
+
+    if (baseOrTarget) 
+    {
+        if (value < 0x20)
+            transferBytes[0] = (value << 3);
+    } 
+    else 
+    {
+        if (value < 0x100)
+            transferBytes[1] = value;
+    }
+    
+    writeRandomBytes(channelRegister, 2, transferBytes, stopOrRestart);
+}
+
+/**
+  * @name   setAtiValues
+  * @brief  A method which sets the ATI values (base or target) for a specific channel.
+  * @param  baseOrTarget -> A boolean which specifies whether the BASE value or the TARGET value should be change. True modifies the BASE
+  *                         and false modifies the TARGET value of the channel.
+  *         channel -> An array of integer values from 0 to 5 of the selected channel needed to be modified.
+  *         numChannels -> Number of channels that are being modified at once.
+  *         value -> An integer value, if BASE value between 0-31, if TARGET between 0-255.
+  *         stopOrRestart -> A boolean which specifies whether the communication window should remain open or be closed after transfer.
+  *                           False keeps it open, true closes it. Use the STOP and RESTART definitions.
+  * @retval None.
+  * @notes  None.
+  */
+void IQS7222::setAtiValues(bool baseOrTarget, uint8_t channel[], uint8_t numChannels, uint8_t value, bool stopOrRestart)
+{
+    for (size_t i = 0; i < (numChannels - 1); i++)
+        setAtiValues(baseOrTarget, channel[i], value, RESTART);
+    setAtiValues(baseOrTarget, channel[numChannels-1], value, stopOrRestart);
+}
+
+/**
+  * @name   addTouch
+  * @brief  A method which reads the touch flags and adds the current touch channel to an array of previous events. 
+  * @param  None.
+  * @retval The swipe completed by the touch, NO_SWIPE if none or if the flags could not be read, see identifySwipe.
+  * @notes  Only the touch flags are read, multi-touch and palm frames are rejected from the bitmap alone.
+  */
+DIRECTION IQS7222::addTouch(void)
+{
+    uint8_t transferBytes[2];
+    Sensor_snapshot snapshot;
+
+    if (!readRandomBytes(TOUCH_FLAGS, 2, transferBytes, RESTART))
+        return NO_SWIPE;
+    snapshot.touchFlags = (transferBytes[1] << 8) + transferBytes[0];
+    snapshot.countsMask = 0;
+    return addTouch(snapshot);
+}
+
+/**
+  * @name   addTouch
+  * @brief  A method which adds the touch channel of a report to an array of previous events. 
+  * @param  snapshot -> The report holding the touch flags and, if read, the counts and LTA of the touched channels.
+  * @retval The swipe completed by the touch, NO_SWIPE if none, see identifySwipe.
+  * @notes  No I2C traffic is generated. Only single finger reports are added, the channel with the largest delta is used
+  *         when the counts were read and the lowest touched channel otherwise. A channel is only added when it differs
+  *         from the last one added, the oldest is overwritten once TOUCH_HISTORY_SIZE channels are kept. Multi-touch
+  *         and palm reports clear the array so that they cannot complete a swipe, and so does a recognised swipe so
+  *         that it is reported once.
+  */
+DIRECTION IQS7222::addTouch(const Sensor_snapshot& snapshot)
+{
+    IQS7222_PROBE_START(gestureStart);
+    TOUCH_CLASS frame = classifyTouch(snapshot);
+    DIRECTION swipe = NO_SWIPE;
+
+    if ((frame == TOUCH_MULTI) || (frame == TOUCH_PALM))
+    {
+        clearTouch();
+    }
+    else if (frame == TOUCH_SINGLE)
+    {
+        int8_t channel = -1;
+        int16_t strongest = INT16_MIN;
+        for (uint8_t i = 0; i < IQS7222_NUM_CHANNELS; i++)
+        {
+            if (!(snapshot.touchFlags & (0x01 << i)) || (channelTest[i] < 0))
+                continue;
+
+            int16_t delta = (snapshot.countsMask & (0x01 << i)) ? channelDelta(snapshot, i) : INT16_MIN;
+            if ((channel < 0) || (delta > strongest))
+            {
+                channel = i;
+                strongest = delta;
+            }
+        }
+
+        size_t newest = (previousTouchIndex + TOUCH_HISTORY_SIZE - 1) % TOUCH_HISTORY_SIZE;
+        if (previousTouch[newest] != channelTest[channel])
+        {
+            // The array is full when the next entry is the oldest one and holds a channel
+            if ((previousTouchIndex == previousTouchRear) && (previousTouch[previousTouchRear] >= 0))
+                previousTouchRear = (previousTouchRear + 1) % TOUCH_HISTORY_SIZE;
+            previousTouch[previousTouchIndex] = channelTest[channel];
+            previousTouchIndex = (previousTouchIndex + 1) % TOUCH_HISTORY_SIZE;
+
+            swipe = identifySwipe();
+            if (swipe != NO_SWIPE)
+                clearTouch();
+        }
+    }
+
+    IQS7222_PROBE_STOP(PROBE_GESTURE, gestureStart, 0, 0);
+    return swipe;
+}
+
+/**
+  * @name   classifyTouch
+  * @brief  A method which classifies the touched channels of a report as no touch, single finger, multi-touch or palm.
+  * @param  snapshot -> The report holding the touch flags and, if read, the counts and LTA of the touched channels.
+  * @retval The class of the report, also stored in touchClass.
+  * @notes  No I2C traffic is generated. Touched channels within a TOUCH_FINGER_CELLS square are a single finger, a single
+  *         cluster of adjacent channels larger than that or TOUCH_PALM_CHANNELS touched channels are a palm, separate
+  *         clusters are a multi-touch. When the counts of every touched channel were read, a sum of deltas reaching
+  *         TOUCH_PALM_STRENGTH is also a palm, and two peaks in the deltas are a multi-touch even if the channels are
+  *         adjacent. A peak is a touched channel whose delta reaches TOUCH_PEAK_DELTA and those of its neighbours read
+  *         with it, a finger between two channels splits its delta and does not make two peaks. A palm is reported
+  *         until every channel has been released, as a palm lifting off the panel briefly looks like a finger.
+  */
+TOUCH_CLASS IQS7222::classifyTouch(const Sensor_snapshot& snapshot)
+{
+    uint16_t touched = snapshot.touchFlags & layoutChannels();
+    uint8_t numTouched = 0;
+    int8_t minColumn = INT8_MAX, maxColumn = INT8_MIN;
+    int8_t minRow = INT8_MAX, maxRow = INT8_MIN;
+    uint32_t strength = 0;
+    uint8_t numPeaks = 0;
+
+    if (touched == 0)
+    {
+        _palmLatched = false;
+        touchClass = TOUCH_NONE;
+        return touchClass;
+    }
+
+    for (uint8_t i = 0; i < IQS7222_NUM_CHANNELS; i++)
+    {
+        if (!(touched & (0x01 << i)))
+            continue;
+
+        numTouched++;
+        minColumn = min(minColumn, layoutColumnTable[i]);
+        maxColumn = max(maxColumn, layoutColumnTable[i]);
+        minRow = min(minRow, layoutRowTable[i]);
+        maxRow = max(maxRow, layoutRowTable[i]);
+        if (!(snapshot.countsMask & (0x01 << i)))
+            continue;
+
+        int16_t delta = channelDelta(snapshot, i);
+        bool peak = (delta >= TOUCH_PEAK_DELTA);
+        if (delta > 0)
+            strength += delta;
+        for (uint8_t j = 0; (j < IQS7222_NUM_CHANNELS) && peak; j++)
+        {
+            if ((layoutNeighbourTable[i] & snapshot.countsMask & (0x01 << j)) && (channelDelta(snapshot, j) > delta))
+                peak = false;
+        }
+        if (peak)
+            numPeaks++;
+    }
+
+    // Grow a cluster of adjacent channels from the lowest touched channel
+    uint16_t cluster = touched & -touched;
+    uint16_t grown = cluster;
+    do
+    {
+        cluster = grown;
+        for (uint8_t i = 0; i < IQS7222_NUM_CHANNELS; i++)
+        {
+            if (cluster & (0x01 << i))
+                grown |= layoutNeighbourTable[i] & touched;
+        }
+    } while (grown != cluster);
+
+    bool fingerSized = ((maxColumn - minColumn) < TOUCH_FINGER_CELLS) && ((maxRow - minRow) < TOUCH_FINGER_CELLS);
+    bool countsRead = ((snapshot.countsMask & touched) == touched);
+
+    if (_palmLatched || (numTouched >= TOUCH_PALM_CHANNELS) || (countsRead && (strength >= TOUCH_PALM_STRENGTH)))
+        touchClass = TOUCH_PALM;
+    else if (numPeaks >= 2)
+        touchClass = TOUCH_MULTI;
+    else if (fingerSized)
+        touchClass = TOUCH_SINGLE;
+    else if (cluster == touched)
+        touchClass = TOUCH_PALM;
+    else
+        touchClass = TOUCH_MULTI;
+
+    _palmLatched = (touchClass == TOUCH_PALM);
+    return touchClass;
+}
+
+/**
+  * @name   clearTouch
+  * @brief  A method which clears the array of previous touch channel events by setting each element to -1.
+  * @param  None.
+  * @retval None.
+  * @notes  None.
+*/
+void IQS7222::clearTouch(void)
+{
+    for (auto& previous : previousTouch)
+        previous = -1;
+    previousTouchIndex = 0;
+    previousTouchRear = 0; 
+}
+
+
+/**
+  * @name   gestureUpdate
+  * @brief  A method which reads the counts and LTA of every electrode of the grid and updates the touch position.
+  * @param  None.
+  * @retval None.
+  * @notes  The result is available in the position member, see updatePosition.
+  */
+void IQS7222::gestureUpdate(void)
+{
+    Sensor_snapshot snapshot;
+
+    if (readChannelData(layoutChannels(), snapshot, RESTART))
+        updatePosition(snapshot);
+}
+
+/**
+  * @name   updatePosition
+  * @brief  A method which computes the fixed-point centroid of the channel deltas over the electrode grid.
+  * @param  snapshot -> The report holding the counts and LTA, only the channels in snapshot.countsMask are used.
+  * @retval Returns true if a touch is present, returns false if not.
+  * @notes  No I2C traffic is generated. The centroid is smoothed with POSITION_SMOOTHING_SHIFT and the motion of the
+  *         smoothed position since the previous report is reported in position.dx and position.dy.
+  *         A touch is present once the sum of the deltas reaches ACTIVITY_THRESHOLD.
+  */
+bool IQS7222::updatePosition(const Sensor_snapshot& snapshot)
+{
+    IQS7222_PROBE_START(positionStart);
+    uint32_t strength = 0;
+    int32_t sumX = 0;
+    int32_t sumY = 0;
+
+    for (uint8_t i = 0; i < IQS7222_NUM_CHANNELS; i++)
+    {
+        if ((layoutColumnTable[i] < 0) || !(snapshot.countsMask & (0x01 << i)))
+            continue;
+
+        int16_t delta = channelDelta(snapshot, i);
+        if (delta <= 0)
+            continue;
+
+        strength += delta;
+        sumX += (int32_t)delta * layoutColumnTable[i];
+        sumY += (int32_t)delta * layoutRowTable[i];
+    }
+
+    if (strength < ACTIVITY_THRESHOLD)
+    {
+        position.dx = 0;
+        position.dy = 0;
+        position.strength = strength;
+        position.valid = false;
+        IQS7222_PROBE_STOP(PROBE_GESTURE, positionStart, 0, 0);
+        return false;
+    }
+
+    int16_t x = (sumX * POSITION_SCALE) / (int32_t)strength;
+    int16_t y = (sumY * POSITION_SCALE) / (int32_t)strength;
+
+    if (position.valid)
+    {
+        int16_t previousX = position.x;
+        int16_t previousY = position.y;
+        int16_t stepX = x - position.x;
+        int16_t stepY = y - position.y;
+        // Rounded half away from zero, a shift would round towards minus infinity and drift left and down
+        const int16_t half = (1 << POSITION_SMOOTHING_SHIFT) >> 1;
+        position.x += (stepX + ((stepX < 0) ? -half : half)) / (1 << POSITION_SMOOTHING_SHIFT);
+        position.y += (stepY + ((stepY < 0) ? -half : half)) / (1 << POSITION_SMOOTHING_SHIFT);
+        position.dx = position.x - previousX;
+        position.dy = position.y - previousY;
+    }
+    else
+    {
+        // First report of a touch, start from the raw centroid
+        position.x = x;
+        position.y = y;
+        position.dx = 0;
+        position.dy = 0;
+    }
+    position.strength = (strength > 0xFFFF) ? 0xFFFF : strength;
+    position.valid = true;
+
+    IQS7222_PROBE_STOP(PROBE_GESTURE, positionStart, 0, 0);
+    return true;
+}
+
+/**
+  * @name   updateGesture
+  * @brief  A method which records the touch position and recognises taps, long presses and template gestures.
+  * @param  None.
+  * @retval The recognised gesture, see GESTURE, or GESTURE_NONE. Each gesture is returned once.
+  * @notes  Call after every report which updates the position (updateStream or gestureUpdate). While the panel is
+  *         released it may also be called without a report, so that a held tap is returned on time. No I2C traffic
+  *         is generated. A still touch is a long press once it lasts GESTURE_LONG_PRESS_TIME and a tap if released
+  *         within GESTURE_TAP_TIME. A tap is held until GESTURE_DOUBLE_TAP_TIME passes without a second tap, a second
+  *         tap within it is a double tap instead. Other touches are matched against the templates on release. Touches
+  *         interrupted by a multi-touch or palm report are discarded until every finger is lifted.
+  */
+uint8_t IQS7222::updateGesture(void)
+{
+    IQS7222_PROBE_START(gestureStart);
+    Gesture_track& track = _gestureTrack;
+    uint8_t gesture = GESTURE_NONE;
+    uint32_t now = millis();
+    bool tapExpired = false;
+
+    if ((touchClass == TOUCH_MULTI) || (touchClass == TOUCH_PALM))
+    {
+        track.active = false;
+        track.rejected = true;
+        tapExpired = true;
+    }
+    else if (position.valid && !track.rejected)
+    {
+        if (!track.active)
+        {
+            track.active = true;
+            track.reported = false;
+            track.length = 0;
+            track.stride = 1;
+            track.skipped = 0;
+            track.start = now;
+        }
+        gestureRecord(track, position.x >> GESTURE_POINT_SHIFT, position.y >> GESTURE_POINT_SHIFT);
+
+        if (!track.reported && ((now - track.start) >= GESTURE_LONG_PRESS_TIME) && gestureStill(track, GESTURE_STILL_DISTANCE))
+        {
+            gesture = GESTURE_LONG_PRESS;
+            track.reported = true;
+        }
+    }
+    else if (track.active)
     {
-        if (transferBytes[0] & (0x1 << i))
+        // Release of a single finger touch
+        track.active = false;
+        if (!track.reported && ((now - track.start) <= GESTURE_TAP_TIME) && gestureStill(track, GESTURE_STILL_DISTANCE))
         {
-            if (verifyPreviousTouch())
+            if (track.tapPending)
+            {
+                gesture = GESTURE_DOUBLE_TAP;
+                track.tapPending = false;
+            }
+            else
             {
-                previousTouchIndex = (previousTouchIndex % 10);
-                previousTouchRear = previousTouchRear++;
+                track.tapPending = true;
+                track.lastTap = now;
             }
-            previousTouch[previousTouchIndex] = channelTest[i];
-            previousTouchIndex++;
         }
+        else
+        {
+            if (!track.reported && !gestureStill(track, GESTURE_STILL_DISTANCE))
+                gesture = gestureMatch(track, _gestureTemplates, _gestureNumTemplates);
+            tapExpired = true;
+        }
+    }
+    if (touchClass == TOUCH_NONE)
+        track.rejected = false;
+
+    // The held tap is returned once the touches after it can no longer make a double tap
+    if (track.tapPending)
+    {
+        if (track.active)
+            tapExpired |= ((track.start - track.lastTap) > GESTURE_DOUBLE_TAP_TIME) || ((now - track.start) > GESTURE_TAP_TIME);
+        else
+            tapExpired |= ((now - track.lastTap) > GESTURE_DOUBLE_TAP_TIME);
+
+        if (tapExpired)
+        {
+            track.tapPending = false;
+            track.deferred = gesture;
+            gesture = GESTURE_TAP;
+        }
+    }
+    else if ((gesture == GESTURE_NONE) && (track.deferred != GESTURE_NONE))
+    {
+        gesture = track.deferred;
+        track.deferred = GESTURE_NONE;
     }
 
-    DIRECTION swipe = identifySwipe();
+    IQS7222_PROBE_STOP(PROBE_GESTURE, gestureStart, 0, 0);
+    return gesture;
 }
 
 /**
-  * @name   clearTouch
-  * @brief  A method which clears the array of previous touch channel events by setting each element to CHANNELS::EMPTY (0).
+  * @name   useGestureTemplates
+  * @brief  A method which selects the templates matched by updateGesture.
+  * @param  templates -> The templates, NULL to restore the built-in swipe and circle templates.
+  *         numTemplates -> Number of templates.
+  * @retval None.
+  * @notes  The table must stay valid while it is in use, it is not copied.
+  */
+void IQS7222::useGestureTemplates(const Gesture_template templates[], uint8_t numTemplates)
+{
+    if (templates == NULL)
+    {
+        _gestureTemplates = gestureDefaultTemplates;
+        _gestureNumTemplates = gestureNumDefaultTemplates;
+        return;
+    }
+    _gestureTemplates = templates;
+    _gestureNumTemplates = numTemplates;
+}
+
+/**
+  * @name   identifySwipe
+  * @brief  A method which looks for a swipe along a column of the grid in the array of previous touch events.
+  * @param  None.
+  * @retval UP or DOWN if the last channel added ends a swipe, NO_SWIPE if not.
+  * @notes  No I2C traffic is generated. A swipe is every electrode of a column of the layout grid touched in order, from
+  *         the bottom row up or from the top row down, other channels may be touched in between. The array is searched
+  *         from the newest to the oldest event, at most TOUCH_HISTORY_SIZE entries are visited.
+  */
+DIRECTION IQS7222::identifySwipe(void)
+{
+    size_t newest = (previousTouchIndex + TOUCH_HISTORY_SIZE - 1) % TOUCH_HISTORY_SIZE;
+    size_t numEvents;
+
+    if (previousTouch[previousTouchRear] < 0)
+        return NO_SWIPE;
+    numEvents = (previousTouchIndex + TOUCH_HISTORY_SIZE - previousTouchRear - 1) % TOUCH_HISTORY_SIZE + 1;
+
+    int8_t column = layoutColumnTable[previousTouch[newest]];
+    int8_t newestRow = layoutRowTable[previousTouch[newest]];
+    if (column < 0)
+        return NO_SWIPE;
+
+    // Walk the column back from the newest channel, DOWN the column for a swipe UP, empty cells are not on the path
+    for (int8_t direction = -1; direction <= 1; direction += 2)
+    {
+        bool complete = true;
+        uint8_t found = 1;
+        size_t i = 1;
+        int8_t row;
+
+        // The newest channel must end the column in the direction of the swipe
+        for (row = newestRow - direction; (row >= 0) && (row < IQS7222_GRID_ROWS); row -= direction)
+        {
+            if (layoutCell(row, column) >= 0)
+                complete = false;
+        }
+        for (row = newestRow + direction; complete && (row >= 0) && (row < IQS7222_GRID_ROWS); row += direction)
+        {
+            int8_t channel = layoutCell(row, column);
+            if (channel < 0)
+                continue;
+            while ((i < numEvents) && (previousTouch[(newest + TOUCH_HISTORY_SIZE - i) % TOUCH_HISTORY_SIZE] != channel))
+                i++;
+            complete = (i < numEvents);
+            i++;
+            found++;
+        }
+        if (complete && (found > 1))
+            return (direction < 0) ? UP : DOWN;
+    }
+    return NO_SWIPE;
+}
+
+/**
+  * @name   applyProfile
+  * @brief  A method which applies a configuration profile, only the registers which differ from the active configuration are written.
+  * @param  profile       -> The profile to be applied, e.g. filled by profileLoad or profileDefault.
+  *         stopOrRestart -> A boolean which specifies whether the communication window should remain open or be closed after transfer.
+  *                           False keeps it open, true closes it. Use the STOP and RESTART definitions.
+  * @retval Number of burst writes issued, 0 if the profile matches the active configuration.
+  * @notes  Within each changed block a single burst covers the first to the last changed word.
+  *         If no profile has been applied yet every block is written in full.
+  *         Changes to the cycle or channel settings only take effect on the counts after an autoTune.
+  */
+uint8_t IQS7222::applyProfile(const IQS7222_profile& profile, bool stopOrRestart)
+{
+    uint32_t changed = diffProfile(profile);
+    uint8_t lastBlock = 0;
+    uint8_t numWrites = 0;
+
+    for (uint8_t i = 0; i < PROFILE_NUM_BLOCKS; i++)
+    {
+        if (changed & ((uint32_t)1 << i))
+            lastBlock = i;
+    }
+
+    for (uint8_t i = 0; i < PROFILE_NUM_BLOCKS; i++)
+    {
+        if (!(changed & ((uint32_t)1 << i)))
+            continue;
+
+        const Profile_block& block = profileBlocks[i];
+        const uint8_t* newBytes = &profile.image[block.offset];
+        uint8_t* activeBytes = &_profile.image[block.offset];
+        uint8_t start = 0;
+        uint8_t end = block.length;
+
+        if (_profileValid)
+        {
+            // Narrow the burst to the changed words
+            while (newBytes[start] == activeBytes[start])
+                start++;
+            while (newBytes[end - 1] == activeBytes[end - 1])
+                end--;
+            start &= ~0x01;
+            if ((end & 0x01) && (end < block.length))
+                end++;
+        }
+
+        memcpy(&activeBytes[start], &newBytes[start], end - start);
+        writeProfileBlock(i, start, end, (i == lastBlock) ? stopOrRestart : RESTART);
+        numWrites++;
+    }
+
+    _profileValid = true;
+    return numWrites;
+}
+
+/**
+  * @name   pruneCycles
+  * @brief  A method which disables the conversion cycles which convert none of the given channels.
+  * @param  channelMask   -> Mask of the channels to keep converting, bit n for channel n.
+  *         stopOrRestart -> A boolean which specifies whether the communication window should remain open or be closed after transfer.
+  *                           False keeps it open, true closes it. Use the STOP and RESTART definitions.
+  * @retval Mask of the cycles left enabled, bit n for cycle n.
+  * @notes  Must be called inside a communication window once a profile is active. The initial setup already prunes the
+  *         cycles which do not convert a channel of the layout or of IQS7222_KEEP_CHANNELS. Both channels of a cycle are
+  *         converted at the same time, so a cycle is only disabled if neither of them is kept. Apply a profile to enable
+  *         cycles again. Only the changed words are written, see applyProfile.
+  */
+uint8_t IQS7222::pruneCycles(uint16_t channelMask, bool stopOrRestart)
+{
+    IQS7222_profile pruned;
+
+    if (!_profileValid)
+        return 0;
+
+    pruned = _profile;
+    disableCycles(pruned, ~layoutCycleMask(channelMask));
+    applyProfile(pruned, stopOrRestart);
+    return enabledCycles();
+}
+
+/**
+  * @name   enabledCycles
+  * @brief  A method which returns the conversion cycles enabled in the active profile.
+  * @param  None.
+  * @retval Mask of the enabled cycles, bit n for cycle n.
+  * @notes  None.
+  */
+uint8_t IQS7222::enabledCycles(void)
+{
+    uint8_t cycleMask = 0;
+
+    for (uint8_t cycle = 0; cycle < IQS7222_NUM_CYCLES; cycle++)
+    {
+        const uint8_t* setup = &_profile.image[PROFILE_CYCLE_OFFSET + cycle * PROFILE_CYCLE_SIZE];
+        if (setup[PROFILE_CYCLE_SETTINGS] || setup[PROFILE_CYCLE_CTX_SELECT])
+            cycleMask |= 0x01 << cycle;
+    }
+    return cycleMask;
+}
+
+/**
+  * @name   estimateReportPeriod
+  * @brief  A method which estimates the shortest report period allowed by the enabled conversion cycles.
+  * @param  stopOrRestart -> A boolean which specifies whether the communication window should remain open or be closed after transfer.
+  *                           False keeps it open, true closes it. Use the STOP and RESTART definitions.
+  * @retval The conversion time of one report in microseconds, 0 if no profile is active or the counts could not be read.
+  * @notes  Must be called inside a communication window, the counts of every channel are read with one burst. Each
+  *         enabled cycle takes one conversion pulse per count of its larger channel, with pulses at
+  *         CYCLE_CLOCK * FREQ_FRAC / 256 / (FREQ_PERIOD + 1), plus CYCLE_OVERHEAD_TIME. The result is a theoretical
+  *         bound to compare with the report rates of the profile, the device does not report faster than NP_REPORT.
+  */
+uint32_t IQS7222::estimateReportPeriod(bool stopOrRestart)
+{
+    uint8_t countBytes[2 * IQS7222_NUM_CHANNELS];
+    uint8_t cycleMask = enabledCycles();
+    uint32_t conversionTime = 0;
+
+    if (!_profileValid)
+        return 0;
+
+    if (!readRandomBytes(CH0_COUNTS, 2 * IQS7222_NUM_CHANNELS, countBytes, stopOrRestart))
+        return 0;
+
+    for (uint8_t cycle = 0; cycle < IQS7222_NUM_CYCLES; cycle++)
+    {
+        if (!(cycleMask & (0x01 << cycle)))
+            continue;
+
+        const uint8_t* setup = &_profile.image[PROFILE_CYCLE_OFFSET + cycle * PROFILE_CYCLE_SIZE];
+        uint16_t counts = 0;
+        for (uint8_t i = 0; i < IQS7222_NUM_CHANNELS; i++)
+        {
+            if (IQS7222_CYCLE_CHANNELS(cycle) & (0x01 << i))
+                counts = max(counts, (uint16_t)((countBytes[2 * i + 1] << 8) + countBytes[2 * i]));
+        }
+        conversionTime += (uint64_t)counts * (setup[PROFILE_CYCLE_FREQ_PERIOD] + 1) * 256 * 1000000
+            / ((uint64_t)CYCLE_CLOCK * max(setup[PROFILE_CYCLE_FREQ_FRAC], (uint8_t)1)) + CYCLE_OVERHEAD_TIME;
+    }
+
+    IQS7222_LOG("Cycles 0x%02X, conversion time %lu us", cycleMask, (unsigned long)conversionTime);
+    return conversionTime;
+}
+
+/**
+  * @name   beginNoiseMonitor
+  * @brief  A method which starts the noise monitor from the conversion frequencies of the active profile.
+  * @param  None.
+  * @retval None.
+  * @notes  Call once a profile is active and again after applying a profile which changes the conversion frequencies.
+  *         The levels measured at each frequency are cleared. A cycle whose fraction still holds the value written by
+  *         setConversionFrequency keeps its profile value, as does the frequency in use, so that calling it again does
+  *         not add the offset twice.
+  */
+void IQS7222::beginNoiseMonitor(void)
+{
+    uint8_t baseFrac[IQS7222_NUM_CYCLES];
+    uint8_t frequency = _noise.frequency;
+    uint8_t cycleMask = enabledCycles();
+    bool offset = (frequency != 0);
+
+    memcpy(baseFrac, _noise.baseFrac, sizeof(baseFrac));
+    _noise = {};
+    for (uint8_t cycle = 0; cycle < IQS7222_NUM_CYCLES; cycle++)
+    {
+        uint8_t frac = _profile.image[PROFILE_CYCLE_OFFSET + cycle * PROFILE_CYCLE_SIZE + PROFILE_CYCLE_FREQ_FRAC];
+
+        // The mirrored fraction is the offset one until a profile writes the cycle again
+        if ((frequency != 0) && (frac == constrain(baseFrac[cycle] + noiseFrequencyOffsets[frequency], 1, UINT8_MAX)))
+        {
+            _noise.baseFrac[cycle] = baseFrac[cycle];
+        }
+        else
+        {
+            _noise.baseFrac[cycle] = frac;
+            if (cycleMask & (0x01 << cycle))
+                offset = false;
+        }
+    }
+    _noise.frequency = offset ? frequency : 0;
+    _noise.lastChange = millis();
+}
+
+/**
+  * @name   monitorNoise
+  * @brief  A method which measures the noise of the untouched channels and changes the conversion frequency when it is
+  *         above NOISE_THRESHOLD.
+  * @param  snapshot      -> The report returned by updateStream, pollReport or serviceEvent.
+  *         stopOrRestart -> A boolean which specifies whether the communication window should remain open or be closed after transfer.
+  *                           False keeps it open, true closes it. Use the STOP and RESTART definitions.
+  * @retval The noise level of the frequency in use, the largest delta variance in counts^2, 0 while it is measured.
+  * @notes  Must be called inside the window of the report, i.e. read the report with RESTART. The channels read for the
+  *         report are sampled every report, the other channels of the layout are read every NOISE_SAMPLE_REPORTS reports.
+  *         The statistics of a channel in touch or proximity are cleared so that a touch is not taken for noise. Above
+  *         the threshold the quietest frequency is selected, see noiseQuietest, at most once per NOISE_HOLDOFF_TIME.
+  *         The new frequency is written between two reports followed by an ATI, and the reports of the next
+  *         NOISE_SETTLE_REPORTS are not sampled. Call beginNoiseMonitor first.
+  */
+uint32_t IQS7222::monitorNoise(const Sensor_snapshot& snapshot, bool stopOrRestart)
+{
+    Sensor_snapshot sample;
+    uint16_t active = snapshot.touchFlags | snapshot.proxFlags;
+    uint16_t quiet = layoutChannels() & ~active;
+    uint32_t level;
+
+    if (!_profileValid || (_noise.settle != 0))
+    {
+        if (_noise.settle != 0)
+            _noise.settle--;
+        if (stopOrRestart == STOP)
+            endWindow();
+        return 0;
+    }
+
+    readMissingChannels(snapshot, quiet, _noise.reports, NOISE_SAMPLE_REPORTS, sample, RESTART);
+
+    for (uint8_t i = 0; i < IQS7222_NUM_CHANNELS; i++)
+    {
+        if (active & (0x01 << i))
+            _noise.samples[i] = 0;
+        else if (quiet & sample.countsMask & (0x01 << i))
+            noiseSample(_noise, i, channelDelta(sample, i));
+    }
+
+    level = noiseLevel(_noise, layoutChannels());
+    if (level != 0)
+        _noise.level[_noise.frequency] = level;
+
+    if ((level > NOISE_THRESHOLD) && ((millis() - _noise.lastChange) >= NOISE_HOLDOFF_TIME))
+    {
+        uint8_t frequency = noiseQuietest(_noise);
+
+        _noise.lastChange = millis();
+        if (frequency != _noise.frequency)
+        {
+            IQS7222_LOG("Noise %lu counts^2, conversion frequency %u -> %u", (unsigned long)level, _noise.frequency, frequency);
+            setConversionFrequency(frequency, RESTART);
+            autoTune(stopOrRestart);
+            return level;
+        }
+    }
+
+    if (stopOrRestart == STOP)
+        endWindow();
+    return level;
+}
+
+/**
+  * @name   setConversionFrequency
+  * @brief  A method which programs one of the conversion frequencies of the noise monitor in every enabled cycle.
+  * @param  frequency     -> Index in noiseFrequencyOffsets, 0 restores the frequencies of the profile.
+  *         stopOrRestart -> A boolean which specifies whether the communication window should remain open or be closed after transfer.
+  *                           False keeps it open, true closes it. Use the STOP and RESTART definitions.
+  * @retval None.
+  * @notes  Must be called inside a communication window. The frequency fraction of each cycle is offset from the profile
+  *         value captured by beginNoiseMonitor, the conversion period is kept. Each cycle is one two byte write and the
+  *         writes are mirrored into the active profile so that recoverReset restores the frequency in use. Run an ATI
+  *         afterwards, see autoTune, the counts depend on the frequency.
+  */
+void IQS7222::setConversionFrequency(uint8_t frequency, bool stopOrRestart)
+{
+    uint8_t cycleMask = enabledCycles();
+    uint8_t transferBytes[2];
+
+    if (!_profileValid || (cycleMask == 0) || (frequency >= NOISE_NUM_FREQUENCIES))
+    {
+        if (stopOrRestart == STOP)
+            endWindow();
+        return;
+    }
+
+    for (uint8_t cycle = 0; cycle < IQS7222_NUM_CYCLES; cycle++)
+    {
+        if (!(cycleMask & (0x01 << cycle)))
+            continue;
+
+        transferBytes[0] = constrain(_noise.baseFrac[cycle] + noiseFrequencyOffsets[frequency], 1, UINT8_MAX);
+        transferBytes[1] = _profile.image[PROFILE_CYCLE_OFFSET + cycle * PROFILE_CYCLE_SIZE + PROFILE_CYCLE_FREQ_PERIOD];
+        writeRandomBytes(CYCLE0_SETUP0 + (cycle << 8), 2, transferBytes, (cycleMask >> (cycle + 1)) ? RESTART : stopOrRestart);
+    }
+
+    _noise.frequency = frequency;
+    _noise.settle = NOISE_SETTLE_REPORTS;
+    _noise.reports = 0;
+    noiseReset(_noise);
+}
+
+/**
+  * @name   getConversionFrequency
+  * @brief  A method which returns the conversion frequency selected by the noise monitor.
+  * @param  None.
+  * @retval Index in noiseFrequencyOffsets, 0 for the frequencies of the profile.
+  * @notes  None.
+  */
+uint8_t IQS7222::getConversionFrequency(void)
+{
+    return _noise.frequency;
+}
+
+/**
+  * @name   setGpioLink
+  * @brief  A method which routes channel and status states to the GPIO0 output.
+  * @param  link          -> The GPIO0 configuration.
+  *         stopOrRestart -> A boolean which specifies whether the communication window should remain open or be closed after transfer.
+  *                           False keeps it open, true closes it. Use the STOP and RESTART definitions.
+  * @retval None.
+  * @notes  Must be called inside a communication window. The three words are written with one burst and mirrored into the
+  *         active profile, so that recoverReset restores them.
+  */
+void IQS7222::setGpioLink(const Gpio_link& link, bool stopOrRestart)
+{
+    uint8_t transferBytes[6];
+
+    transferBytes[0] = link.setup & 0xFF;
+    transferBytes[1] = link.setup >> 8;
+    transferBytes[2] = link.channelMask & 0xFF;
+    transferBytes[3] = link.channelMask >> 8;
+    transferBytes[4] = link.statusLink & 0xFF;
+    transferBytes[5] = link.statusLink >> 8;
+    writeRandomBytes(GPIO0_GENERAL, 6, transferBytes, stopOrRestart);
+}
+
+/**
+  * @name   getGpioLink
+  * @brief  A method which returns the GPIO0 configuration of the active profile.
+  * @param  None.
+  * @retval The GPIO0 configuration.
+  * @notes  No transfer, the profile mirrors every write made through the driver.
+  */
+Gpio_link IQS7222::getGpioLink(void)
+{
+    const uint8_t* image = &_profile.image[PROFILE_GPIO_OFFSET];
+    Gpio_link link;
+
+    link.setup = (image[1] << 8) | image[0];
+    link.channelMask = (image[3] << 8) | image[2];
+    link.statusLink = (image[5] << 8) | image[4];
+    return link;
+}
+
+/**
+  * @name   linkChannelsToGpio
+  * @brief  A method which selects the channels whose state drives the GPIO0 output.
+  * @param  channelMask   -> Mask of the channels, bit n for channel n, 0 for none.
+  *         stopOrRestart -> A boolean which specifies whether the communication window should remain open or be closed after transfer.
+  *                           False keeps it open, true closes it. Use the STOP and RESTART definitions.
+  * @retval None.
+  * @notes  Must be called inside a communication window. Only GPIO0_ENABLE_MASK is written, the output settings and status
+  *         link of the profile are kept.
+  */
+void IQS7222::linkChannelsToGpio(uint16_t channelMask, bool stopOrRestart)
+{
+    uint8_t transferBytes[2];
+
+    transferBytes[0] = channelMask & 0xFF;
+    transferBytes[1] = (channelMask >> 8) & (IQS7222_CHANNEL_BITS >> 8);
+    writeRandomBytes(GPIO0_ENABLE_MASK, 2, transferBytes, stopOrRestart);
+}
+
+/**
+  * @name   attachGpioButton
+  * @brief  A method which links a single channel to GPIO0 and attaches an MCU interrupt to the pin wired to GPIO0.
+  * @param  channel       -> Index of the channel, e.g. an emergency stop button.
+  *         pin           -> MCU pin wired to GPIO0, it must support interrupts.
+  *         handler       -> Interrupt handler, called on the edge to GPIO_ACTIVE_LEVEL, i.e. when the channel activates.
+  *         stopOrRestart -> A boolean which specifies whether the communication window should remain open or be closed after transfer.
+  *                           False keeps it open, true closes it. Use the STOP and RESTART definitions.
+  * @retval Returns true if the interrupt is attached, returns false if the pin has no interrupt.
+  * @notes  Must be called inside a communication window. The device drives GPIO0 itself, so the handler runs within the
+  *         report period of the touch without any I2C transfer, whatever the bus load. The other channels are unlinked
+  *         from GPIO0, the status link of the profile is kept and should not link other sources. Use gpioButtonActive
+  *         to read the state from the handler or the loop.
+  */
+bool IQS7222::attachGpioButton(uint8_t channel, uint8_t pin, void (*handler)(void), bool stopOrRestart)
+{
+    if ((channel >= IQS7222_NUM_CHANNELS) || (digitalPinToInterrupt(pin) == NOT_AN_INTERRUPT))
+    {
+        if (stopOrRestart == STOP)
+            endWindow();
+        return false;
+    }
+
+    detachGpioButton();
+    linkChannelsToGpio(0x01 << channel, stopOrRestart);
+    pinMode(pin, INPUT_PULLUP);
+    attachInterrupt(digitalPinToInterrupt(pin), handler, (GPIO_ACTIVE_LEVEL == LOW) ? FALLING : RISING);
+    _gpioPin = pin;
+    return true;
+}
+
+/**
+  * @name   detachGpioButton
+  * @brief  A method which detaches the interrupt attached by attachGpioButton.
   * @param  None.
   * @retval None.
+  * @notes  The channel stays linked to GPIO0, see linkChannelsToGpio.
+  */
+void IQS7222::detachGpioButton(void)
+{
+    if (_gpioPin == GPIO_NO_PIN)
+        return;
+
+    detachInterrupt(digitalPinToInterrupt(_gpioPin));
+    _gpioPin = GPIO_NO_PIN;
+}
+
+/**
+  * @name   gpioButtonActive
+  * @brief  A method which returns the state of the channel attached by attachGpioButton.
+  * @param  None.
+  * @retval Returns true while GPIO0 is at GPIO_ACTIVE_LEVEL, returns false if not or if no pin is attached.
+  * @notes  Reads the MCU pin only, safe to call from the interrupt handler.
+  */
+bool IQS7222::gpioButtonActive(void)
+{
+    return (_gpioPin != GPIO_NO_PIN) && (digitalRead(_gpioPin) == GPIO_ACTIVE_LEVEL);
+}
+
+/**
+  * @name   logTelemetry
+  * @brief  A method which appends the flags, counts and LTA of every channel of a report to a telemetry log.
+  * @param  encoder       -> The log, started with Telemetry_encoder::begin.
+  *         snapshot      -> The report, as filled by updateStream, serviceEvent or pollReport.
+  *         stopOrRestart -> A boolean which specifies whether the communication window should remain open or be closed after transfer.
+  *                           False keeps it open, true closes it. Use the STOP and RESTART definitions.
+  * @retval Returns false if the missing channels could not be read or a block of the log could not be written to its sink.
+  * @notes  Must be called inside the communication window of the report. The channels missing from the snapshot are
+  *         read with two bursts, so every frame holds values of the same conversion. The frame is stamped with
+  *         snapshot.readTick.
+  */
+bool IQS7222::logTelemetry(Telemetry_encoder& encoder, const Sensor_snapshot& snapshot, bool stopOrRestart)
+{
+    Sensor_snapshot sample;
+    uint16_t values[TELEMETRY_NUM_VALUES];
+    uint8_t reports = 0;
+
+    if (!readMissingChannels(snapshot, IQS7222_CHANNEL_BITS, reports, 1, sample, stopOrRestart))
+        return false;
+
+    values[TELEMETRY_PROX_FLAGS] = snapshot.proxFlags;
+    values[TELEMETRY_TOUCH_FLAGS] = snapshot.touchFlags;
+    for (uint8_t i = 0; i < IQS7222_NUM_CHANNELS; i++)
+    {
+        values[TELEMETRY_COUNTS(i)] = sample.counts[i];
+        values[TELEMETRY_LTA(i)] = sample.lta[i];
+    }
+    return encoder.append(snapshot.readTick, values);
+}
+
+/**
+  * @name   loadProfile
+  * @brief  A method which validates a serialised profile and applies it to the device.
+  * @param  buffer        -> The array holding the serialised profile, e.g. read from flash, storage or received from a host.
+  *         length        -> The number of bytes in the buffer.
+  *         stopOrRestart -> A boolean which specifies whether the communication window should remain open or be closed after transfer.
+  *                           False keeps it open, true closes it. Use the STOP and RESTART definitions.
+  * @retval Returns true if the profile is valid and has been applied, returns false if the buffer was rejected.
+  * @notes  An invalid buffer leaves the device configuration untouched.
+  */
+bool IQS7222::loadProfile(const uint8_t buffer[], size_t length, bool stopOrRestart)
+{
+    IQS7222_profile profile;
+
+    if (!profileLoad(buffer, length, profile))
+        return false;
+
+    applyProfile(profile, stopOrRestart);
+    return true;
+}
+
+/**
+  * @name   diffProfile
+  * @brief  A method which compares a profile against the active configuration.
+  * @param  profile -> The profile to be compared.
+  * @retval 32bit mask where bit n is set if block n of profileBlocks[] would be written by applyProfile.
   * @notes  None.
-*/
-void IQS7222::clearTouch(void)
+  */
+uint32_t IQS7222::diffProfile(const IQS7222_profile& profile)
 {
-    for (auto& previous : previousTouch)
-        previous = CHANNELS::EMPTY;
-    previousTouchIndex = 0;
-    previousTouchRear = 0; 
+    if (!_profileValid)
+        return ((uint32_t)1 << PROFILE_NUM_BLOCKS) - 1;
+    return profileDiff(_profile, profile);
+}
+
+/**
+  * @name   getProfile
+  * @brief  A method which returns the register image of the active configuration.
+  * @param  None.
+  * @retval Reference to the active profile.
+  * @notes  The image is only meaningful once begin or applyProfile has been called.
+  */
+const IQS7222_profile& IQS7222::getProfile(void)
+{
+    return _profile;
 }
 
+#if defined(IQS7222_ENABLE_STATS)
+/**
+  * @name   getStats
+  * @brief  A method which copies the instrumentation counters and latency histograms.
+  * @param  stats -> The structure which will receive the snapshot, it is overwritten.
+  * @retval None.
+  * @notes  Only available when IQS7222_ENABLE_STATS is defined. The counters are only written by the driver,
+  *         call this method from the same context as the driver to get a consistent snapshot.
+  */
+void IQS7222::getStats(IQS7222_stats& stats)
+{
+    memcpy(&stats, &_stats, sizeof(IQS7222_stats));
+}
 
-void IQS7222::gestureUpdate(void)
+/**
+  * @name   resetStats
+  * @brief  A method which clears the instrumentation counters and latency histograms.
+  * @param  None.
+  * @retval None.
+  * @notes  Only available when IQS7222_ENABLE_STATS is defined.
+  */
+void IQS7222::resetStats(void)
+{
+    memset(&_stats, 0, sizeof(IQS7222_stats));
+}
+#endif
+
+#if defined(IQS7222_ENABLE_HEALTH)
+/**
+  * @name   beginHealthMonitor
+  * @brief  A method which clears the health statistics of every channel and starts a new measurement period.
+  * @param  None.
+  * @retval None.
+  * @notes  Only available when IQS7222_ENABLE_HEALTH is defined. Call again after an ATI, the LTA drift is measured
+  *         from the first sample of the period.
+  */
+void IQS7222::beginHealthMonitor(void)
 {
-    uint8_t transferBytes[12];
-    readRandomBytes(CH0_COUNTS, 12, transferBytes, RESTART);
-    
-    //trackpadGestures.updateCount(transferBytes);
+    healthReset(_health, millis());
 }
 
 /**
-  * @name   identifySwipe
-  * @brief  A method which adds the current touch channel to an array of previous events.
-  * @param  None.
+  * @name   updateHealth
+  * @brief  A method which adds a report to the health statistics of the channels of the layout.
+  * @param  snapshot      -> The report returned by updateStream, pollReport or serviceEvent.
+  *         stopOrRestart -> A boolean which specifies whether the communication window should remain open or be closed after transfer.
+  *                           False keeps it open, true closes it. Use the STOP and RESTART definitions.
   * @retval None.
-  * @notes  None.
+  * @notes  Only available when IQS7222_ENABLE_HEALTH is defined. Must be called inside the window of the report, as
+  *         monitorNoise. The channels read for the report are sampled every report, the other channels of the layout
+  *         are read every HEALTH_SAMPLE_REPORTS reports. The touches are counted from the flags of every report. Each
+  *         sample is a fixed number of operations, see healthSample. Call beginHealthMonitor first.
   */
-DIRECTION IQS7222::identifySwipe(void)
+void IQS7222::updateHealth(const Sensor_snapshot& snapshot, bool stopOrRestart)
 {
+    Sensor_snapshot sample;
+    uint16_t active = snapshot.touchFlags | snapshot.proxFlags;
+    uint16_t channels = layoutChannels() | IQS7222_KEEP_CHANNELS;
 
-    if (previousTouch[previousTouchIndex - 1] == CHANNELS::CH5)
+    readMissingChannels(snapshot, channels, _health.reports, HEALTH_SAMPLE_REPORTS, sample, stopOrRestart);
+
+    for (uint8_t i = 0; i < IQS7222_NUM_CHANNELS; i++)
     {
-        size_t indexFirst = (previousTouchIndex - 1);
-        while (indexFirst != previousTouchRear)
-        {
-            if (previousTouch[indexFirst] == CHANNELS::CH3)
-            {
-                size_t indexSecond = (indexFirst- 1);
-            }
-        }
+        if (channels & sample.countsMask & (0x01 << i))
+            healthSample(_health, i, channelDelta(sample, i), sample.lta[i], !(active & (0x01 << i)));
     }
+    healthTouches(_health, snapshot.touchFlags);
+    _health.lastTime = millis();
+}
 
+/**
+  * @name   getHealthSummary
+  * @brief  A method which returns the summary record of the health statistics of a channel.
+  * @param  channel -> Index of the channel.
+  *         summary -> The structure which will receive the summary, it is overwritten.
+  * @retval None.
+  * @notes  Only available when IQS7222_ENABLE_HEALTH is defined. The statistics keep running, call beginHealthMonitor
+  *         to start a new period once the summaries are sent.
+  */
+void IQS7222::getHealthSummary(uint8_t channel, Health_summary& summary)
+{
+    memset(&summary, 0, sizeof(summary));
+    if (channel < IQS7222_NUM_CHANNELS)
+        healthSummarise(_health, channel, summary);
+}
+#endif
 
+#if defined(IQS7222_ENABLE_TRACE)
+/**
+  * @name   readTrace
+  * @brief  A method which drains the oldest recorded spans from the trace ring buffer.
+  * @param  spans    -> The array which will store the spans, oldest first.
+  *         maxSpans -> The number of elements in the spans array.
+  * @retval Number of spans copied into the array.
+  * @notes  Only available when IQS7222_ENABLE_TRACE is defined. The spans can be written as raw bytes
+  *         to a stream and converted on the host with utils/trace_to_perfetto.py.
+  */
+uint8_t IQS7222::readTrace(Trace_span spans[], uint8_t maxSpans)
+{
+    uint8_t numSpans = 0;
 
-    //  Swipe UP left
-    if (previousTouch[previousTouchIndex - 1] == CHANNELS::CH5)
-    {
-        for (size_t i = (previousTouchIndex - 1); i >= 0; i-- )
-        {
-            if (previousTouch[i] == CHANNELS::CH3)
-            {
-                for (size_t j = (i - 1); j >= 0; j--)
-                    if (previousTouch[j] == CHANNELS::CH1)
-                        return DIRECTION::UP;
-            }
-        }
-    }
-    //  Swipe UP right
-    else if (previousTouch[previousTouchIndex - 1] == CHANNELS::CH6)
-    {
-        for (size_t i = (previousTouchIndex - 1); i >= 0; i--)
-        {
-            if (previousTouch[i] == CHANNELS::CH4)
-            {
-                for (size_t j = (i - 1); j >= 0; j--)
-                    if (previousTouch[j] == CHANNELS::CH2)
-                        return DIRECTION::UP;
-            }
-        }
-    }
-    // Swipe DOWN left
-    else if (previousTouch[previousTouchIndex - 1] == CHANNELS::CH1)
-    {
-        for (size_t i = (previousTouchIndex - 1); i >= 0; i--)
-        {
-            if (previousTouch[i] == CHANNELS::CH3)
-            {
-                for (size_t j = (i - 1); j >= 0; j--)
-                    if (previousTouch[j] == CHANNELS::CH5)
-                        return DIRECTION::DOWN;
-            }
-        }
-    }
-    //  Swipe DOWN right
-    else if (previousTouch[previousTouchIndex - 1] == CHANNELS::CH2)
+    while ((_traceCount > 0) && (numSpans < maxSpans))
     {
-        for (size_t i = (previousTouchIndex - 1); i >= 0; i--)
-        {
-            if (previousTouch[i] == CHANNELS::CH4)
-            {
-                for (size_t j = (i - 1); j >= 0; j--)
-                    if (previousTouch[j] == CHANNELS::CH6)
-                        return DIRECTION::DOWN;
-            }
-        }
+        uint16_t tail = (_traceHead + TRACE_DEPTH - _traceCount) % TRACE_DEPTH;
+        spans[numSpans++] = _trace[tail];
+        _traceCount--;
     }
+    return numSpans;
+}
 
+/**
+  * @name   getTraceDropped
+  * @brief  A method which returns the number of spans overwritten before they were drained.
+  * @param  None.
+  * @retval Number of spans lost since the last clearTrace.
+  * @notes  Only available when IQS7222_ENABLE_TRACE is defined.
+  */
+uint32_t IQS7222::getTraceDropped(void)
+{
+    return _traceDropped;
+}
 
+/**
+  * @name   clearTrace
+  * @brief  A method which discards every span in the trace ring buffer.
+  * @param  None.
+  * @retval None.
+  * @notes  Only available when IQS7222_ENABLE_TRACE is defined.
+  */
+void IQS7222::clearTrace(void)
+{
+    _traceHead = 0;
+    _traceCount = 0;
+    _traceDropped = 0;
 }
+#endif
 
 
 /**************************************************************************************************************/
@@ -631,48 +2380,81 @@ void IQS7222::toggleReady(void)
  *          bytesArray    -> The array which will store the bytes to be read, this array will be overwritten.
  *          stopOrRestart -> A boolean which specifies whether the communication window should remain open or be closed after transfer.
  *                           False keeps it open, true closes it. Use the STOP and RESTART definitions.
- * @retval  No value is returend, however, the user supplied array is overwritten.
- * @notes   Uses standard arduino "Wire" library which is for I2C communication.
+ * @retval  Returns true if the bytes were read, returns false if the device did not respond within TRANSPORT_READ_ATTEMPTS.
+ * @notes   The address and the read are sent as one combined transaction by the transport, see setTransport.
  *          Take note that C++ cannot return an array, therefore, the array which is passed as an argument is overwritten with the required values.
  *          Pass an array to the method by using only its name, e.g. "bytesArray", without the brackets, this basically passes a pointer to the array.
  */
-void IQS7222::readRandomBytes(uint16_t memoryAddress, uint8_t numBytes, uint8_t bytesArray[], bool stopOrRestart)
+bool IQS7222::readRandomBytes(uint16_t memoryAddress, uint8_t numBytes, uint8_t bytesArray[], bool stopOrRestart)
 {
-    uint8_t i = 0;  // A simple counter to assist with loading bytes into the user supplied array.
+    uint8_t addressBytes[2];
+    uint8_t addressLength = encodeAddress(memoryAddress, addressBytes);
+    bool success = false;
 
-    // Select the device with the address of "_deviceAddress" and start communication.
-    Wire.beginTransmission(_deviceAddress);
-    
-    // Verifies if 8bit or 16bit address
-    if (memoryAddress <= 0xFF)
+    IQS7222_COUNT(reads, 1);
+    IQS7222_PROBE_START(transactionStart);
+
+    // Send the address and read the bytes straight into the user supplied array, this sometimes takes a few attempts
+    for (uint8_t attempt = 0; (attempt < _readAttempts) && !success; attempt++)
     {
-        // Send a byte asking for the "memoryAddress" register 
-        Wire.write(memoryAddress);
+        if (attempt != 0)
+            IQS7222_COUNT(readRetries, 1);
+        success = _transport->writeRead(_deviceAddress, addressBytes, addressLength, bytesArray, numBytes, stopOrRestart);
+        // A single attempt poll is not acknowledged outside the communication window, this is not a bus error
+        trackBusErrors(success || (_readAttempts == 1));
     }
-    else
-    {
-        // Send two bytes asking for the "memoryAddress" register in little endian byte order
-        Wire.write((memoryAddress & 0xFF00) >> 8);
-        Wire.write(memoryAddress & 0xFF);
 
-    }
+    if (success)
+        IQS7222_COUNT(bytesRead, numBytes);
+    IQS7222_PROBE_STOP(PROBE_READ, transactionStart, memoryAddress, numBytes);
+    return success;
+}
 
-    // Complete the selection and communication initialization.
-    Wire.endTransmission(RESTART);  // Restart transmission for reading that follows.
+/**
+ * @name    readRandomBlocks
+ * @brief   A method which reads several register blocks in one transaction.
+ * @param   memoryAddresses -> The memory address of each block.
+ *          numBytes        -> The number of bytes of each block.
+ *          bytesArrays     -> The arrays which will store each block, they are overwritten.
+ *          numBlocks       -> The number of blocks, at most TRANSPORT_MAX_READS.
+ *          stopOrRestart   -> A boolean which specifies whether the communication window should remain open or be closed after transfer.
+ *                             False keeps it open, true closes it. Use the STOP and RESTART definitions.
+ * @retval  Returns true if every block was read, returns false if the device did not respond within TRANSPORT_READ_ATTEMPTS.
+ * @notes   The blocks are sent with IQS7222_transport::readMany, joined by repeated starts, so they are read in the same
+ *          communication window even when the transport ends every read with a STOP. A retry reads every block again.
+ */
+bool IQS7222::readRandomBlocks(const uint16_t memoryAddresses[], const uint8_t numBytes[], uint8_t* bytesArrays[],
+                               uint8_t numBlocks, bool stopOrRestart)
+{
+    uint8_t addressBytes[TRANSPORT_MAX_READS][2];
+    Transport_read reads[TRANSPORT_MAX_READS];
+    uint16_t totalBytes = 0;
+    bool success = false;
 
-    // Request "numBytes" bytes from the device which has address "_deviceAddress"
-    do
+    IQS7222_COUNT(reads, 1);
+    IQS7222_PROBE_START(transactionStart);
+
+    for (uint8_t i = 0; i < numBlocks; i++)
     {
-        Wire.requestFrom(_deviceAddress, numBytes, stopOrRestart);
-    } while (Wire.available() == 0);  // Wait for response, this sometimes takes a few attempts
+        reads[i].tx = addressBytes[i];
+        reads[i].txLength = encodeAddress(memoryAddresses[i], addressBytes[i]);
+        reads[i].rx = bytesArrays[i];
+        reads[i].rxLength = numBytes[i];
+        totalBytes += numBytes[i];
+    }
 
-    // Load the received bytes into the array until there are no more 
-    while (Wire.available())
+    for (uint8_t attempt = 0; (attempt < _readAttempts) && !success; attempt++)
     {
-        // Load the received bytes into the user supplied array
-        bytesArray[i] = Wire.read();
-        i++;
+        if (attempt != 0)
+            IQS7222_COUNT(readRetries, 1);
+        success = _transport->readMany(_deviceAddress, reads, numBlocks, stopOrRestart);
+        trackBusErrors(success || (_readAttempts == 1));
     }
+
+    if (success)
+        IQS7222_COUNT(bytesRead, totalBytes);
+    IQS7222_PROBE_STOP(PROBE_READ, transactionStart, memoryAddresses[0], totalBytes);
+    return success;
 }
 
 /**
@@ -684,38 +2466,158 @@ void IQS7222::readRandomBytes(uint16_t memoryAddress, uint8_t numBytes, uint8_t
   *         bytesArray    -> The array which stores the bytes which will be written to the memory location.
   *         stopOrRestart -> A boolean which sepcifies whether the communication window should remain open or be closed of transfer.
   *                          False keeps it open, true closes it. Use the STOP and RESTART definitions.
-  * @retval No value is returend, only the IQS device registers are altered.
-  * @notes  Uses standard arduino "Wire" library which is for I2C communication.
-  *         Take note that a full array cannot be passed to a function in C++.
-  *         Pass an array to the function by using only its name, e.g. "bytesArray", without the square brackets, this basically passes a pointer to the array.
-  *         The values to be written must be loaded into the array prior to passing it to the function.
+  * @retval Returns true if the device acknowledged the write, returns false if not.
+  * @notes  The values to be written must be loaded into the array prior to passing it to the function.
+  *         The written bytes are mirrored into the active profile even if the write fails, so recoverReset restores them.
+  */
+bool IQS7222::writeRandomBytes(uint16_t memoryAddress, uint8_t numBytes, uint8_t bytesArray[], bool stopOrRestart)
+{
+    uint8_t addressBytes[2];
+    uint8_t addressLength = encodeAddress(memoryAddress, addressBytes);
+
+    IQS7222_COUNT(writes, 1);
+    IQS7222_COUNT(bytesWritten, numBytes);
+    IQS7222_PROBE_START(transactionStart);
+
+    bool success = _transport->write(_deviceAddress, addressBytes, addressLength, bytesArray, numBytes, stopOrRestart);
+    trackBusErrors(success);
+    mirrorProfile(memoryAddress, numBytes, bytesArray);
+    IQS7222_PROBE_STOP(PROBE_WRITE, transactionStart, memoryAddress, numBytes);
+    return success;
+}
+
+/**
+  * @name   encodeAddress
+  * @brief  A method which encodes a register address as sent on the bus.
+  * @param  memoryAddress -> The register address.
+  *         addressBytes  -> Array of 2 bytes which receives the encoded address.
+  * @retval Number of address bytes, 1 for the 8bit addresses up to 0xFF and 2 for the 16bit addresses.
+  * @notes  16bit addresses are sent in big endian byte order, high byte first.
   */
-void IQS7222::writeRandomBytes(uint16_t memoryAddress, uint8_t numBytes, uint8_t bytesArray[], bool stopOrRestart)
+uint8_t IQS7222::encodeAddress(uint16_t memoryAddress, uint8_t addressBytes[])
 {
-    // Select the device with the address of "_deviceAddress" and start communication.
-    Wire.beginTransmission(_deviceAddress);
-    // Verifies if 8bit or 16bit address
     if (memoryAddress <= 0xFF)
     {
-        // Send a byte asking for the "memoryAddress" register 
-        Wire.write(memoryAddress);
+        addressBytes[0] = memoryAddress;
+        return 1;
     }
-    else
+    addressBytes[0] = (memoryAddress & 0xFF00) >> 8;
+    addressBytes[1] = memoryAddress & 0xFF;
+    return 2;
+}
+
+/**
+  * @name   setClockIndex
+  * @brief  A method which sets one of the bus clocks probed by probeClock.
+  * @param  index -> Index of the clock, 0 for BUS_CLOCK_STANDARD.
+  * @retval Returns true if the transport supports the clock, returns false if not.
+  * @notes  The clock in use is unchanged when the transport refuses the new one.
+  */
+bool IQS7222::setClockIndex(uint8_t index)
+{
+    if (!_transport->setClock(busClocks[index]))
+        return false;
+    _clockIndex = index;
+    return true;
+}
+
+/**
+  * @name   verifyBlock
+  * @brief  A method which reads back a register block and checks it.
+  * @param  blockIndex -> Index of the block in profileBlocks[].
+  *         stopOrRestart -> A boolean which specifies whether the communication window should remain open or be closed after transfer.
+  *                           False keeps it open, true closes it. Use the STOP and RESTART definitions.
+  * @retval Returns true if the block was read and matches, returns false if not.
+  * @notes  The block is compared with the active profile, or read twice and compared with itself when no profile is loaded.
+  */
+bool IQS7222::verifyBlock(uint8_t blockIndex, bool stopOrRestart)
+{
+    const Profile_block& block = profileBlocks[blockIndex];
+    uint8_t first[PROFILE_SLIDER_SIZE];
+    uint8_t second[PROFILE_SLIDER_SIZE];
+
+    if (!_profileValid)
     {
-        // Send two bytes asking for the "memoryAddress" register in little endian byte order.
-        Wire.write((memoryAddress & 0xFF00) >> 8);
-        Wire.write(memoryAddress & 0xFF);
+        return readRandomBytes(block.address, block.length, first, RESTART)
+            && readRandomBytes(block.address, block.length, second, stopOrRestart)
+            && (memcmp(first, second, block.length) == 0);
     }
+    return readRandomBytes(block.address, block.length, first, stopOrRestart)
+        && (memcmp(first, &_profile.image[block.offset], block.length) == 0);
+}
+
+/**
+  * @name   trackBusErrors
+  * @brief  A method which counts failed transactions and lowers the bus clock when they accumulate.
+  * @param  success -> Result of the transaction.
+  * @retval None.
+  * @notes  BUS_ERROR_LIMIT failures within BUS_ERROR_WINDOW transactions lower the clock by one step.
+  */
+void IQS7222::trackBusErrors(bool success)
+{
+    _busTransactions++;
+    if (!success)
+        _busErrors++;
 
-    // Write the bytes as specified in the array which "arrayAddress" pointer points to.
-    for (int i = 0; i < numBytes; i++)
+    if ((_busErrors >= BUS_ERROR_LIMIT) && (_clockIndex > 0))
+    {
+        setClockIndex(_clockIndex - 1);
+        IQS7222_LOG("Bus errors, clock lowered to %lu Hz", (unsigned long)busClocks[_clockIndex]);
+        _busTransactions = 0;
+        _busErrors = 0;
+    }
+    else if (_busTransactions >= BUS_ERROR_WINDOW)
     {
-        Wire.write(bytesArray[i]);
+        _busTransactions = 0;
+        _busErrors = 0;
     }
-    // End the transmission, user decides to STOP or RESTART.
-    Wire.endTransmission(stopOrRestart);
 }
 
+/**
+  * @name   endWindow
+  * @brief  A method which closes the current communication window without transferring any register.
+  * @param  None.
+  * @retval None.
+  * @notes  Only the device address is sent followed by a STOP condition.
+  */
+void IQS7222::endWindow(void)
+{
+    _transport->write(_deviceAddress, NULL, 0, NULL, 0, STOP);
+}
+
+/**
+  * @name   startAsync
+  * @brief  A method which starts a cooperative operation with a communication request.
+  * @param  op -> The operation to start.
+  * @retval Returns true if the operation was started, returns false if another operation is in progress.
+  * @notes  None.
+  */
+bool IQS7222::startAsync(ASYNC_OP op)
+{
+    if (_asyncOp != ASYNC_NONE)
+        return false;
+
+    IQS7222_COUNT(rdyRequests, 1);
+    _asyncOp = op;
+    _asyncStep = ASYNC_RDY_PULL;
+    _asyncIndex = 0;
+    return true;
+}
+
+/**
+  * @name   finishAsync
+  * @brief  A method which ends the cooperative operation in progress.
+  * @param  status -> The final status of the operation.
+  * @retval The status passed in, returned by tick.
+  * @notes  None.
+  */
+STEP_STATUS IQS7222::finishAsync(STEP_STATUS status)
+{
+    _asyncOp = ASYNC_NONE;
+    _asyncStep = ASYNC_RDY_PULL;
+    _asyncIndex = 0;
+    return status;
+}
 
 /**
  * @name    initialSetup
@@ -723,86 +2625,360 @@ void IQS7222::writeRandomBytes(uint16_t memoryAddress, uint8_t numBytes, uint8_t
  * @param   stopOrRestart -> A boolean which specifies whether the communication window should remain open or be closed after transfer.
  *                           False keeps it open, true closes it. Use the STOP and RESTART definitions.
  * @retval  None.
- * @notes   None.
+ * @notes   Without an initialisation header (IQS7222_RUNTIME_PROFILE) nothing is written, apply a profile with loadProfile.
  */
 void IQS7222::initialSetup(bool stopOrRestart)
 {
-    uint8_t transferByte0[6] = { CYCLE_0_CONV_FREQ_FRAC, CYCLE_0_CONV_FREQ_PERIOD, CYCLE_0_SETTINGS, CYCLE_0_CTX_SELECT, CYCLE_0_IREF_0, CYCLE_0_IREF_1 };
-    writeRandomBytes(CYCLE0_SETUP, 6, transferByte0, RESTART);
-    uint8_t transferByte1[6] = { CYCLE_1_CONV_FREQ_FRAC, CYCLE_1_CONV_FREQ_PERIOD, CYCLE_1_SETTINGS, CYCLE_1_CTX_SELECT, CYCLE_1_IREF_0, CYCLE_1_IREF_1 };
-    writeRandomBytes(CYCLE1_SETUP, 6, transferByte1, RESTART);
-    uint8_t transferByte2[6] = { CYCLE_2_CONV_FREQ_FRAC, CYCLE_2_CONV_FREQ_PERIOD, CYCLE_2_SETTINGS, CYCLE_2_CTX_SELECT, CYCLE_2_IREF_0, CYCLE_2_IREF_1 };
-    writeRandomBytes(CYCLE2_SETUP, 6, transferByte2, RESTART);
-    uint8_t transferByte3[6] = { CYCLE_3_CONV_FREQ_FRAC, CYCLE_3_CONV_FREQ_PERIOD, CYCLE_3_SETTINGS, CYCLE_3_CTX_SELECT, CYCLE_3_IREF_0, CYCLE_3_IREF_1 };
-    writeRandomBytes(CYCLE3_SETUP, 6, transferByte3, RESTART);
-    uint8_t transferByte4[6] = { CYCLE_4_CONV_FREQ_FRAC, CYCLE_4_CONV_FREQ_PERIOD, CYCLE_4_SETTINGS, CYCLE_4_CTX_SELECT, CYCLE_4_IREF_0, CYCLE_4_IREF_1 };
-    writeRandomBytes(CYCLE4_SETUP, 6, transferByte4, RESTART);
-
-    uint8_t transferByte5[6] = { GLOBAL_CYCLE_SETUP_0,GLOBAL_CYCLE_SETUP_1, COARSE_DIVIDER_PRELOAD, FINE_DIVIDER_PRELOAD, COMPENSATION_PRELOAD_0, COMPENSATION_PRELOAD_1 };
-    writeRandomBytes(GLOBAL_CYCLE_SETUP, 6, transferByte5, RESTART);
-    
-    uint8_t transferByte26[6] = { BUTTON_0_PROX_THRESHOLD, BUTTON_0_ENTER_EXIT, BUTTON_0_TOUCH_THRESHOLD, BUTTON_0_TOUCH_HYSTERESIS, BUTTON_0_PROX_EVENT_TIMEOUT, BUTTON_0_TOUCH_EVENT_TIMEOUT };
-    writeRandomBytes(BUTTON0_SETUP, 6, transferByte26, RESTART);
-    uint8_t transferByte27[6] = { BUTTON_1_PROX_THRESHOLD, BUTTON_1_ENTER_EXIT, BUTTON_5_TOUCH_THRESHOLD, BUTTON_5_TOUCH_HYSTERESIS, BUTTON_5_PROX_EVENT_TIMEOUT, BUTTON_5_TOUCH_EVENT_TIMEOUT };
-    writeRandomBytes(BUTTON1_SETUP, 6, transferByte27, RESTART);
-    uint8_t transferByte28[6] = { BUTTON_2_PROX_THRESHOLD, BUTTON_2_ENTER_EXIT, BUTTON_5_TOUCH_THRESHOLD, BUTTON_5_TOUCH_HYSTERESIS, BUTTON_5_PROX_EVENT_TIMEOUT, BUTTON_5_TOUCH_EVENT_TIMEOUT };
-    writeRandomBytes(BUTTON2_SETUP, 6, transferByte28, RESTART);
-    uint8_t transferByte29[6] = { BUTTON_3_PROX_THRESHOLD, BUTTON_3_ENTER_EXIT, BUTTON_5_TOUCH_THRESHOLD, BUTTON_5_TOUCH_HYSTERESIS, BUTTON_5_PROX_EVENT_TIMEOUT, BUTTON_5_TOUCH_EVENT_TIMEOUT };
-    writeRandomBytes(BUTTON3_SETUP, 6, transferByte29,RESTART);
-    uint8_t transferByte30[6] = { BUTTON_4_PROX_THRESHOLD, BUTTON_4_ENTER_EXIT, BUTTON_5_TOUCH_THRESHOLD, BUTTON_5_TOUCH_HYSTERESIS, BUTTON_5_PROX_EVENT_TIMEOUT, BUTTON_5_TOUCH_EVENT_TIMEOUT };
-    writeRandomBytes(BUTTON4_SETUP, 6, transferByte30, RESTART);
-    uint8_t transferByte6[6] = { BUTTON_5_PROX_THRESHOLD, BUTTON_5_ENTER_EXIT, BUTTON_5_TOUCH_THRESHOLD, BUTTON_5_TOUCH_HYSTERESIS, BUTTON_5_PROX_EVENT_TIMEOUT, BUTTON_5_TOUCH_EVENT_TIMEOUT };
-    writeRandomBytes(BUTTON5_SETUP, 6, transferByte6, RESTART);
-    uint8_t transferByte7[6] = { BUTTON_6_PROX_THRESHOLD, BUTTON_6_ENTER_EXIT, BUTTON_6_TOUCH_THRESHOLD, BUTTON_6_TOUCH_HYSTERESIS, BUTTON_6_PROX_EVENT_TIMEOUT, BUTTON_6_TOUCH_EVENT_TIMEOUT};
-    writeRandomBytes(BUTTON6_SETUP, 6, transferByte7, RESTART);
-    uint8_t transferByte8[6] = { BUTTON_7_PROX_THRESHOLD, BUTTON_7_ENTER_EXIT, BUTTON_7_TOUCH_THRESHOLD, BUTTON_7_TOUCH_HYSTERESIS, BUTTON_7_PROX_EVENT_TIMEOUT, BUTTON_7_TOUCH_EVENT_TIMEOUT };
-    writeRandomBytes(BUTTON7_SETUP, 6, transferByte8, RESTART);
-    uint8_t transferByte9[6] = { BUTTON_8_PROX_THRESHOLD, BUTTON_8_ENTER_EXIT, BUTTON_8_TOUCH_THRESHOLD, BUTTON_8_TOUCH_HYSTERESIS, BUTTON_8_PROX_EVENT_TIMEOUT, BUTTON_8_TOUCH_EVENT_TIMEOUT };
-    writeRandomBytes(BUTTON8_SETUP, 6, transferByte9, RESTART);
-    uint8_t transferByte10[6] = { BUTTON_9_PROX_THRESHOLD, BUTTON_9_ENTER_EXIT, BUTTON_9_TOUCH_THRESHOLD, BUTTON_9_TOUCH_HYSTERESIS, BUTTON_9_PROX_EVENT_TIMEOUT, BUTTON_9_TOUCH_EVENT_TIMEOUT };
-    writeRandomBytes(BUTTON9_SETUP, 6, transferByte10, RESTART);
-
-    uint8_t transferByte11[12] = { CH0_SETUP_0, CH0_SETUP_1, CH0_ATI_SETTINGS_0, CH0_ATI_SETTINGS_1, CH0_MULTIPLIERS_0, CH0_MULTIPLIERS_1, CH0_ATI_COMPENSATION_0, CH0_ATI_COMPENSATION_1, CH0_REF_PTR_0, CH0_REF_PTR_1, CH0_REFMASK_0, CH0_REFMASK_1};
-    writeRandomBytes(CH0_GENERAL, 12, transferByte11, RESTART);
-    uint8_t transferByte12[12] = { CH1_SETUP_0, CH1_SETUP_1, CH1_ATI_SETTINGS_0, CH1_ATI_SETTINGS_1, CH1_MULTIPLIERS_0, CH1_MULTIPLIERS_1, CH1_ATI_COMPENSATION_0, CH1_ATI_COMPENSATION_1, CH1_REF_PTR_0, CH1_REF_PTR_1, CH1_REFMASK_0, CH1_REFMASK_1 };
-    writeRandomBytes(CH1_GENERAL, 12, transferByte12, RESTART);
-    uint8_t transferByte13[12] = { CH2_SETUP_0, CH2_SETUP_1, CH2_ATI_SETTINGS_0, CH2_ATI_SETTINGS_1, CH2_MULTIPLIERS_0, CH2_MULTIPLIERS_1, CH2_ATI_COMPENSATION_0, CH2_ATI_COMPENSATION_1, CH2_REF_PTR_0, CH2_REF_PTR_1, CH2_REFMASK_0, CH2_REFMASK_1 };
-    writeRandomBytes(CH2_GENERAL, 12, transferByte13, RESTART);
-    uint8_t transferByte14[12] = { CH3_SETUP_0, CH3_SETUP_1, CH3_ATI_SETTINGS_0, CH3_ATI_SETTINGS_1, CH3_MULTIPLIERS_0, CH3_MULTIPLIERS_1, CH3_ATI_COMPENSATION_0, CH3_ATI_COMPENSATION_1, CH3_REF_PTR_0, CH3_REF_PTR_1, CH3_REFMASK_0, CH3_REFMASK_1 };
-    writeRandomBytes(CH3_GENERAL, 12, transferByte14, RESTART);
-    uint8_t transferByte15[12] = { CH4_SETUP_0, CH4_SETUP_1, CH4_ATI_SETTINGS_0, CH4_ATI_SETTINGS_1, CH4_MULTIPLIERS_0, CH4_MULTIPLIERS_1, CH4_ATI_COMPENSATION_0, CH4_ATI_COMPENSATION_1, CH4_REF_PTR_0, CH4_REF_PTR_1, CH4_REFMASK_0, CH4_REFMASK_1 };
-    writeRandomBytes(CH4_GENERAL, 12, transferByte15, RESTART);
-    uint8_t transferByte16[12] = { CH5_SETUP_0, CH5_SETUP_1, CH5_ATI_SETTINGS_0, CH5_ATI_SETTINGS_1, CH5_MULTIPLIERS_0, CH5_MULTIPLIERS_1, CH5_ATI_COMPENSATION_0, CH5_ATI_COMPENSATION_1, CH5_REF_PTR_0, CH5_REF_PTR_1, CH5_REFMASK_0, CH5_REFMASK_1 };
-    writeRandomBytes(CH5_GENERAL, 12, transferByte16, RESTART);
-    uint8_t transferByte17[12] = { CH6_SETUP_0, CH6_SETUP_1, CH6_ATI_SETTINGS_0, CH6_ATI_SETTINGS_1, CH6_MULTIPLIERS_0, CH6_MULTIPLIERS_1, CH6_ATI_COMPENSATION_0, CH6_ATI_COMPENSATION_1, CH6_REF_PTR_0, CH6_REF_PTR_1, CH6_REFMASK_0, CH6_REFMASK_1 };
-    writeRandomBytes(CH6_GENERAL, 12, transferByte17, RESTART);
-    uint8_t transferByte18[12] = { CH7_SETUP_0, CH7_SETUP_1, CH7_ATI_SETTINGS_0, CH7_ATI_SETTINGS_1, CH7_MULTIPLIERS_0, CH7_MULTIPLIERS_1, CH7_ATI_COMPENSATION_0, CH7_ATI_COMPENSATION_1, CH7_REF_PTR_0, CH7_REF_PTR_1, CH7_REFMASK_0, CH7_REFMASK_1 };
-    writeRandomBytes(CH7_GENERAL, 12, transferByte18, RESTART);
-    uint8_t transferByte19[12] = { CH8_SETUP_0, CH8_SETUP_1, CH8_ATI_SETTINGS_0, CH8_ATI_SETTINGS_1, CH8_MULTIPLIERS_0, CH8_MULTIPLIERS_1, CH8_ATI_COMPENSATION_0, CH8_ATI_COMPENSATION_1, CH8_REF_PTR_0, CH8_REF_PTR_1, CH8_REFMASK_0, CH8_REFMASK_1 };
-    writeRandomBytes(CH8_GENERAL, 12, transferByte19, RESTART);
-    uint8_t transferByte20[12] = { CH9_SETUP_0, CH9_SETUP_1, CH9_ATI_SETTINGS_0, CH9_ATI_SETTINGS_1, CH9_MULTIPLIERS_0, CH9_MULTIPLIERS_1, CH9_ATI_COMPENSATION_0, CH9_ATI_COMPENSATION_1, CH9_REF_PTR_0, CH9_REF_PTR_1, CH9_REFMASK_0, CH9_REFMASK_1 };
-    writeRandomBytes(CH9_GENERAL, 12, transferByte20, RESTART);
-    
-    uint8_t transferByte21[4] = { COUNTS_BETA_FILTER, LTA_BETA_FILTER, LTA_FAST_BETA_FILTER, RESERVED_FILTER_0 };
-    writeRandomBytes(FILTER_BETA, 4, transferByte21, RESTART);
-    
-    uint8_t transferByte22[20] = { SLIDER0SETUP_GENERAL, SLIDER0_LOWER_CAL, SLIDER0_UPPER_CAL, SLIDER0_BOTTOM_SPEED, SLIDER0_TOPSPEED_0, SLIDER0_TOPSPEED_1, SLIDER0_RESOLUTION_0, SLIDER0_RESOLUTION_1, SLIDER0_ENABLE_MASK_0_7, SLIDER0_ENABLE_MASK_8_9, SLIDER0_ENABLESTATUSLINK_0, SLIDER0_ENABLESTATUSLINK_1, SLIDER0_DELTA0_0, SLIDER0_DELTA0_1, SLIDER0_DELTA1_0, SLIDER0_DELTA1_1, SLIDER0_DELTA2_0, SLIDER0_DELTA2_1, SLIDER0_DELTA3_0, SLIDER0_DELTA3_1};
-    writeRandomBytes(SLIDER0_GENERAL, 20, transferByte22, RESTART);
-    uint8_t transferByte23[20] = { SLIDER1SETUP_GENERAL, SLIDER1_LOWER_CAL, SLIDER1_UPPER_CAL, SLIDER1_BOTTOM_SPEED, SLIDER1_TOPSPEED_0, SLIDER1_TOPSPEED_1, SLIDER1_RESOLUTION_0, SLIDER1_RESOLUTION_1, SLIDER1_ENABLE_MASK_0_7, SLIDER1_ENABLE_MASK_8_9, SLIDER1_ENABLESTATUSLINK_0, SLIDER1_ENABLESTATUSLINK_1, SLIDER1_DELTA0_0, SLIDER1_DELTA0_1, SLIDER1_DELTA1_0, SLIDER1_DELTA1_1, SLIDER1_DELTA2_0, SLIDER1_DELTA2_1, SLIDER1_DELTA3_0, SLIDER1_DELTA3_1 };
-    writeRandomBytes(SLIDER1_GENERAL, 20, transferByte23, RESTART);
+#if defined(IQS7222_HAS_DEFAULT_PROFILE)
+    IQS7222_PROBE_START(setupStart);
+    profileDefault(_profile);
+    disableCycles(_profile, ~layoutCycles);
+    _profileValid = true;
+
+    for (uint8_t i = 0; i < (PROFILE_NUM_BLOCKS - 1); i++)
+        writeProfileBlock(i, 0, profileBlocks[i].length, RESTART);
+    writeProfileBlock(PROFILE_NUM_BLOCKS - 1, 0, profileBlocks[PROFILE_NUM_BLOCKS - 1].length, stopOrRestart);
+    IQS7222_PROBE_STOP(PROBE_SETUP, setupStart, 0, PROFILE_NUM_BLOCKS);
+#else
+    IQS7222_LOG("No initialisation header, apply a profile with loadProfile");
+    if (stopOrRestart == STOP)
+        endWindow();
+#endif
+}
+
+/**
+ * @name    disableCycles
+ * @brief   A method which disables conversion cycles in a register image.
+ * @param   profile   -> The register image to change.
+ *          cycleMask -> Mask of the cycles to disable, bit n for cycle n.
+ * @retval  None.
+ * @notes   The cycle settings and CTx selection are cleared, which is how the configuration tool exports an unused cycle.
+ */
+void IQS7222::disableCycles(IQS7222_profile& profile, uint8_t cycleMask)
+{
+    for (uint8_t cycle = 0; cycle < IQS7222_NUM_CYCLES; cycle++)
+    {
+        if (!(cycleMask & (0x01 << cycle)))
+            continue;
+        profile.image[PROFILE_CYCLE_OFFSET + cycle * PROFILE_CYCLE_SIZE + PROFILE_CYCLE_SETTINGS] = 0;
+        profile.image[PROFILE_CYCLE_OFFSET + cycle * PROFILE_CYCLE_SIZE + PROFILE_CYCLE_CTX_SELECT] = 0;
+    }
+}
+
+/**
+ * @name    writeProfileBlock
+ * @brief   A method which writes part of a register block of the active profile to the device in a single burst.
+ * @param   blockIndex    -> Index of the block in profileBlocks[].
+ *          start         -> Offset of the first byte to write within the block, must be even (word aligned).
+ *          end           -> Offset one past the last byte to write within the block.
+ *          stopOrRestart -> A boolean which specifies whether the communication window should remain open or be closed after transfer.
+ *                           False keeps it open, true closes it. Use the STOP and RESTART definitions.
+ * @retval  None.
+ * @notes   Device registers are 16bit words, the word address is incremented by one for every two bytes of the block.
+ */
+void IQS7222::writeProfileBlock(uint8_t blockIndex, uint8_t start, uint8_t end, bool stopOrRestart)
+{
+    const Profile_block& block = profileBlocks[blockIndex];
+    writeRandomBytes(block.address + (start >> 1), end - start, &_profile.image[block.offset + start], stopOrRestart);
+}
+
+/**
+ * @name    readChannelData
+ * @brief   A method which reads the counts and LTA of a set of channels.
+ * @param   channelMask   -> Mask of the channels to read, bit n for channel n.
+ *          snapshot      -> The structure which will receive the counts and LTA.
+ *          stopOrRestart -> A boolean which specifies whether the communication window should remain open or be closed after transfer.
+ *                           False keeps it open, true closes it. Use the STOP and RESTART definitions.
+ * @retval  Returns true if the counts and LTA were read, returns false if the device did not respond.
+ * @notes   The counts and the LTA are each read with one burst spanning the lowest to the highest requested channel,
+ *          every channel in that span is marked as read in snapshot.countsMask. If a read fails no channel is marked and
+ *          the counts and LTA of the snapshot are left untouched.
+ */
+bool IQS7222::readChannelData(uint16_t channelMask, Sensor_snapshot& snapshot, bool stopOrRestart)
+{
+    uint8_t countBytes[2 * IQS7222_NUM_CHANNELS];
+    uint8_t ltaBytes[2 * IQS7222_NUM_CHANNELS];
+    uint8_t first = 0;
+    uint8_t last = IQS7222_NUM_CHANNELS - 1;
+
+    while (!(channelMask & (0x01 << first)))
+        first++;
+    while (!(channelMask & (0x01 << last)))
+        last--;
+
+    uint8_t numChannels = last - first + 1;
+
+    snapshot.countsMask = 0;
+    if (!readRandomBytes(CH0_COUNTS + first, numChannels * 2, countBytes, RESTART)
+        || !readRandomBytes(CH0_LTA + first, numChannels * 2, ltaBytes, stopOrRestart))
+        return false;
+
+    for (uint8_t i = 0; i < numChannels; i++)
+    {
+        snapshot.counts[first + i] = (countBytes[2 * i + 1] << 8) + countBytes[2 * i];
+        snapshot.lta[first + i] = (ltaBytes[2 * i + 1] << 8) + ltaBytes[2 * i];
+    }
+
+    snapshot.countsMask = ((1 << numChannels) - 1) << first;
+    return true;
+}
+
+/**
+ * @name    readMissingChannels
+ * @brief   A method which completes a report with the channels it did not read, every given number of reports.
+ * @param   snapshot      -> The report returned by updateStream, pollReport or serviceEvent.
+ *          channels      -> Mask of the channels wanted, bit n for channel n.
+ *          reports       -> Reports since the channels were last read, counted and cleared by this method.
+ *          period        -> Reports between two reads, 1 to read them on every report.
+ *          sample        -> Receives the report, completed with the channels read.
+ *          stopOrRestart -> A boolean which specifies whether the communication window should remain open or be closed after transfer.
+ *                           False keeps it open, true closes it. Use the STOP and RESTART definitions.
+ * @retval  Returns false if the missing channels could not be read, sample then holds the channels of the report only.
+ * @notes   Shared by monitorNoise, logTelemetry and updateHealth. Must be called inside the window of the report.
+ */
+bool IQS7222::readMissingChannels(const Sensor_snapshot& snapshot, uint16_t channels, uint8_t& reports, uint8_t period,
+                                  Sensor_snapshot& sample, bool stopOrRestart)
+{
+    bool success = true;
+
+    sample = snapshot;
+    if ((++reports >= period) && (channels & ~snapshot.countsMask))
+    {
+        success = readChannelData(channels & ~snapshot.countsMask, sample, stopOrRestart);
+        sample.countsMask = success ? (sample.countsMask | snapshot.countsMask) : snapshot.countsMask;
+        reports = 0;
+    }
+    else if (stopOrRestart == STOP)
+    {
+        endWindow();
+    }
+    return success;
+}
+
+/**
+ * @name    readStreamReport
+ * @brief   A method which reads the flags and slider outputs of a stream report, and the counts and LTA of every channel
+ *          when the transport cannot keep the window open between reads.
+ * @param   transferBytes -> The array which will store the STREAM_REPORT_SIZE bytes read from SYS_FLAGS.
+ *          snapshot      -> The structure which will receive the counts and LTA, marked in snapshot.countsMask.
+ *          stopOrRestart -> A boolean which specifies whether the communication window should remain open or be closed after transfer.
+ *                           False keeps it open, true closes it. Use the STOP and RESTART definitions.
+ * @retval  Returns true if the report was read, returns false if the device did not respond.
+ * @notes   Shared by updateStream and pollReport. When the transport keeps the window (keepsWindow) only the flags are
+ *          read, with RESTART, and decodeStream reads the channels around the touch in the same window. Otherwise the
+ *          flags, counts and LTA are read as one readMany transaction, as the window closes after every read.
+ */
+bool IQS7222::readStreamReport(uint8_t transferBytes[], Sensor_snapshot& snapshot, bool stopOrRestart)
+{
+    uint8_t countBytes[2 * IQS7222_NUM_CHANNELS];
+    uint8_t ltaBytes[2 * IQS7222_NUM_CHANNELS];
+    const uint16_t addresses[3] = { SYS_FLAGS, CH0_COUNTS, CH0_LTA };
+    const uint8_t lengths[3] = { STREAM_REPORT_SIZE, sizeof(countBytes), sizeof(ltaBytes) };
+    uint8_t* arrays[3] = { transferBytes, countBytes, ltaBytes };
+
+    snapshot.countsMask = 0;
+    if (_transport->keepsWindow())
+        return readRandomBytes(SYS_FLAGS, STREAM_REPORT_SIZE, transferBytes, RESTART);
+
+    if (!readRandomBlocks(addresses, lengths, arrays, 3, stopOrRestart))
+        return false;
+    for (uint8_t i = 0; i < IQS7222_NUM_CHANNELS; i++)
+    {
+        snapshot.counts[i] = (countBytes[2 * i + 1] << 8) + countBytes[2 * i];
+        snapshot.lta[i] = (ltaBytes[2 * i + 1] << 8) + ltaBytes[2 * i];
+    }
+    snapshot.countsMask = IQS7222_CHANNEL_BITS;
+    return true;
+}
+
+/**
+ * @name    decodeStream
+ * @brief   A method which decodes the flags of a stream report and reads the channels around the touch.
+ * @param   transferBytes -> The STREAM_REPORT_SIZE bytes read from SYS_FLAGS.
+ *          snapshot      -> The structure which will receive the decoded flags, counts and LTA.
+ *          stopOrRestart -> A boolean which specifies whether the communication window should remain open or be closed after transfer.
+ *                           False keeps it open, true closes it. Use the STOP and RESTART definitions.
+ * @retval  Returns true if the report was decoded, returns false if the counts and LTA could not be read.
+ * @notes   Shared by updateStream and pollReport. The channels already in snapshot.countsMask, read with the flags by
+ *          readStreamReport, are not read again. The decoded report is published to readState, a report whose counts
+ *          could not be read is not published.
+ */
+bool IQS7222::decodeStream(const uint8_t transferBytes[], Sensor_snapshot& snapshot, bool stopOrRestart)
+{
+    uint16_t channelMask;
+
+    IQS7222_PROBE_START(decodeStart);
+    snapshot.systemFlags = (transferBytes[1] << 8) + transferBytes[0];
+    snapshot.eventFlags = (transferBytes[3] << 8) + transferBytes[2];
+    snapshot.proxFlags = (transferBytes[5] << 8) + transferBytes[4];
+    snapshot.touchFlags = (transferBytes[7] << 8) + transferBytes[6];
+    snapshot.slider[0] = (transferBytes[9] << 8) + transferBytes[8];
+    snapshot.slider[1] = (transferBytes[11] << 8) + transferBytes[10];
+
+    if (snapshot.systemFlags & SHOW_RESET_BIT)
+    {
+        recoverReset(stopOrRestart);
+        snapshot.proxFlags = 0;
+        snapshot.touchFlags = 0;
+        snapshot.countsMask = 0;
+        snapshot.readTick = micros();
+        publishState(snapshot, true);
+        return true;
+    }
+    touch.flagByte = snapshot.touchFlags;
+    for (uint8_t i = 0; i < IQS7222_NUM_CHANNELS; i++)
+        event_channel[i] = (snapshot.touchFlags >> i) & 0x01;
+
+    // Touched channels of this and the previous report, the latter captures the release
+    channelMask = (snapshot.touchFlags | _streamTouch) & IQS7222_CHANNEL_BITS;
+    for (uint8_t i = 0; i < IQS7222_NUM_CHANNELS; i++)
+    {
+        if ((snapshot.touchFlags | _streamTouch) & (0x01 << i))
+            channelMask |= layoutNeighbourTable[i];
+    }
+    _streamTouch = snapshot.touchFlags;
+    IQS7222_PROBE_STOP(PROBE_DECODE, decodeStart, SYS_FLAGS, STREAM_REPORT_SIZE);
+
+    if ((channelMask & ~snapshot.countsMask) != 0)
+    {
+        if (!readChannelData(channelMask, snapshot, stopOrRestart))
+            return false;
+    }
+    else if (stopOrRestart == STOP)
+    {
+        endWindow();
+    }
+
+    // Only single finger reports move the position
+    if (classifyTouch(snapshot) == TOUCH_SINGLE)
+    {
+        updatePosition(snapshot);
+    }
+    else
+    {
+        position.dx = 0;
+        position.dy = 0;
+        position.valid = false;
+    }
+    snapshot.readTick = micros();
+    publishState(snapshot, true);
+    return true;
+}
+
+/**
+ * @name    publishState
+ * @brief   A method which publishes a decoded report to the readers of readState.
+ * @param   snapshot   -> The decoded report.
+ *          sliderRead -> True if the slider outputs were read with the report, the previous outputs are kept if not.
+ * @retval  None.
+ * @notes   Counts and LTA are only replaced for the channels read with the report. The touch class and position must
+ *          already be updated.
+ */
+void IQS7222::publishState(const Sensor_snapshot& snapshot, bool sliderRead)
+{
+    uint32_t now = micros();
+
+    _state.update([&](Sensor_state& state) {
+        state.time = now;
+        state.systemFlags = snapshot.systemFlags;
+        state.eventFlags = snapshot.eventFlags;
+        state.proxFlags = snapshot.proxFlags;
+        state.touchFlags = snapshot.touchFlags;
+        state.countsMask |= snapshot.countsMask;
+        for (uint8_t i = 0; i < IQS7222_NUM_CHANNELS; i++)
+        {
+            if (snapshot.countsMask & (0x01 << i))
+            {
+                state.counts[i] = snapshot.counts[i];
+                state.lta[i] = snapshot.lta[i];
+            }
+        }
+        if (sliderRead)
+        {
+            state.slider[0] = snapshot.slider[0];
+            state.slider[1] = snapshot.slider[1];
+        }
+        state.powerMode = (POWER_MODE)((snapshot.systemFlags & POWER_MODE_BITS) >> POWER_MODE_SHIFT);
+        state.touchClass = touchClass;
+        state.position = position;
+    });
+}
+
+/**
+ * @name    takeReadyTick
+ * @brief   A method which returns the readyTick of the report about to be read.
+ * @param   readStart -> micros() at the start of the read, used if the driver has not seen the window opening.
+ * @retval  The micros() when RDY was first seen LOW, or readStart.
+ * @notes   When the application waits for RDY itself, e.g. with linuxWaitPinLow, the read follows the edge closely and
+ *          readStart is the best estimate available to the driver.
+ */
+uint32_t IQS7222::takeReadyTick(uint32_t readStart)
+{
+    uint32_t readyTick = _readySeen ? _readyTick : readStart;
+
+    _readySeen = false;
+    return readyTick;
+}
+
+/**
+ * @name    mirrorProfile
+ * @brief   A method which copies bytes written to the device into the register image of the active profile.
+ * @param   memoryAddress -> The memory address at which the bytes were written.
+ *          numBytes      -> The number of bytes written.
+ *          bytesArray    -> The array holding the written bytes.
+ * @retval  None.
+ * @notes   Keeps the image in sync with settings changed outside of applyProfile, e.g. the event mask or interface mode,
+ *          so that the image can be replayed. The one-shot command bits of CONTROL_SETTING are not mirrored.
+ */
+void IQS7222::mirrorProfile(uint16_t memoryAddress, uint8_t numBytes, const uint8_t bytesArray[])
+{
+    if (!_profileValid)
+        return;
+
+    for (uint8_t i = 0; i < PROFILE_NUM_BLOCKS; i++)
+    {
+        const Profile_block& block = profileBlocks[i];
+        uint32_t start = ((uint32_t)memoryAddress - block.address) * 2;
+
+        if ((memoryAddress < block.address) || (start >= block.length))
+            continue;
+
+        uint8_t* imageBytes = &_profile.image[block.offset + start];
+        if (imageBytes == bytesArray)
+            return;
+
+        uint8_t length = min((uint32_t)numBytes, block.length - start);
+        memcpy(imageBytes, bytesArray, length);
+        if (memoryAddress == CONTROL_SETTING)
+            imageBytes[0] &= ~COMMAND_BITS;
+        return;
+    }
+}
 
-    uint8_t transferByte24[6] = { GPIO0_SETUP_0, GPIO0_SETUP_1, ENABLE_MASK_0_7, ENABLE_MASK_8_9, ENABLESTATUSLINK_0, ENABLESTATUSLINK_1 };
-    writeRandomBytes(GPIO0_GENERAL, 6, transferByte24, RESTART);
-    uint8_t transferByte25[21] = { SYSTEM_CONTROL_0, SYSTEM_CONTROL_1, ATI_ERROR_TIMEOUT_0, ATI_ERROR_TIMEOUT_1, ATI_REPORT_RATE_0, ATI_REPORT_RATE_1, NORMAL_MODE_TIMEOUT_0, NORMAL_MODE_TIMEOUT_1, NORMAL_MODE_REPORT_RATE_0, NORMAL_MODE_REPORT_RATE_1, LP_MODE_TIMEOUT_0, LP_MODE_TIMEOUT_1, LP_MODE_REPORT_RATE_0, LP_MODE_REPORT_RATE_1, ULP_MODE_TIMEOUT_0, ULP_MODE_TIMEOUT_1, ULP_MODE_REPORT_RATE_0, ULP_MODE_REPORT_RATE_1, TOUCH_PROX_EVENT_MASK, POWER_ATI_EVENT_MASK, I2CCOMMS_0 };
-    writeRandomBytes(CONTROL_SETTING, 21, transferByte25, RESTART);
+/**
+ * @name    channelDelta
+ * @brief   A method which returns the deviation of a channel's counts from its LTA.
+ * @param   snapshot -> The report holding the counts and LTA.
+ *          channel  -> Index of the channel.
+ * @retval  Counts minus LTA, saturated to the int16_t range. Positive values indicate activity, as in compareCounts.
+ * @notes   The result is only meaningful for channels in snapshot.countsMask.
+ */
+int16_t IQS7222::channelDelta(const Sensor_snapshot& snapshot, uint8_t channel)
+{
+    int32_t delta = (int32_t)snapshot.counts[channel] - snapshot.lta[channel];
 
-}   
+    if (delta > INT16_MAX)
+        return INT16_MAX;
+    if (delta < INT16_MIN)
+        return INT16_MIN;
+    return delta;
+}
 
 /**
  * @name    compareCounts
  * @brief   A methods which compares each channel's count to the channel's LTA.
- * @param   counts      -> The array which stores the channels Counts bytes.
- *          LTA         -> The array which stores the channels LTA bytes.
+ * @param   counts      -> The array which stores the channels Counts bytes, starting at startChannel.
+ *          LTA         -> The array which stores the channels LTA bytes, starting at startChannel.
  *          numChannels -> The number of channels that must be iterated upon.
   *         startChannel-> Index of the first channel to verify;
  * @retval  Returns true if there a channel activity greater than the LTA, returns false if not.
@@ -814,7 +2990,7 @@ bool IQS7222::compareCounts(uint8_t counts[], uint8_t LTA[], uint8_t numChannels
     {
         if (event_channel[startChannel + i])
         {
-            if ((((counts[1] << 8) + counts[0]) - ((LTA[1] << 8) + LTA[0])) > ACTIVITY_THRESHOLD)
+            if ((((counts[2 * i + 1] << 8) + counts[2 * i]) - ((LTA[2 * i + 1] << 8) + LTA[2 * i])) > ACTIVITY_THRESHOLD)
             {
                 return false;
             }
@@ -823,31 +2999,49 @@ bool IQS7222::compareCounts(uint8_t counts[], uint8_t LTA[], uint8_t numChannels
     return true;
 }
 
+#if defined(IQS7222_ENABLE_STATS) || defined(IQS7222_ENABLE_TRACE)
 /**
- * @name    verifyPreviousTouch
- * @brief   A methods which 
- * @param   None.
- * @retval  Returns true if , returns false if not.
- * @notes   This meht.
+ * @name    recordProbe
+ * @brief   A method which records a completed operation in the latency histograms and the trace ring buffer.
+ * @param   op      -> The operation which completed, use the PROBE_OP enumerator.
+ *          begin   -> Probe clock when the operation started.
+ *          end     -> Probe clock when the operation completed.
+ *          address -> Register address of the transaction, 0 for other operations.
+ *          length  -> Number of bytes transferred, 0 for other operations.
+ * @retval  None.
+ * @notes   Durations above the last histogram bucket are accumulated in the last bucket.
+ *          When the ring buffer is full the oldest span is overwritten.
  */
-bool IQS7222::verifyPreviousTouch(void)
+void IQS7222::recordProbe(PROBE_OP op, uint32_t begin, uint32_t end, uint16_t address, uint8_t length)
 {
-    if (previousTouchRear == 0)
+#if defined(IQS7222_ENABLE_STATS)
+    static const int8_t histogramOf[] = { HIST_RDY_WAIT, HIST_TRANSACTION, HIST_TRANSACTION, HIST_DECODE, HIST_GESTURE, -1 };
+    uint32_t duration = end - begin;
+    uint8_t bucket = 0;
+
+    if (histogramOf[op] >= 0)
     {
-        if (previousTouch[9] != EMPTY)
-            return true;
-        else
-            return false;
+        while ((duration >>= 1) != 0 && bucket < (STATS_NUM_BUCKETS - 1))
+            bucket++;
+        _stats.histogram[histogramOf[op]][bucket]++;
     }
-    else if (previousTouchIndex == 10)
-        return true;
+#endif
+#if defined(IQS7222_ENABLE_TRACE)
+    Trace_span& span = _trace[_traceHead];
+    span.begin = begin;
+    span.end = end;
+    span.address = address;
+    span.op = op;
+    span.length = length;
+
+    _traceHead = (_traceHead + 1) % TRACE_DEPTH;
+    if (_traceCount < TRACE_DEPTH)
+        _traceCount++;
     else
-    {
-        if (previousTouch[previousTouchRear - 1] != EMPTY)
-            return true;
-        else
-            return false;
-    }
+        _traceDropped++;
+#else
+    (void)address;
+    (void)length;
+#endif
 }
-
-
+#endif
@@ -19,6 +19,8 @@
 #include "Arduino.h"
 #include <Wire.h>
 #include "IQS7222_addresses.h"
+#include "IQS7222_transport.h"
+#include "IQS7222_layout.h"
 
 // Include initilisation files depending on prototype
 #if defined(IQS7222_GALAXY)
@@ -26,6 +28,18 @@
 #elif defined(IQS7222_MAGNETIC)
 #include "init/IQS7222C_magnetic_init.h"
 #endif
+// Without a setup begin would leave the device in its power-on configuration
+#if !defined(IQS7222C_INIT_H) && !defined(IQS7222_RUNTIME_PROFILE)
+#error "No initialisation header: define IQS7222_MAGNETIC (the IQS7222_GALAXY header is empty), or IQS7222_RUNTIME_PROFILE to apply a profile with loadProfile after begin"
+#endif
+#include "IQS7222_profile.h"
+#include "IQS7222_trace.h"
+#include "IQS7222_log.h"
+#include "IQS7222_gesture.h"
+#include "IQS7222_noise.h"
+#include "IQS7222_telemetry.h"
+#include "IQS7222_health.h"
+#include "IQS7222_seqlock.h"
 
 // Public Global Definitions
 #define STOP true
@@ -36,48 +50,76 @@
 // Utility Bits
 #define ACK_RESET_BIT 0x01
 #define SHOW_RESET_BIT 0x08
+#define POWER_MODE_BITS 0x30	// Power mode field of SYS_FLAGS, see POWER_MODE
+#define POWER_MODE_SHIFT 4
 #define DO_RESET_BIT 0x01
 #define REDO_ATI_BIT 0x04
 
+#define COMMAND_BITS 0x07	// One-shot command bits of CONTROL_SETTING which must not be replayed
+
 // Parameters
 #define ACTIVITY_THRESHOLD 100
+#define POSITION_SCALE 256			// Position units per grid cell
+#define POSITION_SMOOTHING_SHIFT 2	// Smoothing of the position, each report moves 1/2^n of the way to the new centroid
+#define TOUCH_FINGER_CELLS 2		// Largest width and height, in grid cells, covered by a single finger
+#define TOUCH_PALM_CHANNELS 4		// Number of touched channels from which a frame is a palm
+#define TOUCH_PALM_STRENGTH 2000	// Sum of the touched channel deltas from which a frame is a palm
+#define TOUCH_PEAK_DELTA 300		// Delta of a peak under a finger, about 3/4 of a finger centred on a channel
+#define TOUCH_HISTORY_SIZE 10		// Channels kept in previousTouch for identifySwipe
+
+// Bus clocks probed by probeClock, slowest first
+#define BUS_CLOCK_STANDARD 100000
+#define BUS_CLOCK_FAST 400000
+#define BUS_CLOCK_FAST_PLUS 1000000
+#define BUS_NUM_CLOCKS 3
+#define BUS_PROBE_READS 4			// Read backs of the probe blocks at each clock
+#define BUS_ERROR_LIMIT 4			// Failed transactions within BUS_ERROR_WINDOW which lower the clock
+#define BUS_ERROR_WINDOW 256		// Transactions over which the failures are counted
+
+// Conversion timing model of estimateReportPeriod
+#define CYCLE_CLOCK 14000000		// Clock of the conversions, in Hz
+#define CYCLE_OVERHEAD_TIME 100		// Fixed time per enabled cycle, in microseconds
+
+// GPIO0 status link, see attachGpioButton
+#define GPIO_ACTIVE_LEVEL LOW		// Level of GPIO0 while a linked state is active, open drain output
+#define GPIO_NO_PIN 0xFF			// No MCU pin is attached to GPIO0
+
+// Line written by formatSnapshot, "IQS,readyTick,readTick,sendTick,flags...\n"
+#define SNAPSHOT_LINE_PREFIX "IQS"
+#define SNAPSHOT_LINE_SIZE 96
+
+// Bytes of the report burst, SYS_FLAGS to SLIDER2_OUTPUT
+#define STREAM_REPORT_SIZE 12
+
+// Communication request timing, in microseconds
+#define READY_PULSE_TIME 5000		// Time the READY pin is held LOW to request a window
+#define READY_RETRY_TIME 10000		// Time waited for the window before the request is repeated
+#define READY_RETRIES 10			// Number of requests before the device is considered absent
+
+// Headless polling timing, in microseconds
+#define POLL_DEFAULT_PERIOD 16000	// Report period assumed until learnt when no profile is loaded
+#define POLL_MIN_PERIOD 1000		// Bounds of the learnt report period
+#define POLL_MAX_PERIOD 250000
+#define POLL_BACKOFF_MIN 250		// Delay before the first retry of a missed poll, doubled at every miss
+#define POLL_BACKOFF_MAX 8000
+#define POLL_PERIOD_SHIFT 4			// The poll interval is shortened by 1/16 when a poll hits on its first attempt
+#define POLL_FILTER_SHIFT 2			// Weight of the measured period when a poll needed retries, 1/4
+#define POLL_RESYNC_HITS 4			// First attempt hits in a row after which the period is measured again
 
 typedef union {
 	uint16_t  flagByte;
 	struct {
-		uint8_t ch0 : 1;
-		uint8_t ch1 : 1;
-		uint8_t ch2 : 1;
-		uint8_t ch3 : 1;
-		uint8_t ch4 : 1;
-		uint8_t ch5 : 1;
-		uint8_t ch6 : 1;
-		uint8_t ch7 : 1;
-		uint8_t ch8 : 1;
-		uint8_t ch9 : 1;
-		uint8_t reserved : 6;
+		uint16_t channels : IQS7222_NUM_CHANNELS;	// Touch flag of each channel, bit n for channel n
 	} ;
-	//uint8_t channel_array[10]{ch0, ch1, ch2, ch3, ch4, ch5, ch6, ch7, ch8, ch9};
 } Touch_events;
 
-
-typedef enum
-{
-	EMPTY = 0,
-	CH1 = 1,
-	CH2 = 6,
-	CH3 = 2,
-	CH4 = 7,
-	CH5 = 3,
-	CH6 = 8
-} CHANNELS;
-
 // Swipe directions
 typedef enum {
 	UP,
 	DOWN,
 	LEFT,
-	RIGHT
+	RIGHT,
+	NO_SWIPE
 } DIRECTION;
 
 // Mask for the different events
@@ -94,6 +136,105 @@ typedef enum {
 	STREAM_TOUCH = 0x80
 } INTERFACE_MODE;
 
+// Stages of the prox triggered wake pipeline
+typedef enum {
+	WAKE_IDLE,		// Only prox events armed, the device is left to drop to its low power modes
+	WAKE_PREWARM,	// Prox detected, touch events armed and the low power report rate raised
+	WAKE_ACTIVE		// Touch detected, counts streamed while the touch is active
+} WAKE_STAGE;
+
+// Classification of the touched channels of a report
+typedef enum {
+	TOUCH_NONE,		// No channel touched
+	TOUCH_SINGLE,	// One finger, the touched channels form a single finger sized cluster
+	TOUCH_MULTI,	// Several fingers, the touched channels form separate clusters
+	TOUCH_PALM		// Palm or large object, held until every channel is released
+} TOUCH_CLASS;
+
+// Power mode reported in SYS_FLAGS
+typedef enum {
+	POWER_NP = 0,	// Normal power
+	POWER_LP = 1,	// Low power
+	POWER_ULP = 2	// Ultra low power
+} POWER_MODE;
+
+// Cooperative operations driven by tick
+typedef enum {
+	ASYNC_NONE,				// No operation in progress
+	ASYNC_BEGIN,			// Communication request, reset acknowledgement and initial setup, see beginAsync
+	ASYNC_REQUEST_COMMS,	// Communication request, see requestCommsAsync
+	ASYNC_AUTO_TUNE			// Communication request and ATI, see autoTuneAsync
+} ASYNC_OP;
+
+// Steps of the cooperative operations, each tick performs at most one
+typedef enum {
+	ASYNC_RDY_PULL,		// Pull the READY pin LOW
+	ASYNC_RDY_RELEASE,	// Release the READY pin after READY_PULSE_TIME
+	ASYNC_RDY_WAIT,		// Poll the READY pin for the communication window
+	ASYNC_ACK_READ,		// Read the control settings before acknowledging the reset
+	ASYNC_ACK_WRITE,	// Write the control settings back with the reset acknowledged
+	ASYNC_SETUP,		// Write one block of the initial setup
+	ASYNC_PROBE,		// Read back one block at the bus clock being probed, see probeClock
+	ASYNC_END,			// Close the communication window
+	ASYNC_ATI_READ,		// Read the control settings before starting the ATI
+	ASYNC_ATI_WRITE		// Write the control settings back with the ATI requested
+} ASYNC_STEP;
+
+// Result of a tick
+typedef enum {
+	STEP_IDLE,		// No operation in progress
+	STEP_BUSY,		// Operation in progress, tick must be called again
+	STEP_DONE,		// Operation completed during this tick
+	STEP_FAILED		// Operation abandoned, the device did not respond
+} STEP_STATUS;
+
+// Decoded device state of the last report
+typedef struct {
+	uint16_t systemFlags;	// SYS_FLAGS
+	uint16_t eventFlags;	// EVENT_FLAGS, see EVENT_MASK for the bits
+	uint16_t proxFlags;		// PROX_FLAGS, one bit per channel
+	uint16_t touchFlags;	// TOUCH_FLAGS, one bit per channel
+	uint16_t countsMask;	// Channels whose counts and LTA were read in this report
+	uint16_t counts[IQS7222_NUM_CHANNELS];	// Channel counts, only valid for the channels in countsMask
+	uint16_t lta[IQS7222_NUM_CHANNELS];		// Channel LTA, only valid for the channels in countsMask
+	uint16_t slider[2];		// SLIDER1_OUTPUT and SLIDER2_OUTPUT, only read with the prox and touch flags
+	uint32_t readyTick;		// micros() when the window of the report was seen opening, see formatSnapshot
+	uint32_t readTick;		// micros() when the report had been read
+} Sensor_snapshot;
+
+// Touch position on the electrode grid
+typedef struct {
+	int16_t x;			// Smoothed centroid, POSITION_SCALE units per column, 0 at the centre of the left column
+	int16_t y;			// Smoothed centroid, POSITION_SCALE units per row, 0 at the centre of the bottom row
+	int16_t dx;			// Motion of the smoothed centroid since the previous report
+	int16_t dy;
+	uint16_t strength;	// Sum of the channel deltas the centroid was computed from
+	bool valid;			// True while a touch is present
+} Touch_position;
+
+// Decoded device state published after every report, see readState
+typedef struct {
+	uint32_t time;			// micros() when the report was decoded
+	uint16_t systemFlags;	// SYS_FLAGS
+	uint16_t eventFlags;	// EVENT_FLAGS, see EVENT_MASK for the bits
+	uint16_t proxFlags;		// PROX_FLAGS, one bit per channel
+	uint16_t touchFlags;	// TOUCH_FLAGS, one bit per channel
+	uint16_t countsMask;	// Channels whose counts and LTA have been read at least once
+	uint16_t counts[IQS7222_NUM_CHANNELS];	// Last counts read of each channel
+	uint16_t lta[IQS7222_NUM_CHANNELS];		// Last LTA read of each channel
+	uint16_t slider[2];		// Last slider outputs read
+	POWER_MODE powerMode;
+	TOUCH_CLASS touchClass;
+	Touch_position position;
+} Sensor_state;
+
+// GPIO0 configuration, the three words of GPIO0_GENERAL
+typedef struct {
+	uint16_t setup;			// GPIO0_GENERAL, output settings as exported by the configuration tool
+	uint16_t channelMask;	// Channels whose state drives GPIO0, bit n for channel n
+	uint16_t statusLink;	// Other sources (sliders, system) driving GPIO0, encoded as exported by the configuration tool
+} Gpio_link;
+
 class IQS7222
 {
 public:
@@ -102,49 +243,184 @@ public:
 	
 	// Public Variables
 	Touch_events touch;
-	bool event_channel[10] = { false };
+	Touch_position position = {};
+	TOUCH_CLASS touchClass = TOUCH_NONE;
+	bool event_channel[IQS7222_NUM_CHANNELS] = { false };
 	//Gestures trackpadGestures; 
-	size_t previousTouchRear = 0;
-	size_t previousTouchIndex = 0;
-	CHANNELS channelTest[10] = { EMPTY, CH1, CH3, CH5, EMPTY, EMPTY, CH2, CH4, CH6, EMPTY};
-	CHANNELS previousTouch[10] = { CHANNELS::EMPTY };
+	size_t previousTouchRear = 0;	// Oldest entry of previousTouch
+	size_t previousTouchIndex = 0;	// Next entry of previousTouch
+	int8_t channelTest[IQS7222_NUM_CHANNELS];	// Channel of each electrode, -1 if the channel is not in the layout
+	int8_t previousTouch[TOUCH_HISTORY_SIZE];	// Channels touched in order, -1 for an empty entry
 
 	// Public methods
 	bool begin(uint8_t deviceAddressIn, uint8_t readyPinIn);
+	void setTransport(IQS7222_transport& transport);
+	uint32_t probeClock(bool stopOrRestart);
+	uint32_t getClock(void);
 	bool beginHeadless(uint8_t deviceAddressIn);
 	bool requestComms(void);
+	bool beginAsync(uint8_t deviceAddressIn, uint8_t readyPinIn);
+	bool requestCommsAsync(void);
+	bool autoTuneAsync(void);
+	STEP_STATUS tick(void);
 	bool checkReset(bool stopOrRestart);
 	void acknowledgeReset(bool stopOrRestart);
+	void recoverReset(bool stopOrRestart);
+	void cacheAtiResults(bool stopOrRestart);
 	void autoTune(bool stopOrRestart);
 	void softReset(bool stopOrRestart);
 	void printCounts(bool stopOrRestart);
 	void getTouchEvents(bool stopOrRestart);
 	void setEventMask(EVENT_MASK mask[], uint8_t numEvents, bool stopOrRestart);
+	void setEventMask(uint16_t events, bool stopOrRestart);
+	void beginEventMode(uint16_t events, bool stopOrRestart);
+	bool eventPending(void);
+	bool waitForEvent(uint32_t timeout);
+	bool serviceEvent(Sensor_snapshot& snapshot, bool stopOrRestart);
+	void beginStreamTouch(bool stopOrRestart);
+	bool updateStream(Sensor_snapshot& snapshot, bool stopOrRestart);
+	void beginPolling(void);
+	bool pollReport(Sensor_snapshot& snapshot, bool stopOrRestart);
+	uint32_t getPollPeriod(void);
+	size_t formatSnapshot(const Sensor_snapshot& snapshot, char buffer[], size_t length);
+	Seqlock_count readState(Sensor_state& state) const;
+	Seqlock_count stateVersion(void) const;
+	void beginWakePipeline(bool stopOrRestart);
+	WAKE_STAGE updateWakePipeline(Sensor_snapshot& snapshot, bool stopOrRestart);
 	void setInterface(INTERFACE_MODE mode, bool stopOrRestart);
 	uint16_t getEventFlags(bool stopOrRestart);
 	uint16_t getTouchChannel(bool stopOrRestart);
 	void ackowledgeEvent(bool stopOrRestart);
+	uint16_t activeChannels(void);
 	void verifyEvent(bool stopOrRestart);
 	void setAtiValues(bool baseOrTarget, uint8_t channel, uint8_t value, bool stopOrRestart);
 	void setAtiValues(bool baseOrTarget, uint8_t channel[], uint8_t numChannels, uint8_t value, bool stopOrRestart);
-	void addTouch(void);
+	DIRECTION addTouch(void);
+	DIRECTION addTouch(const Sensor_snapshot& snapshot);
+	TOUCH_CLASS classifyTouch(const Sensor_snapshot& snapshot);
 	void clearTouch(void);
 	void gestureUpdate(void);
+	bool updatePosition(const Sensor_snapshot& snapshot);
+	uint8_t updateGesture(void);
+	void useGestureTemplates(const Gesture_template templates[], uint8_t numTemplates);
 	DIRECTION identifySwipe(void);
+	uint8_t applyProfile(const IQS7222_profile& profile, bool stopOrRestart);
+	bool loadProfile(const uint8_t buffer[], size_t length, bool stopOrRestart);
+	uint32_t diffProfile(const IQS7222_profile& profile);
+	const IQS7222_profile& getProfile(void);
+	uint8_t pruneCycles(uint16_t channelMask, bool stopOrRestart);
+	uint8_t enabledCycles(void);
+	uint32_t estimateReportPeriod(bool stopOrRestart);
+	void beginNoiseMonitor(void);
+	uint32_t monitorNoise(const Sensor_snapshot& snapshot, bool stopOrRestart);
+	void setConversionFrequency(uint8_t frequency, bool stopOrRestart);
+	uint8_t getConversionFrequency(void);
+	void setGpioLink(const Gpio_link& link, bool stopOrRestart);
+	Gpio_link getGpioLink(void);
+	void linkChannelsToGpio(uint16_t channelMask, bool stopOrRestart);
+	bool attachGpioButton(uint8_t channel, uint8_t pin, void (*handler)(void), bool stopOrRestart);
+	void detachGpioButton(void);
+	bool gpioButtonActive(void);
+	bool logTelemetry(Telemetry_encoder& encoder, const Sensor_snapshot& snapshot, bool stopOrRestart);
+#if defined(IQS7222_ENABLE_STATS)
+	void getStats(IQS7222_stats& stats);
+	void resetStats(void);
+#endif
+#if defined(IQS7222_ENABLE_HEALTH)
+	void beginHealthMonitor(void);
+	void updateHealth(const Sensor_snapshot& snapshot, bool stopOrRestart);
+	void getHealthSummary(uint8_t channel, Health_summary& summary);
+#endif
+#if defined(IQS7222_ENABLE_TRACE)
+	uint8_t readTrace(Trace_span spans[], uint8_t maxSpans);
+	uint32_t getTraceDropped(void);
+	void clearTrace(void);
+#endif
 
 
 private:
 	// Private variables
 	uint8_t _deviceAddress;
 	uint8_t _readyPin;
+	IQS7222_transport* _transport = &wireTransport;
+	uint8_t _clockIndex = 0;		// Index of the bus clock in use, see BUS_CLOCK_STANDARD
+	uint16_t _busTransactions = 0;	// Transactions in the current error window
+	uint8_t _busErrors = 0;			// Failed transactions in the current error window
+	uint8_t _readAttempts = TRANSPORT_READ_ATTEMPTS;	// Attempts per read, 1 while polling
+	uint32_t _pollPeriod = POLL_DEFAULT_PERIOD;	// Learnt report period
+	uint32_t _pollInterval = POLL_DEFAULT_PERIOD;	// Time from a report to the next poll
+	uint32_t _pollLast = 0;		// micros() of the last report read by pollReport
+	uint32_t _pollAnchor = 0;	// micros() of the last poll which hit after a miss, i.e. close to the opening of a window
+	uint32_t _pollNext = 0;		// micros() of the next poll
+	uint32_t _pollBackoff = POLL_BACKOFF_MIN;	// Delay before the next retry of a missed poll
+	uint8_t _pollMisses = 0;	// Missed polls since the last report
+	uint8_t _pollHits = 0;		// Reports read since _pollAnchor
+	bool _pollAnchored = false;	// True once _pollAnchor is set
+	uint32_t _readyTick = 0;	// micros() when RDY was first seen LOW in the current window
+	bool _readySeen = false;	// True from the first RDY LOW seen until the report is read
+	IQS7222_profile _profile;	// Register image of the active configuration
+	bool _profileValid = false;	// True once _profile matches the device registers
+	uint16_t _eventMask = 0;	// Events enabled with setEventMask, see EVENT_MASK
+	uint16_t _streamTouch = 0;	// Touch flags of the previous streamed report
+	WAKE_STAGE _wakeStage = WAKE_IDLE;
+	bool _palmLatched = false;	// Palm seen since the last report without touch
+	Gesture_track _gestureTrack = {};
+	ASYNC_OP _asyncOp = ASYNC_NONE;
+	ASYNC_STEP _asyncStep = ASYNC_RDY_PULL;
+	uint8_t _asyncIndex = 0;	// Request retries while waiting for the window, block index during the setup, clock
+								// index during the probe
+	uint8_t _asyncBytes[2];		// Control settings read by a read step for the following write step
+	uint8_t _asyncRead = 0;		// Read-backs done at the clock being probed
+	uint8_t _asyncClock = 0;	// Index of the fastest clock which passed the probe
+	uint32_t _asyncTime = 0;	// micros() at the start of the current READY step
+	const Gesture_template* _gestureTemplates = gestureDefaultTemplates;
+	uint8_t _gestureNumTemplates = gestureNumDefaultTemplates;
+	uint8_t _wakeLpReport[2];	// LP report rate restored when the wake pipeline returns to idle
+	Seqlock<Sensor_state> _state;	// State published to the readers, see readState
+	Noise_monitor _noise = {};
+	uint8_t _gpioPin = GPIO_NO_PIN;	// MCU pin attached to GPIO0 by attachGpioButton
+#if defined(IQS7222_ENABLE_STATS)
+	IQS7222_stats _stats = {};
+#endif
+#if defined(IQS7222_ENABLE_HEALTH)
+	Health_monitor _health = {};
+#endif
+#if defined(IQS7222_ENABLE_TRACE)
+	Trace_span _trace[TRACE_DEPTH];
+	uint16_t _traceHead = 0;
+	uint16_t _traceCount = 0;
+	uint32_t _traceDropped = 0;
+#endif
 
 	// Private methods
 	void toggleReady(void);
-	void readRandomBytes(uint16_t memoryAddress, uint8_t numBytes, uint8_t bytesArray[], bool stopOrRestart);
-	void writeRandomBytes(uint16_t memoryAddress, uint8_t numBytes, uint8_t bytesArray[], bool stopOrRestart);
+	bool readRandomBytes(uint16_t memoryAddress, uint8_t numBytes, uint8_t bytesArray[], bool stopOrRestart);
+	bool readRandomBlocks(const uint16_t memoryAddresses[], const uint8_t numBytes[], uint8_t* bytesArrays[],
+		uint8_t numBlocks, bool stopOrRestart);
+	bool writeRandomBytes(uint16_t memoryAddress, uint8_t numBytes, uint8_t bytesArray[], bool stopOrRestart);
+	uint8_t encodeAddress(uint16_t memoryAddress, uint8_t addressBytes[]);
+	bool setClockIndex(uint8_t index);
+	bool verifyBlock(uint8_t blockIndex, bool stopOrRestart);
+	void trackBusErrors(bool success);
 	void initialSetup(bool stopOrRestart);
+	void writeProfileBlock(uint8_t blockIndex, uint8_t start, uint8_t end, bool stopOrRestart);
+	void disableCycles(IQS7222_profile& profile, uint8_t cycleMask);
+	void endWindow(void);
+	bool startAsync(ASYNC_OP op);
+	STEP_STATUS finishAsync(STEP_STATUS status);
+	bool readChannelData(uint16_t channelMask, Sensor_snapshot& snapshot, bool stopOrRestart);
+	bool readMissingChannels(const Sensor_snapshot& snapshot, uint16_t channels, uint8_t& reports, uint8_t period,
+		Sensor_snapshot& sample, bool stopOrRestart);
+	bool readStreamReport(uint8_t transferBytes[], Sensor_snapshot& snapshot, bool stopOrRestart);
+	bool decodeStream(const uint8_t transferBytes[], Sensor_snapshot& snapshot, bool stopOrRestart);
+	void publishState(const Sensor_snapshot& snapshot, bool sliderRead);
+	uint32_t takeReadyTick(uint32_t readStart);
+	void mirrorProfile(uint16_t memoryAddress, uint8_t numBytes, const uint8_t bytesArray[]);
+#if defined(IQS7222_ENABLE_STATS) || defined(IQS7222_ENABLE_TRACE)
+	void recordProbe(PROBE_OP op, uint32_t begin, uint32_t end, uint16_t address, uint8_t length);
+#endif
+	int16_t channelDelta(const Sensor_snapshot& snapshot, uint8_t channel);
 	bool compareCounts(uint8_t counts[], uint8_t LTA[], uint8_t numChannels, uint8_t startChannel);
-	bool verifyPreviousTouch();
 };
 
 #endif
\ No newline at end of file
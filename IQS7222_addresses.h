@@ -74,7 +74,7 @@
 
 #define GLOBAL_CYCLE_SETUP 0x8500
 #define MULTIPLIER_PRELOAD 0x8501
-#define COMPENSATION_PRELOAD 0x502
+#define COMPENSATION_PRELOAD 0x8502
 
 // Button Setup
 #define BUTTON0_SETUP 0x9000
@@ -118,12 +118,12 @@
 #define CH3_REF_SETTINGS0 0xA304
 #define CH3_REF_SETTINGS1 0xA305
 // Channel 4 Setup
-#define CH4_GENERAL 0x400
-#define CH4_ATI 0x401
-#define CH4_MULTIPLIERS 0x402
+#define CH4_GENERAL 0xA400
+#define CH4_ATI 0xA401
+#define CH4_MULTIPLIERS 0xA402
 #define CH4_ATI_COMPENSATION 0xA403
-#define CH4_REF_SETTINGS0 0x404
-#define CH4_REF_SETTINGS1 0x405
+#define CH4_REF_SETTINGS0 0xA404
+#define CH4_REF_SETTINGS1 0xA405
 // Channel 5 Setup
 #define CH5_GENERAL 0xA500
 #define CH5_ATI 0xA501
@@ -153,12 +153,12 @@
 #define CH8_REF_SETTINGS0 0xA804
 #define CH8_REF_SETTINGS1 0xA805
 // Channel 9 Setup
-#define CH9_GENERAL 0x900
-#define CH9_ATI 0x901
-#define CH9_MULTIPLIERS 0x902
+#define CH9_GENERAL 0xA900
+#define CH9_ATI 0xA901
+#define CH9_MULTIPLIERS 0xA902
 #define CH9_ATI_COMPENSATION 0xA903
-#define CH9_REF_SETTINGS0 0x904
-#define CH9_REF_SETTINGS1 0x905
+#define CH9_REF_SETTINGS0 0xA904
+#define CH9_REF_SETTINGS1 0xA905
 
 // Filter Betas 
 #define FILTER_BETA 0xAA00
@@ -190,6 +190,8 @@
 
 // GPIO0 Settings
 #define GPIO0_GENERAL 0xC000
+#define GPIO0_ENABLE_MASK 0xC001	// Channels linked to GPIO0, word 1 of the profile block
+#define GPIO0_STATUS_LINK 0xC002	// Status sources linked to GPIO0, word 2 of the profile block
 #define GPIO0_MASK 0xC004
 #define GPIO0_STATUS 0xC005
 
@@ -0,0 +1,353 @@
+/**
+  **********************************************************************************
+  * @file     IQS7222_gesture.cpp
+  * @author   Colin Laganier
+  * @version  V0.1
+  * @date     2026-10-18
+  * @brief   This file contains the built-in gesture templates and the functions used to
+  *          record a touch track and match it against templates with bounded DTW.
+  **********************************************************************************
+  * @attention  Requires standard Arduino Libraries: Arduino.h.
+  */
+
+  // Include Files
+#include "IQS7222.h"
+
+/**************************************************************************************************************/
+/*                                             BUILT-IN TEMPLATES                                             */
+/**************************************************************************************************************/
+
+constexpr Gesture_point swipeUp[] IQS7222_FLASH = {
+    { 0, -32 }, { 0, -23 }, { 0, -14 }, { 0, -5 }, { 0, 5 }, { 0, 14 }, { 0, 23 }, { 0, 32 }
+};
+constexpr Gesture_point swipeDown[] IQS7222_FLASH = {
+    { 0, 32 }, { 0, 23 }, { 0, 14 }, { 0, 5 }, { 0, -5 }, { 0, -14 }, { 0, -23 }, { 0, -32 }
+};
+constexpr Gesture_point swipeLeft[] IQS7222_FLASH = {
+    { 16, 0 }, { 11, 0 }, { 7, 0 }, { 2, 0 }, { -2, 0 }, { -7, 0 }, { -11, 0 }, { -16, 0 }
+};
+constexpr Gesture_point swipeRight[] IQS7222_FLASH = {
+    { -16, 0 }, { -11, 0 }, { -7, 0 }, { -2, 0 }, { 2, 0 }, { 7, 0 }, { 11, 0 }, { 16, 0 }
+};
+// Circles start and end at the bottom of the panel
+constexpr Gesture_point circleClockwise[] IQS7222_FLASH = {
+    { 0, -32 }, { -8, -28 }, { -14, -16 }, { -16, 0 }, { -14, 16 }, { -8, 28 },
+    { 0, 32 }, { 8, 28 }, { 14, 16 }, { 16, 0 }, { 14, -16 }, { 8, -28 }
+};
+constexpr Gesture_point circleCounterClockwise[] IQS7222_FLASH = {
+    { 0, -32 }, { 8, -28 }, { 14, -16 }, { 16, 0 }, { 14, 16 }, { 8, 28 },
+    { 0, 32 }, { -8, 28 }, { -14, 16 }, { -16, 0 }, { -14, -16 }, { -8, -28 }
+};
+
+const Gesture_template gestureDefaultTemplates[] = {
+    gestureTemplate(GESTURE_SWIPE_UP, swipeUp, GESTURE_DEFAULT_THRESHOLD),
+    gestureTemplate(GESTURE_SWIPE_DOWN, swipeDown, GESTURE_DEFAULT_THRESHOLD),
+    gestureTemplate(GESTURE_SWIPE_LEFT, swipeLeft, GESTURE_DEFAULT_THRESHOLD),
+    gestureTemplate(GESTURE_SWIPE_RIGHT, swipeRight, GESTURE_DEFAULT_THRESHOLD),
+    gestureTemplate(GESTURE_CIRCLE_CW, circleClockwise, GESTURE_DEFAULT_THRESHOLD),
+    gestureTemplate(GESTURE_CIRCLE_CCW, circleCounterClockwise, GESTURE_DEFAULT_THRESHOLD)
+};
+const uint8_t gestureNumDefaultTemplates = sizeof(gestureDefaultTemplates) / sizeof(gestureDefaultTemplates[0]);
+
+/**************************************************************************************************************/
+/*                                                FUNCTIONS                                                   */
+/**************************************************************************************************************/
+
+/**
+  * @name   readPoint
+  * @brief  Reads a template point from flash.
+  * @param  pattern -> The template.
+  *         index -> Index of the point.
+  *         x, y -> Receive the coordinates of the point.
+  * @retval None.
+  * @notes  None.
+  */
+static void readPoint(const Gesture_template& pattern, uint8_t index, int16_t& x, int16_t& y)
+{
+    x = (int8_t)IQS7222_FLASH_BYTE(&pattern.points[index].x);
+    y = (int8_t)IQS7222_FLASH_BYTE(&pattern.points[index].y);
+}
+
+/**
+  * @name   gestureRecord
+  * @brief  Adds a position to a touch track.
+  * @param  track -> The track of the current touch.
+  *         x, y -> The position in template units.
+  * @retval None.
+  * @notes  Every track.stride reports a point is recorded. When the track is full every other point is dropped and the
+  *         stride doubled, so a track covers the whole touch in at most GESTURE_TRACK_LENGTH points. Past
+  *         GESTURE_MAX_STRIDE the stride is kept and the older half of the track is only coarser.
+  */
+void gestureRecord(Gesture_track& track, int16_t x, int16_t y)
+{
+    if (track.skipped + 1 < track.stride)
+    {
+        track.skipped++;
+        return;
+    }
+    track.skipped = 0;
+
+    if (track.length == GESTURE_TRACK_LENGTH)
+    {
+        for (uint8_t i = 0; i < (GESTURE_TRACK_LENGTH / 2); i++)
+        {
+            track.x[i] = track.x[2 * i];
+            track.y[i] = track.y[2 * i];
+        }
+        track.length = GESTURE_TRACK_LENGTH / 2;
+        if (track.stride < GESTURE_MAX_STRIDE)
+            track.stride *= 2;
+    }
+
+    track.x[track.length] = x;
+    track.y[track.length] = y;
+    track.length++;
+}
+
+/**
+  * @name   gestureStill
+  * @brief  Checks whether a touch track stayed close to its first point.
+  * @param  track -> The track of the current touch.
+  *         distance -> Largest movement along x or y, in template units.
+  * @retval Returns true if no point is further than distance from the first point.
+  * @notes  None.
+  */
+bool gestureStill(const Gesture_track& track, int16_t distance)
+{
+    for (uint8_t i = 1; i < track.length; i++)
+    {
+        if ((abs(track.x[i] - track.x[0]) > distance) || (abs(track.y[i] - track.y[0]) > distance))
+            return false;
+    }
+    return true;
+}
+
+/**
+  * @name   gestureResample
+  * @brief  Resamples a touch track to a number of evenly spaced points centred on their mean.
+  * @param  track -> The track of the current touch.
+  *         x, y -> Arrays of at least length elements which receive the points.
+  *         length -> Number of points, 2 to GESTURE_MAX_POINTS.
+  * @retval Number of points written, 0 if the track holds less than 2 points.
+  * @notes  Points are linearly interpolated along the recorded track.
+  */
+uint8_t gestureResample(const Gesture_track& track, int16_t x[], int16_t y[], uint8_t length)
+{
+    int32_t sumX = 0;
+    int32_t sumY = 0;
+
+    if ((track.length < 2) || (length < 2))
+        return 0;
+
+    for (uint8_t k = 0; k < length; k++)
+    {
+        // Position along the track in 1/256 of a recorded point
+        uint16_t position = ((uint32_t)k * (track.length - 1) * 256) / (length - 1);
+        uint8_t i = position >> 8;
+        int16_t fraction = position & 0xFF;
+
+        x[k] = track.x[i];
+        y[k] = track.y[i];
+        if (i + 1 < track.length)
+        {
+            x[k] += ((int32_t)(track.x[i + 1] - track.x[i]) * fraction) >> 8;
+            y[k] += ((int32_t)(track.y[i + 1] - track.y[i]) * fraction) >> 8;
+        }
+        sumX += x[k];
+        sumY += y[k];
+    }
+
+    for (uint8_t k = 0; k < length; k++)
+    {
+        x[k] -= sumX / length;
+        y[k] -= sumY / length;
+    }
+    return length;
+}
+
+/**
+  * @name   envelopePush
+  * @brief  Adds a template coordinate to the sliding minimum or maximum of the band.
+  * @param  queue -> Indices of the candidate extremes, their values ordered from the front.
+  *         values -> The coordinates read so far.
+  *         index -> Index of the new coordinate.
+  *         minimum -> True for the sliding minimum, false for the maximum.
+  * @retval None.
+  * @notes  Candidates which can no longer be the extreme of a later band are dropped from the back.
+  */
+static void envelopePush(Gesture_envelope& queue, const int16_t values[], uint8_t index, bool minimum)
+{
+    while ((queue.tail > queue.head) && (minimum ? (values[queue.index[queue.tail - 1]] >= values[index])
+        : (values[queue.index[queue.tail - 1]] <= values[index])))
+        queue.tail--;
+    queue.index[queue.tail++] = index;
+}
+
+/**
+  * @name   envelopeFront
+  * @brief  Returns the extreme of a band after dropping the candidates which left it.
+  * @param  queue -> The sliding minimum or maximum.
+  *         values -> The coordinates read so far.
+  *         first -> Index of the first template point of the band.
+  * @retval The minimum or maximum coordinate of the band.
+  * @notes  None.
+  */
+static int16_t envelopeFront(Gesture_envelope& queue, const int16_t values[], uint8_t first)
+{
+    while (queue.index[queue.head] < first)
+        queue.head++;
+    return values[queue.index[queue.head]];
+}
+
+/**
+  * @name   gestureLowerBound
+  * @brief  Computes the LB_Keogh lower bound of the DTW distance between a track and a template.
+  * @param  x, y -> The track resampled to the template length.
+  *         pattern -> The template.
+  *         limit -> Distance above which the computation is abandoned.
+  * @retval Lower bound of gestureDistance, a value above limit if the computation was abandoned.
+  * @notes  Each track point is compared to the bounding box of the template points within GESTURE_BAND of it. The
+  *         boxes are kept as sliding minima and maxima while the band moves along the template, so each template
+  *         point is read from flash once and the bound costs O(length) against O(length * (2 * GESTURE_BAND + 1))
+  *         point distances for the DTW itself.
+  */
+uint32_t gestureLowerBound(const int16_t x[], const int16_t y[], const Gesture_template& pattern, uint32_t limit)
+{
+    int16_t pointX[GESTURE_MAX_POINTS];
+    int16_t pointY[GESTURE_MAX_POINTS];
+    Gesture_envelope lowX = {}, highX = {};
+    Gesture_envelope lowY = {}, highY = {};
+    uint8_t next = 0;
+    uint32_t bound = 0;
+
+    for (uint8_t i = 0; i < pattern.length; i++)
+    {
+        uint8_t first = (i > GESTURE_BAND) ? (i - GESTURE_BAND) : 0;
+        uint8_t last = min((uint8_t)(i + GESTURE_BAND), (uint8_t)(pattern.length - 1));
+
+        for (; next <= last; next++)
+        {
+            readPoint(pattern, next, pointX[next], pointY[next]);
+            envelopePush(lowX, pointX, next, true);
+            envelopePush(highX, pointX, next, false);
+            envelopePush(lowY, pointY, next, true);
+            envelopePush(highY, pointY, next, false);
+        }
+
+        int16_t bandLowX = envelopeFront(lowX, pointX, first);
+        int16_t bandHighX = envelopeFront(highX, pointX, first);
+        int16_t bandLowY = envelopeFront(lowY, pointY, first);
+        int16_t bandHighY = envelopeFront(highY, pointY, first);
+        int32_t dx = (x[i] > bandHighX) ? (x[i] - bandHighX) : ((x[i] < bandLowX) ? (bandLowX - x[i]) : 0);
+        int32_t dy = (y[i] > bandHighY) ? (y[i] - bandHighY) : ((y[i] < bandLowY) ? (bandLowY - y[i]) : 0);
+        bound += dx * dx + dy * dy;
+        if (bound > limit)
+            break;
+    }
+    return bound;
+}
+
+/**
+  * @name   gestureDistance
+  * @brief  Computes the DTW distance between a track and a template within a Sakoe-Chiba band.
+  * @param  x, y -> The track resampled to the template length.
+  *         pattern -> The template.
+  *         limit -> Distance above which the computation is abandoned.
+  * @retval Sum of the squared distances along the best warping path, UINT32_MAX if it exceeds limit.
+  * @notes  The warping path stays within GESTURE_BAND points of the diagonal. The computation is abandoned as soon as
+  *         every cell of a row exceeds limit, as the distance can only grow along the path.
+  */
+uint32_t gestureDistance(const int16_t x[], const int16_t y[], const Gesture_template& pattern, uint32_t limit)
+{
+    uint32_t rows[2][GESTURE_MAX_POINTS];
+    uint32_t* previous = rows[0];
+    uint32_t* current = rows[1];
+    uint8_t length = pattern.length;
+
+    for (uint8_t i = 0; i < length; i++)
+    {
+        uint8_t first = (i > GESTURE_BAND) ? (i - GESTURE_BAND) : 0;
+        uint8_t last = min((uint8_t)(i + GESTURE_BAND), (uint8_t)(length - 1));
+        uint32_t rowMin = UINT32_MAX;
+
+        for (uint8_t j = 0; j < length; j++)
+            current[j] = UINT32_MAX;
+
+        for (uint8_t j = first; j <= last; j++)
+        {
+            uint32_t best;
+            if ((i == 0) && (j == 0))
+            {
+                best = 0;
+            }
+            else
+            {
+                best = UINT32_MAX;
+                if (i > 0)
+                    best = min(best, previous[j]);
+                if (j > 0)
+                    best = min(best, current[j - 1]);
+                if ((i > 0) && (j > 0))
+                    best = min(best, previous[j - 1]);
+                if (best == UINT32_MAX)
+                    continue;
+            }
+
+            int16_t pointX, pointY;
+            readPoint(pattern, j, pointX, pointY);
+            int32_t dx = x[i] - pointX;
+            int32_t dy = y[i] - pointY;
+            current[j] = best + dx * dx + dy * dy;
+            rowMin = min(rowMin, current[j]);
+        }
+
+        if (rowMin > limit)
+            return UINT32_MAX;
+
+        uint32_t* swap = previous;
+        previous = current;
+        current = swap;
+    }
+    return previous[length - 1];
+}
+
+/**
+  * @name   gestureMatch
+  * @brief  Finds the template closest to a touch track.
+  * @param  track -> The track of the touch.
+  *         templates -> The templates to match against.
+  *         numTemplates -> Number of templates.
+  * @retval Identifier of the template with the lowest mean distance per point within its threshold, GESTURE_NONE if
+  *         no template matches.
+  * @notes  The threshold of each template is tightened to the best match found so far, templates whose lower bound
+  *         exceeds it are skipped and the DTW of the others is abandoned as soon as it does.
+  */
+uint8_t gestureMatch(const Gesture_track& track, const Gesture_template templates[], uint8_t numTemplates)
+{
+    int16_t x[GESTURE_MAX_POINTS];
+    int16_t y[GESTURE_MAX_POINTS];
+    uint32_t bestMean = UINT32_MAX;
+    uint8_t best = GESTURE_NONE;
+
+    for (uint8_t t = 0; t < numTemplates; t++)
+    {
+        const Gesture_template& pattern = templates[t];
+        if ((pattern.length > GESTURE_MAX_POINTS) || (gestureResample(track, x, y, pattern.length) == 0))
+            continue;
+
+        uint32_t limit = min((uint32_t)pattern.threshold, bestMean) * pattern.length;
+        if (gestureLowerBound(x, y, pattern, limit) > limit)
+            continue;
+
+        uint32_t distance = gestureDistance(x, y, pattern, limit);
+        if (distance > limit)
+            continue;
+
+        if ((distance / pattern.length) < bestMean)
+        {
+            bestMean = distance / pattern.length;
+            best = pattern.id;
+        }
+    }
+    return best;
+}
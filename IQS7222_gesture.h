@@ -0,0 +1,121 @@
+/**
+  **********************************************************************************
+  * @file     IQS7222_gesture.h
+  * @author   Colin Laganier
+  * @version  V0.1
+  * @date     2026-10-18
+  * @brief   This file contains the gesture template format and the bounded dynamic
+  *          time warping (DTW) matcher used to recognise gestures from the touch position.
+  **********************************************************************************
+  * @attention  Template points are in GESTURE_POINT_SCALE units per grid cell, centred on
+  *             their mean (x to the right, y up), and are stored in flash (PROGMEM on AVR).
+  *             Declare user templates as follows and pass the table to useGestureTemplates:
+  *               constexpr Gesture_point zigzag[] IQS7222_FLASH = { { -16, 32 }, ... };
+  *               const Gesture_template myGestures[] = { gestureTemplate(GESTURE_USER, zigzag, 144) };
+  */
+
+#ifndef IQS7222_GESTURE_H
+#define IQS7222_GESTURE_H
+
+// Include Files
+#include "Arduino.h"
+#if defined(__AVR__)
+#include <avr/pgmspace.h>
+#endif
+
+// Template point storage, templates are read from flash on AVR
+#if defined(__AVR__)
+#define IQS7222_FLASH PROGMEM
+#define IQS7222_FLASH_BYTE(address) pgm_read_byte(address)
+#else
+#define IQS7222_FLASH
+#define IQS7222_FLASH_BYTE(address) (*(const uint8_t*)(address))
+#endif
+
+// Matching parameters
+#define GESTURE_POINT_SHIFT 3		// Position units (POSITION_SCALE per cell) to template units
+#define GESTURE_POINT_SCALE 32		// Template units per grid cell
+#define GESTURE_MAX_POINTS 16		// Maximum number of points of a template
+#define GESTURE_TRACK_LENGTH 32		// Number of positions recorded per touch, the track is decimated when full
+#define GESTURE_MAX_STRIDE 0x8000	// Largest number of reports per recorded point, the stride stops doubling there
+#define GESTURE_BAND 3				// Sakoe-Chiba band radius of the DTW, in points
+#define GESTURE_DEFAULT_THRESHOLD 144	// Mean squared distance per point accepted by the built-in templates
+
+// Timing rules, in milliseconds and template units
+#define GESTURE_TAP_TIME 200		// Longest touch recognised as a tap
+#define GESTURE_DOUBLE_TAP_TIME 300	// Longest time between the two taps of a double tap
+#define GESTURE_LONG_PRESS_TIME 600	// Shortest still touch recognised as a long press
+#define GESTURE_STILL_DISTANCE 12	// Largest movement from the first position of a tap or long press
+
+// Recognised gestures, swipes are GESTURE_SWIPE + DIRECTION
+typedef enum {
+	GESTURE_NONE = 0,
+	GESTURE_TAP = 1,
+	GESTURE_DOUBLE_TAP = 2,
+	GESTURE_LONG_PRESS = 3,
+	GESTURE_SWIPE = 4,
+	GESTURE_SWIPE_UP = GESTURE_SWIPE + 0,
+	GESTURE_SWIPE_DOWN = GESTURE_SWIPE + 1,
+	GESTURE_SWIPE_LEFT = GESTURE_SWIPE + 2,
+	GESTURE_SWIPE_RIGHT = GESTURE_SWIPE + 3,
+	GESTURE_CIRCLE_CW = 8,
+	GESTURE_CIRCLE_CCW = 9,
+	GESTURE_USER = 16		// First identifier available to user templates
+} GESTURE;
+
+// Template point, GESTURE_POINT_SCALE units per grid cell
+typedef struct {
+	int8_t x;
+	int8_t y;
+} Gesture_point;
+
+// Gesture template, the table is kept in RAM and the points in flash
+typedef struct {
+	uint8_t id;						// Gesture reported on a match, see GESTURE
+	uint8_t length;					// Number of points, at most GESTURE_MAX_POINTS
+	const Gesture_point* points;	// Points centred on their mean, in flash
+	uint16_t threshold;				// Largest mean squared distance per point accepted
+} Gesture_template;
+
+// Positions recorded during a touch
+typedef struct {
+	int16_t x[GESTURE_TRACK_LENGTH];	// Template units, not centred
+	int16_t y[GESTURE_TRACK_LENGTH];
+	uint8_t length;				// Number of recorded points
+	uint16_t stride;			// Reports per recorded point, doubled on every decimation up to GESTURE_MAX_STRIDE
+	uint16_t skipped;			// Reports since the last recorded point
+	bool active;				// True while a single finger touch is tracked
+	bool reported;				// True once a gesture has been reported for the touch
+	bool rejected;				// True from a multi-touch or palm report until every finger is lifted
+	bool tapPending;			// True while a tap is held, it can still become a double tap
+	uint8_t deferred;			// Gesture recognised with the held tap, returned by the next call
+	uint32_t start;				// millis() at the start of the touch
+	uint32_t lastTap;			// millis() at the end of the pending tap
+} Gesture_track;
+
+// Sliding minimum or maximum of the template points within the band, see gestureLowerBound
+typedef struct {
+	uint8_t index[GESTURE_MAX_POINTS];	// Template points which can still be the extreme, each is added once
+	uint8_t head;						// First candidate, the extreme of the current band
+	uint8_t tail;						// One past the last candidate
+} Gesture_envelope;
+
+// Builds a template from a point array, the length is checked by the compiler
+template <size_t N>
+constexpr Gesture_template gestureTemplate(uint8_t id, const Gesture_point (&points)[N], uint16_t threshold)
+{
+	static_assert((N >= 2) && (N <= GESTURE_MAX_POINTS), "A gesture template needs 2 to GESTURE_MAX_POINTS points");
+	return Gesture_template{ id, N, points, threshold };
+}
+
+extern const Gesture_template gestureDefaultTemplates[];
+extern const uint8_t gestureNumDefaultTemplates;
+
+void gestureRecord(Gesture_track& track, int16_t x, int16_t y);
+bool gestureStill(const Gesture_track& track, int16_t distance);
+uint8_t gestureResample(const Gesture_track& track, int16_t x[], int16_t y[], uint8_t length);
+uint32_t gestureLowerBound(const int16_t x[], const int16_t y[], const Gesture_template& pattern, uint32_t limit);
+uint32_t gestureDistance(const int16_t x[], const int16_t y[], const Gesture_template& pattern, uint32_t limit);
+uint8_t gestureMatch(const Gesture_track& track, const Gesture_template templates[], uint8_t numTemplates);
+
+#endif // IQS7222_GESTURE_H
@@ -0,0 +1,218 @@
+/**
+  **********************************************************************************
+  * @file     IQS7222_health.cpp
+  * @author   Colin Laganier
+  * @version  V0.1
+  * @date     2026-10-18
+  * @brief   This file contains the functions of the health monitor which update the running
+  *          statistics of each channel and summarise them.
+  **********************************************************************************
+  * @attention  Requires standard Arduino Libraries: Arduino.h.
+  */
+
+  // Include Files
+#include "IQS7222.h"
+#include <math.h>
+
+const uint8_t healthQuantiles[HEALTH_NUM_QUANTILES] = HEALTH_QUANTILES;
+
+/**************************************************************************************************************/
+/*                                                FUNCTIONS                                                   */
+/**************************************************************************************************************/
+
+/**
+  * @name   healthBucket
+  * @brief  Returns the sketch bucket of a delta.
+  * @param  delta -> The delta.
+  * @retval HEALTH_SKETCH_OCTAVES plus or minus the bit length of |delta|, limited to HEALTH_SKETCH_OCTAVES.
+  * @notes  Bucket HEALTH_SKETCH_OCTAVES + k holds the deltas in [2^(k-1), 2^k - 1], the negative buckets mirror them.
+  */
+static uint8_t healthBucket(int16_t delta)
+{
+    uint16_t magnitude = (delta < 0) ? (uint16_t)(-(int32_t)delta) : delta;
+    uint8_t octave = 0;
+
+    while ((magnitude != 0) && (octave < HEALTH_SKETCH_OCTAVES))
+    {
+        magnitude >>= 1;
+        octave++;
+    }
+    return (delta < 0) ? (HEALTH_SKETCH_OCTAVES - octave) : (HEALTH_SKETCH_OCTAVES + octave);
+}
+
+/**
+  * @name   healthReset
+  * @brief  Clears the statistics of every channel.
+  * @param  monitor -> The monitor to clear.
+  *         now     -> millis(), start of the LTA drift measurement.
+  * @retval None.
+  * @notes  None.
+  */
+void healthReset(Health_monitor& monitor, uint32_t now)
+{
+    memset(&monitor, 0, sizeof(monitor));
+    monitor.startTime = now;
+    monitor.lastTime = now;
+}
+
+/**
+  * @name   healthSample
+  * @brief  Adds a delta sample to the statistics of a channel.
+  * @param  monitor -> The monitor to update.
+  *         channel -> Index of the channel.
+  *         delta   -> Counts minus LTA of the channel, see IQS7222::channelDelta.
+  *         lta     -> LTA of the channel.
+  *         idle    -> True if the channel is neither in touch nor in proximity.
+  * @retval None.
+  * @notes  The mean and variance only take idle samples, they measure the offset and the noise of the electrode. The
+  *         minimum, maximum and sketch take every sample so that the touch deltas appear in the upper quantiles. When
+  *         a bucket of the sketch is full every bucket is halved, the older samples weigh less from then on.
+  *         A float increment of 1/n of the deviation would be lost to rounding after about 2^24 samples, so past
+  *         HEALTH_MEAN_WINDOW samples the weight of a sample stays 1/HEALTH_MEAN_WINDOW: the mean and variance then
+  *         follow the last HEALTH_MEAN_WINDOW idle samples (about 11 minutes at 100 reports per second).
+  */
+void healthSample(Health_monitor& monitor, uint8_t channel, int16_t delta, uint16_t lta, bool idle)
+{
+    Health_channel& stats = monitor.channels[channel];
+    uint8_t bucket = healthBucket(delta);
+
+    if (!(monitor.sampledMask & (0x01 << channel)))
+    {
+        monitor.sampledMask |= 0x01 << channel;
+        stats.minimum = delta;
+        stats.maximum = delta;
+        stats.ltaFirst = lta;
+    }
+
+    if (idle)
+    {
+        float deviation = delta - stats.mean;
+
+        if (stats.samples < UINT32_MAX)
+            stats.samples++;
+        if (stats.samples < HEALTH_MEAN_WINDOW)
+        {
+            stats.mean += deviation / stats.samples;
+            stats.m2 += deviation * (delta - stats.mean);
+        }
+        else
+        {
+            stats.mean += deviation / HEALTH_MEAN_WINDOW;
+            stats.m2 += deviation * (delta - stats.mean) - stats.m2 / HEALTH_MEAN_WINDOW;
+        }
+    }
+
+    stats.minimum = min(stats.minimum, delta);
+    stats.maximum = max(stats.maximum, delta);
+    stats.ltaLast = lta;
+
+    if (stats.sketch[bucket] == UINT16_MAX)
+    {
+        for (uint8_t i = 0; i < HEALTH_NUM_BUCKETS; i++)
+            stats.sketch[i] >>= 1;
+    }
+    stats.sketch[bucket]++;
+}
+
+/**
+  * @name   healthTouches
+  * @brief  Counts the touches started since the previous report.
+  * @param  monitor    -> The monitor to update.
+  *         touchFlags -> Touch flags of the report.
+  * @retval None.
+  * @notes  A touch is counted when the flag of the channel is set, whether or not the channel was sampled.
+  */
+void healthTouches(Health_monitor& monitor, uint16_t touchFlags)
+{
+    uint16_t started = touchFlags & ~monitor.touchFlags;
+
+    for (uint8_t i = 0; i < IQS7222_NUM_CHANNELS; i++)
+    {
+        if (started & (0x01 << i))
+            monitor.channels[i].touches++;
+    }
+    monitor.touchFlags = touchFlags;
+}
+
+/**
+  * @name   healthQuantile
+  * @brief  Estimates a quantile of the delta of a channel from its sketch.
+  * @param  channel -> The statistics of the channel.
+  *         percent -> The quantile, 0 to 100.
+  * @retval The delta below which percent of the samples are, 0 if the channel was never sampled.
+  * @notes  Interpolated linearly inside the bucket holding the quantile, the error is at most the width of the bucket,
+  *         i.e. half the value. The buckets are bounded by the minimum and maximum, which bound the open ended ones.
+  */
+int16_t healthQuantile(const Health_channel& channel, uint8_t percent)
+{
+    uint32_t total = 0;
+    uint32_t below = 0;
+    uint32_t rank;
+
+    for (uint8_t i = 0; i < HEALTH_NUM_BUCKETS; i++)
+        total += channel.sketch[i];
+    if (total == 0)
+        return 0;
+    rank = ((total - 1) * min(percent, (uint8_t)100)) / 100;
+
+    for (uint8_t i = 0; i < HEALTH_NUM_BUCKETS; i++)
+    {
+        if ((below + channel.sketch[i]) <= rank)
+        {
+            below += channel.sketch[i];
+            continue;
+        }
+
+        int8_t octave = (int8_t)i - HEALTH_SKETCH_OCTAVES;
+        uint8_t bits = (octave < 0) ? -octave : octave;
+        int32_t low = (bits == 0) ? 0 : (1L << (bits - 1));
+        int32_t high = (bits == 0) ? 0 : ((1L << bits) - 1);
+        float position = (rank - below + 0.5f) / channel.sketch[i];
+        int32_t value;
+
+        // The last octave is open ended, only the extreme bounds it
+        if (bits == HEALTH_SKETCH_OCTAVES)
+            high = (octave < 0) ? -(int32_t)channel.minimum : (int32_t)channel.maximum;
+        if (octave < 0)
+        {
+            high = min(high, -(int32_t)channel.minimum);
+            value = -(int32_t)(high - position * (high - low) + 0.5f);
+        }
+        else
+        {
+            high = min(high, (int32_t)channel.maximum);
+            value = low + (int32_t)(position * (high - low) + 0.5f);
+        }
+        return constrain(value, (int32_t)channel.minimum, (int32_t)channel.maximum);
+    }
+    return channel.maximum;
+}
+
+/**
+  * @name   healthSummarise
+  * @brief  Fills the summary record of a channel.
+  * @param  monitor -> The monitor to read.
+  *         channel -> Index of the channel.
+  *         summary -> Receives the summary.
+  * @retval None.
+  * @notes  The LTA drift is the change of the LTA from the first to the last sample over the time the monitor ran,
+  *         restart the monitor after an ATI, which moves the LTA.
+  */
+void healthSummarise(const Health_monitor& monitor, uint8_t channel, Health_summary& summary)
+{
+    const Health_channel& stats = monitor.channels[channel];
+    uint32_t elapsed = monitor.lastTime - monitor.startTime;
+    uint32_t weighted = min(stats.samples, (uint32_t)HEALTH_MEAN_WINDOW);
+
+    summary.samples = stats.samples;
+    summary.touches = stats.touches;
+    summary.mean = constrain(stats.mean * 16, INT16_MIN, INT16_MAX);
+    summary.deviation = (weighted > 1) ? constrain(sqrtf(stats.m2 / (weighted - 1)) * 16, 0, UINT16_MAX) : 0;
+    summary.minimum = stats.minimum;
+    summary.maximum = stats.maximum;
+    for (uint8_t i = 0; i < HEALTH_NUM_QUANTILES; i++)
+        summary.quantiles[i] = healthQuantile(stats, healthQuantiles[i]);
+    summary.ltaDrift = 0;
+    if ((elapsed >= HEALTH_DRIFT_MIN_TIME) && (monitor.sampledMask & (0x01 << channel)))
+        summary.ltaDrift = constrain(((float)stats.ltaLast - stats.ltaFirst) * 3600000.0f / elapsed, INT16_MIN, INT16_MAX);
+}
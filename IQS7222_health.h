@@ -0,0 +1,74 @@
+/**
+  **********************************************************************************
+  * @file     IQS7222_health.h
+  * @author   Colin Laganier
+  * @version  V0.1
+  * @date     2026-10-18
+  * @brief   This file contains the optional health monitor which keeps running statistics
+  *          of every channel to detect the degradation of the electrodes in the field.
+  **********************************************************************************
+  * @attention  Define IQS7222_ENABLE_HEALTH to compile the monitor into the driver, it takes
+  *             about 66 bytes of RAM per channel. The monitor only keeps statistics, it is fed
+  *             by IQS7222::updateHealth and read with IQS7222::getHealthSummary. Every update
+  *             takes a fixed number of operations per channel, nothing is stored per sample.
+  */
+
+#ifndef IQS7222_HEALTH_H
+#define IQS7222_HEALTH_H
+
+// Include Files
+#include "Arduino.h"
+#include "IQS7222_layout.h"
+
+// Monitor parameters
+#define HEALTH_SAMPLE_REPORTS 8			// Reports between two reads of the channels not read by the stream
+#define HEALTH_SKETCH_OCTAVES 10		// Octaves of the delta magnitude per sign, the last one holds |delta| >= 512
+#define HEALTH_NUM_BUCKETS (2 * HEALTH_SKETCH_OCTAVES + 1)
+#define HEALTH_DRIFT_MIN_TIME 60000		// Time before the LTA drift is reported, in milliseconds
+#define HEALTH_MEAN_WINDOW 65536		// Idle samples past which the mean and variance are exponentially weighted
+#define HEALTH_NUM_QUANTILES 3
+#define HEALTH_QUANTILES { 50, 90, 99 }	// Quantiles of the delta in the summary, in percent
+
+typedef struct {
+	uint32_t samples;		// Idle samples in the mean and variance
+	float mean;				// Mean of the idle delta, counts
+	float m2;				// Sum of the squared deviations of the idle delta from the mean (Welford), counts^2,
+							// weighted over the last HEALTH_MEAN_WINDOW samples
+	int16_t minimum;		// Smallest delta sampled
+	int16_t maximum;		// Largest delta sampled
+	uint16_t ltaFirst;		// LTA when the channel was first sampled
+	uint16_t ltaLast;		// LTA when the channel was last sampled
+	uint32_t touches;		// Touches started
+	uint16_t sketch[HEALTH_NUM_BUCKETS];	// Delta histogram, one bucket per octave of each sign, 0 in the middle
+} Health_channel;
+
+typedef struct {
+	Health_channel channels[IQS7222_NUM_CHANNELS];
+	uint16_t sampledMask;	// Channels sampled at least once
+	uint16_t touchFlags;	// Touch flags of the previous report
+	uint8_t reports;		// Reports since the last read of the channels not read by the stream
+	uint32_t startTime;		// millis() when the monitor was started
+	uint32_t lastTime;		// millis() of the last update
+} Health_monitor;
+
+// Summary of a channel, 24 bytes to ship as health telemetry
+typedef struct {
+	uint32_t samples;		// Idle samples in the mean and deviation
+	uint32_t touches;		// Touches started
+	int16_t mean;			// Mean of the idle delta, 1/16 counts
+	uint16_t deviation;		// Standard deviation of the idle delta, 1/16 counts
+	int16_t minimum;		// Smallest delta
+	int16_t maximum;		// Largest delta
+	int16_t quantiles[HEALTH_NUM_QUANTILES];	// Delta at each of HEALTH_QUANTILES, of every sample
+	int16_t ltaDrift;		// LTA change per hour, 0 before HEALTH_DRIFT_MIN_TIME
+} Health_summary;
+
+extern const uint8_t healthQuantiles[HEALTH_NUM_QUANTILES];
+
+void healthReset(Health_monitor& monitor, uint32_t now);
+void healthSample(Health_monitor& monitor, uint8_t channel, int16_t delta, uint16_t lta, bool idle);
+void healthTouches(Health_monitor& monitor, uint16_t touchFlags);
+int16_t healthQuantile(const Health_channel& channel, uint8_t percent);
+void healthSummarise(const Health_monitor& monitor, uint8_t channel, Health_summary& summary);
+
+#endif // IQS7222_HEALTH_H
@@ -0,0 +1,129 @@
+/**
+  **********************************************************************************
+  * @file     IQS7222_layout.h
+  * @author   Colin Laganier
+  * @version  V0.1
+  * @date     2026-10-18
+  * @brief   This file contains the compile-time electrode layout descriptor of the IQS7222
+  *          library and the tables derived from it.
+  **********************************************************************************
+  * @attention  A layout defines IQS7222_NUM_CHANNELS, IQS7222_NUM_CYCLES, IQS7222_CYCLE_CHANNELS,
+  *             IQS7222_GRID_ROWS, IQS7222_GRID_COLS and IQS7222_GRID. Define them before including
+  *             the library to describe another variant (e.g. IQS7222A/B) or panel,
+  *             layout/IQS7222C_grid_layout.h is used otherwise. Channels used outside of the grid,
+  *             e.g. a proximity channel, are listed in IQS7222_KEEP_CHANNELS so that their cycle
+  *             is not pruned.
+  *             Every table is evaluated by the compiler, nothing is computed at runtime.
+  */
+
+#ifndef IQS7222_LAYOUT_H
+#define IQS7222_LAYOUT_H
+
+// Include Files
+#include "Arduino.h"
+
+#if !defined(IQS7222_NUM_CHANNELS)
+#include "layout/IQS7222C_grid_layout.h"
+#endif
+
+// Maximum number of channels, limited by the 16bit flag registers
+#define IQS7222_MAX_CHANNELS 16
+
+// Channels converted in addition to the grid, none by default
+#if !defined(IQS7222_KEEP_CHANNELS)
+#define IQS7222_KEEP_CHANNELS 0
+#endif
+
+// Mask of every channel of the device
+#define IQS7222_CHANNEL_BITS ((uint16_t)((1UL << IQS7222_NUM_CHANNELS) - 1))
+
+#define IQS7222_GRID_CELLS (IQS7222_GRID_ROWS * IQS7222_GRID_COLS)
+
+static_assert(IQS7222_NUM_CHANNELS <= IQS7222_MAX_CHANNELS, "The flag registers hold at most 16 channels");
+
+constexpr int8_t layoutGrid[IQS7222_GRID_CELLS] = IQS7222_GRID;
+
+// Bit of a channel in the flag registers, 0 for an empty cell
+constexpr uint16_t layoutBit(int8_t channel)
+{
+	return (channel < 0) ? 0 : (uint16_t)(1U << channel);
+}
+
+// Channel of a grid cell, -1 outside of the grid
+constexpr int8_t layoutCell(uint8_t row, uint8_t col)
+{
+	return ((row < IQS7222_GRID_ROWS) && (col < IQS7222_GRID_COLS)) ? layoutGrid[row * IQS7222_GRID_COLS + col] : -1;
+}
+
+// Channels sharing an edge with a grid cell
+constexpr uint16_t layoutCellNeighbours(uint8_t row, uint8_t col)
+{
+	return layoutBit(layoutCell(row - 1, col)) | layoutBit(layoutCell(row + 1, col))
+		| layoutBit(layoutCell(row, col - 1)) | layoutBit(layoutCell(row, col + 1));
+}
+
+// Channels sharing an edge with a channel, 0 for a channel which is not in the grid
+constexpr uint16_t layoutNeighbours(int8_t channel, uint8_t cell = 0)
+{
+	return (cell >= IQS7222_GRID_CELLS) ? 0
+		: (((layoutGrid[cell] == channel) ? layoutCellNeighbours(cell / IQS7222_GRID_COLS, cell % IQS7222_GRID_COLS) : 0)
+			| layoutNeighbours(channel, cell + 1));
+}
+
+// Mask of the channels connected to an electrode of the grid
+constexpr uint16_t layoutChannels(uint8_t cell = 0)
+{
+	return (cell >= IQS7222_GRID_CELLS) ? 0 : (layoutBit(layoutGrid[cell]) | layoutChannels(cell + 1));
+}
+
+// Grid cell of a channel, -1 for a channel which is not in the grid
+constexpr int8_t layoutCellOf(int8_t channel, uint8_t cell = 0)
+{
+	return (cell >= IQS7222_GRID_CELLS) ? -1 : ((layoutGrid[cell] == channel) ? (int8_t)cell : layoutCellOf(channel, cell + 1));
+}
+
+// Column and row of a channel, -1 for a channel which is not in the grid
+constexpr int8_t layoutColumn(int8_t channel)
+{
+	return (layoutCellOf(channel) < 0) ? -1 : (int8_t)(layoutCellOf(channel) % IQS7222_GRID_COLS);
+}
+
+constexpr int8_t layoutRow(int8_t channel)
+{
+	return (layoutCellOf(channel) < 0) ? -1 : (int8_t)(layoutCellOf(channel) / IQS7222_GRID_COLS);
+}
+
+// Neighbour table indexed by channel, channels beyond IQS7222_NUM_CHANNELS are never set
+constexpr uint16_t layoutNeighbourTable[IQS7222_MAX_CHANNELS] = {
+	layoutNeighbours(0), layoutNeighbours(1), layoutNeighbours(2), layoutNeighbours(3),
+	layoutNeighbours(4), layoutNeighbours(5), layoutNeighbours(6), layoutNeighbours(7),
+	layoutNeighbours(8), layoutNeighbours(9), layoutNeighbours(10), layoutNeighbours(11),
+	layoutNeighbours(12), layoutNeighbours(13), layoutNeighbours(14), layoutNeighbours(15)
+};
+
+// Column and row tables indexed by channel
+constexpr int8_t layoutColumnTable[IQS7222_MAX_CHANNELS] = {
+	layoutColumn(0), layoutColumn(1), layoutColumn(2), layoutColumn(3),
+	layoutColumn(4), layoutColumn(5), layoutColumn(6), layoutColumn(7),
+	layoutColumn(8), layoutColumn(9), layoutColumn(10), layoutColumn(11),
+	layoutColumn(12), layoutColumn(13), layoutColumn(14), layoutColumn(15)
+};
+
+constexpr int8_t layoutRowTable[IQS7222_MAX_CHANNELS] = {
+	layoutRow(0), layoutRow(1), layoutRow(2), layoutRow(3),
+	layoutRow(4), layoutRow(5), layoutRow(6), layoutRow(7),
+	layoutRow(8), layoutRow(9), layoutRow(10), layoutRow(11),
+	layoutRow(12), layoutRow(13), layoutRow(14), layoutRow(15)
+};
+
+// Mask of the conversion cycles which convert at least one channel of a mask
+constexpr uint8_t layoutCycleMask(uint16_t channelMask, uint8_t cycle = 0)
+{
+	return (cycle >= IQS7222_NUM_CYCLES) ? 0
+		: (((IQS7222_CYCLE_CHANNELS(cycle) & channelMask) ? (uint8_t)(1U << cycle) : 0) | layoutCycleMask(channelMask, cycle + 1));
+}
+
+// Conversion cycles needed by the layout
+constexpr uint8_t layoutCycles = layoutCycleMask(layoutChannels() | IQS7222_KEEP_CHANNELS);
+
+#endif // IQS7222_LAYOUT_H
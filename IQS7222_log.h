@@ -0,0 +1,36 @@
+/**
+  **********************************************************************************
+  * @file     IQS7222_log.h
+  * @author   Colin Laganier
+  * @version  V0.1
+  * @date     2026-10-18
+  * @brief   This file contains the optional diagnostics output of the IQS7222 library.
+  **********************************************************************************
+  * @attention  The library does not print anything unless IQS7222_LOG_SINK is defined to an
+  *             object with a println(const char*) method, e.g. -DIQS7222_LOG_SINK=Serial.
+  *             Messages are formatted on the stack in a buffer of IQS7222_LOG_BUFFER bytes,
+  *             longer messages are truncated. No heap memory is used.
+  */
+
+#ifndef IQS7222_LOG_H
+#define IQS7222_LOG_H
+
+// Include Files
+#include "Arduino.h"
+
+// Size of the formatting buffer, including the terminating null character, every message of the library fits
+#ifndef IQS7222_LOG_BUFFER
+#define IQS7222_LOG_BUFFER 96
+#endif
+
+#if defined(IQS7222_LOG_SINK)
+#define IQS7222_LOG(...) do { \
+		char logBuffer[IQS7222_LOG_BUFFER]; \
+		snprintf(logBuffer, IQS7222_LOG_BUFFER, __VA_ARGS__); \
+		IQS7222_LOG_SINK.println(logBuffer); \
+	} while (0)
+#else
+#define IQS7222_LOG(...) do { } while (0)
+#endif
+
+#endif // IQS7222_LOG_H
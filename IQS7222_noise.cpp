@@ -0,0 +1,108 @@
+/**
+  **********************************************************************************
+  * @file     IQS7222_noise.cpp
+  * @author   Colin Laganier
+  * @version  V0.1
+  * @date     2026-10-18
+  * @brief   This file contains the functions of the noise monitor which track the delta
+  *          variance of each channel and rank the conversion frequencies.
+  **********************************************************************************
+  * @attention  Requires standard Arduino Libraries: Arduino.h.
+  */
+
+  // Include Files
+#include "IQS7222.h"
+
+const int8_t noiseFrequencyOffsets[NOISE_NUM_FREQUENCIES] = NOISE_FREQUENCY_OFFSETS;
+
+/**************************************************************************************************************/
+/*                                                FUNCTIONS                                                   */
+/**************************************************************************************************************/
+
+/**
+  * @name   noiseReset
+  * @brief  Clears the statistics of every channel.
+  * @param  monitor -> The monitor to clear.
+  * @retval None.
+  * @notes  The level measured at each frequency and the frequency in use are kept.
+  */
+void noiseReset(Noise_monitor& monitor)
+{
+    memset(monitor.mean, 0, sizeof(monitor.mean));
+    memset(monitor.variance, 0, sizeof(monitor.variance));
+    memset(monitor.samples, 0, sizeof(monitor.samples));
+}
+
+/**
+  * @name   noiseSample
+  * @brief  Adds a delta sample to the statistics of a channel.
+  * @param  monitor -> The monitor to update.
+  *         channel -> Index of the channel.
+  *         delta   -> Counts minus LTA of the channel, see IQS7222::channelDelta.
+  * @retval None.
+  * @notes  Exponentially weighted mean and variance with weight 2^-NOISE_FILTER_SHIFT, the first sample seeds the mean.
+  *         The variance of a slow drift is small, only the report to report scatter is measured.
+  */
+void noiseSample(Noise_monitor& monitor, uint8_t channel, int16_t delta)
+{
+    int32_t deviation;
+    uint32_t square;
+
+    if (monitor.samples[channel] == 0)
+    {
+        monitor.mean[channel] = (int32_t)delta << 4;
+        monitor.samples[channel] = 1;
+        return;
+    }
+
+    deviation = (int32_t)delta - (monitor.mean[channel] >> 4);
+    square = min((uint32_t)((int64_t)deviation * deviation), (uint32_t)UINT16_MAX * UINT16_MAX);
+    monitor.mean[channel] += (((int32_t)delta << 4) - monitor.mean[channel]) >> NOISE_FILTER_SHIFT;
+    if (square >= monitor.variance[channel])
+        monitor.variance[channel] += (square - monitor.variance[channel]) >> NOISE_FILTER_SHIFT;
+    else
+        monitor.variance[channel] -= (monitor.variance[channel] - square) >> NOISE_FILTER_SHIFT;
+    if (monitor.samples[channel] < UINT8_MAX)
+        monitor.samples[channel]++;
+}
+
+/**
+  * @name   noiseLevel
+  * @brief  Returns the noise level of a set of channels.
+  * @param  monitor     -> The monitor to read.
+  *         channelMask -> Mask of the channels to consider, bit n for channel n.
+  * @retval The largest delta variance in counts^2, 0 until a channel has 2^NOISE_FILTER_SHIFT samples.
+  * @notes  The noisiest channel sets the level, it is the one which would report false touches first.
+  */
+uint32_t noiseLevel(const Noise_monitor& monitor, uint16_t channelMask)
+{
+    uint32_t level = 0;
+
+    for (uint8_t i = 0; i < IQS7222_NUM_CHANNELS; i++)
+    {
+        if ((channelMask & (0x01 << i)) && (monitor.samples[i] > (1 << NOISE_FILTER_SHIFT)))
+            level = max(level, monitor.variance[i]);
+    }
+    return level;
+}
+
+/**
+  * @name   noiseQuietest
+  * @brief  Selects the frequency with the lowest known noise level.
+  * @param  monitor -> The monitor to read.
+  * @retval Index of the frequency in noiseFrequencyOffsets.
+  * @notes  A frequency not yet measured has a level of 0 and is tried first, in table order after the frequency in use.
+  *         The frequency in use is returned if no other one was measured quieter.
+  */
+uint8_t noiseQuietest(const Noise_monitor& monitor)
+{
+    uint8_t quietest = monitor.frequency;
+
+    for (uint8_t i = 1; i < NOISE_NUM_FREQUENCIES; i++)
+    {
+        uint8_t frequency = (monitor.frequency + i) % NOISE_NUM_FREQUENCIES;
+        if (monitor.level[frequency] < monitor.level[quietest])
+            quietest = frequency;
+    }
+    return quietest;
+}
@@ -0,0 +1,50 @@
+/**
+  **********************************************************************************
+  * @file     IQS7222_noise.h
+  * @author   Colin Laganier
+  * @version  V0.1
+  * @date     2026-10-18
+  * @brief   This file contains the noise monitor which tracks the count variance of the
+  *          untouched channels and selects the conversion frequency with the least noise.
+  **********************************************************************************
+  * @attention  The monitor only keeps statistics, the conversion frequency is programmed by
+  *             IQS7222::monitorNoise. Frequencies are offsets of CONV_FREQ_FRAC from the
+  *             value of each cycle in the profile.
+  */
+
+#ifndef IQS7222_NOISE_H
+#define IQS7222_NOISE_H
+
+// Include Files
+#include "Arduino.h"
+#include "IQS7222_layout.h"
+
+// Monitor parameters
+#define NOISE_FILTER_SHIFT 3		// Weight of a sample in the mean and variance, 1/8
+#define NOISE_THRESHOLD 100			// Delta variance above which the frequency is changed, in counts^2 (10 counts rms)
+#define NOISE_HOLDOFF_TIME 2000		// Minimum time between two changes of frequency, in milliseconds
+#define NOISE_SETTLE_REPORTS 32		// Reports ignored after a change while the ATI and the filters settle
+#define NOISE_SAMPLE_REPORTS 8		// Reports between two reads of the channels not read by the stream
+#define NOISE_NUM_FREQUENCIES 4
+#define NOISE_FREQUENCY_OFFSETS { 0, 12, -12, 24 }	// CONV_FREQ_FRAC offsets, the first is the profile frequency
+
+typedef struct {
+	int32_t mean[IQS7222_NUM_CHANNELS];		// Mean delta, 1/16 count units
+	uint32_t variance[IQS7222_NUM_CHANNELS];	// Variance of the delta, counts^2
+	uint8_t samples[IQS7222_NUM_CHANNELS];	// Samples taken, saturates once the variance is settled
+	uint32_t level[NOISE_NUM_FREQUENCIES];	// Noise level last measured at each frequency, 0 if never measured
+	uint8_t baseFrac[IQS7222_NUM_CYCLES];	// CONV_FREQ_FRAC of each cycle in the profile
+	uint8_t frequency;		// Index of the frequency in use
+	uint8_t settle;			// Reports left before the level is measured again
+	uint8_t reports;		// Reports since the last read of the channels not read by the stream
+	uint32_t lastChange;	// millis() of the last change of frequency
+} Noise_monitor;
+
+extern const int8_t noiseFrequencyOffsets[NOISE_NUM_FREQUENCIES];
+
+void noiseReset(Noise_monitor& monitor);
+void noiseSample(Noise_monitor& monitor, uint8_t channel, int16_t delta);
+uint32_t noiseLevel(const Noise_monitor& monitor, uint16_t channelMask);
+uint8_t noiseQuietest(const Noise_monitor& monitor);
+
+#endif // IQS7222_NOISE_H
@@ -0,0 +1,230 @@
+/**
+  **********************************************************************************
+  * @file     IQS7222_profile.cpp
+  * @author   Colin Laganier
+  * @version  V0.1
+  * @date     2026-10-18
+  * @brief   This file contains the functions used to validate, serialise and compare
+  *          IQS7222 configuration profiles.
+  **********************************************************************************
+  * @attention  Requires standard Arduino Libraries: Arduino.h.
+  */
+
+  // Include Files
+#include "IQS7222.h"
+
+/**************************************************************************************************************/
+/*                                               BLOCK TABLE                                                  */
+/**************************************************************************************************************/
+
+// Register blocks in the order in which they are written to the device
+const Profile_block profileBlocks[PROFILE_NUM_BLOCKS] = {
+    { CYCLE0_SETUP, 6, 0 },
+    { CYCLE1_SETUP, 6, 6 },
+    { CYCLE2_SETUP, 6, 12 },
+    { CYCLE3_SETUP, 6, 18 },
+    { CYCLE4_SETUP, 6, 24 },
+    { GLOBAL_CYCLE_SETUP, 6, 30 },
+    { BUTTON0_SETUP, 6, 36 },
+    { BUTTON1_SETUP, 6, 42 },
+    { BUTTON2_SETUP, 6, 48 },
+    { BUTTON3_SETUP, 6, 54 },
+    { BUTTON4_SETUP, 6, 60 },
+    { BUTTON5_SETUP, 6, 66 },
+    { BUTTON6_SETUP, 6, 72 },
+    { BUTTON7_SETUP, 6, 78 },
+    { BUTTON8_SETUP, 6, 84 },
+    { BUTTON9_SETUP, 6, 90 },
+    { CH0_GENERAL, 12, 96 },
+    { CH1_GENERAL, 12, 108 },
+    { CH2_GENERAL, 12, 120 },
+    { CH3_GENERAL, 12, 132 },
+    { CH4_GENERAL, 12, 144 },
+    { CH5_GENERAL, 12, 156 },
+    { CH6_GENERAL, 12, 168 },
+    { CH7_GENERAL, 12, 180 },
+    { CH8_GENERAL, 12, 192 },
+    { CH9_GENERAL, 12, 204 },
+    { FILTER_BETA, 4, 216 },
+    { SLIDER0_GENERAL, 20, 220 },
+    { SLIDER1_GENERAL, 20, 240 },
+    { GPIO0_GENERAL, 6, 260 },
+    { CONTROL_SETTING, 21, 266 }
+};
+
+/**************************************************************************************************************/
+/*                                                FUNCTIONS                                                   */
+/**************************************************************************************************************/
+
+/**
+  * @name   profileCrc
+  * @brief  A function which computes the CRC-16/CCITT (polynomial 0x1021, initial value 0xFFFF) of a buffer.
+  * @param  buffer -> The array of bytes to compute the checksum of.
+  *         length -> The number of bytes in the buffer.
+  * @retval 16bit checksum of the buffer.
+  * @notes  Bitwise implementation to avoid a 512 byte lookup table on small targets.
+  */
+uint16_t profileCrc(const uint8_t buffer[], size_t length)
+{
+    uint16_t crc = 0xFFFF;
+
+    for (size_t i = 0; i < length; i++)
+    {
+        crc ^= (uint16_t)buffer[i] << 8;
+        for (uint8_t bit = 0; bit < 8; bit++)
+        {
+            if (crc & 0x8000)
+                crc = (crc << 1) ^ 0x1021;
+            else
+                crc <<= 1;
+        }
+    }
+    return crc;
+}
+
+/**
+  * @name   profileValidate
+  * @brief  A function which verifies that a buffer holds a complete profile of a supported version.
+  * @param  buffer -> The array holding the serialised profile.
+  *         length -> The number of bytes in the buffer.
+  * @retval Returns true if the magic, version, image length and checksum are all valid, returns false if not.
+  * @notes  None.
+  */
+bool profileValidate(const uint8_t buffer[], size_t length)
+{
+    if (length < PROFILE_SIZE)
+        return false;
+
+    if ((buffer[0] != PROFILE_MAGIC_0) || (buffer[1] != PROFILE_MAGIC_1) || (buffer[2] != PROFILE_MAGIC_2) || (buffer[3] != PROFILE_MAGIC_3))
+        return false;
+
+    if (buffer[4] != PROFILE_VERSION)
+        return false;
+
+    if (((buffer[7] << 8) + buffer[6]) != PROFILE_IMAGE_SIZE)
+        return false;
+
+    size_t crcOffset = PROFILE_HEADER_SIZE + PROFILE_IMAGE_SIZE;
+    uint16_t crc = (buffer[crcOffset + 1] << 8) + buffer[crcOffset];
+
+    return (crc == profileCrc(buffer, crcOffset));
+}
+
+/**
+  * @name   profileLoad
+  * @brief  A function which validates a serialised profile and copies its register image.
+  * @param  buffer  -> The array holding the serialised profile, e.g. read from storage or received from a host.
+  *         length  -> The number of bytes in the buffer.
+  *         profile -> The profile which will receive the register image, it is only overwritten if the buffer is valid.
+  * @retval Returns true if the profile was loaded, returns false if the buffer is invalid.
+  * @notes  None.
+  */
+bool profileLoad(const uint8_t buffer[], size_t length, IQS7222_profile& profile)
+{
+    if (!profileValidate(buffer, length))
+        return false;
+
+    memcpy(profile.image, &buffer[PROFILE_HEADER_SIZE], PROFILE_IMAGE_SIZE);
+    return true;
+}
+
+/**
+  * @name   profileSerialise
+  * @brief  A function which writes a profile in the binary profile format.
+  * @param  profile -> The profile to be serialised.
+  *         buffer  -> The array which will store the serialised profile.
+  *         length  -> The size of the buffer, at least PROFILE_SIZE bytes.
+  * @retval Number of bytes written to the buffer, 0 if the buffer is too small.
+  * @notes  None.
+  */
+size_t profileSerialise(const IQS7222_profile& profile, uint8_t buffer[], size_t length)
+{
+    if (length < PROFILE_SIZE)
+        return 0;
+
+    buffer[0] = PROFILE_MAGIC_0;
+    buffer[1] = PROFILE_MAGIC_1;
+    buffer[2] = PROFILE_MAGIC_2;
+    buffer[3] = PROFILE_MAGIC_3;
+    buffer[4] = PROFILE_VERSION;
+    buffer[5] = 0;
+    buffer[6] = PROFILE_IMAGE_SIZE & 0xFF;
+    buffer[7] = (PROFILE_IMAGE_SIZE & 0xFF00) >> 8;
+    memcpy(&buffer[PROFILE_HEADER_SIZE], profile.image, PROFILE_IMAGE_SIZE);
+
+    size_t crcOffset = PROFILE_HEADER_SIZE + PROFILE_IMAGE_SIZE;
+    uint16_t crc = profileCrc(buffer, crcOffset);
+    buffer[crcOffset] = crc & 0xFF;
+    buffer[crcOffset + 1] = (crc & 0xFF00) >> 8;
+
+    return PROFILE_SIZE;
+}
+
+/**
+  * @name   profileDiff
+  * @brief  A function which compares two profiles block by block.
+  * @param  first  -> The first profile to be compared.
+  *         second -> The second profile to be compared.
+  * @retval 32bit mask where bit n is set if block n of profileBlocks[] differs between the two profiles.
+  * @notes  None.
+  */
+uint32_t profileDiff(const IQS7222_profile& first, const IQS7222_profile& second)
+{
+    uint32_t diff = 0;
+
+    for (uint8_t i = 0; i < PROFILE_NUM_BLOCKS; i++)
+    {
+        const Profile_block& block = profileBlocks[i];
+        if (memcmp(&first.image[block.offset], &second.image[block.offset], block.length) != 0)
+            diff |= ((uint32_t)1 << i);
+    }
+    return diff;
+}
+
+#if defined(IQS7222_HAS_DEFAULT_PROFILE)
+/**
+  * @name   profileDefault
+  * @brief  A function which fills a profile with the settings of the initialisation header selected at compile time.
+  * @param  profile -> The profile which will receive the register image.
+  * @retval None.
+  * @notes  The initialisation header is the file exported by the Azoteq tuning software.
+  */
+void profileDefault(IQS7222_profile& profile)
+{
+    static const uint8_t defaultImage[PROFILE_IMAGE_SIZE] = {
+        CYCLE_0_CONV_FREQ_FRAC, CYCLE_0_CONV_FREQ_PERIOD, CYCLE_0_SETTINGS, CYCLE_0_CTX_SELECT, CYCLE_0_IREF_0, CYCLE_0_IREF_1,
+        CYCLE_1_CONV_FREQ_FRAC, CYCLE_1_CONV_FREQ_PERIOD, CYCLE_1_SETTINGS, CYCLE_1_CTX_SELECT, CYCLE_1_IREF_0, CYCLE_1_IREF_1,
+        CYCLE_2_CONV_FREQ_FRAC, CYCLE_2_CONV_FREQ_PERIOD, CYCLE_2_SETTINGS, CYCLE_2_CTX_SELECT, CYCLE_2_IREF_0, CYCLE_2_IREF_1,
+        CYCLE_3_CONV_FREQ_FRAC, CYCLE_3_CONV_FREQ_PERIOD, CYCLE_3_SETTINGS, CYCLE_3_CTX_SELECT, CYCLE_3_IREF_0, CYCLE_3_IREF_1,
+        CYCLE_4_CONV_FREQ_FRAC, CYCLE_4_CONV_FREQ_PERIOD, CYCLE_4_SETTINGS, CYCLE_4_CTX_SELECT, CYCLE_4_IREF_0, CYCLE_4_IREF_1,
+        GLOBAL_CYCLE_SETUP_0, GLOBAL_CYCLE_SETUP_1, COARSE_DIVIDER_PRELOAD, FINE_DIVIDER_PRELOAD, COMPENSATION_PRELOAD_0, COMPENSATION_PRELOAD_1,
+        BUTTON_0_PROX_THRESHOLD, BUTTON_0_ENTER_EXIT, BUTTON_0_TOUCH_THRESHOLD, BUTTON_0_TOUCH_HYSTERESIS, BUTTON_0_PROX_EVENT_TIMEOUT, BUTTON_0_TOUCH_EVENT_TIMEOUT,
+        BUTTON_1_PROX_THRESHOLD, BUTTON_1_ENTER_EXIT, BUTTON_1_TOUCH_THRESHOLD, BUTTON_1_TOUCH_HYSTERESIS, BUTTON_1_PROX_EVENT_TIMEOUT, BUTTON_1_TOUCH_EVENT_TIMEOUT,
+        BUTTON_2_PROX_THRESHOLD, BUTTON_2_ENTER_EXIT, BUTTON_2_TOUCH_THRESHOLD, BUTTON_2_TOUCH_HYSTERESIS, BUTTON_2_PROX_EVENT_TIMEOUT, BUTTON_2_TOUCH_EVENT_TIMEOUT,
+        BUTTON_3_PROX_THRESHOLD, BUTTON_3_ENTER_EXIT, BUTTON_3_TOUCH_THRESHOLD, BUTTON_3_TOUCH_HYSTERESIS, BUTTON_3_PROX_EVENT_TIMEOUT, BUTTON_3_TOUCH_EVENT_TIMEOUT,
+        BUTTON_4_PROX_THRESHOLD, BUTTON_4_ENTER_EXIT, BUTTON_4_TOUCH_THRESHOLD, BUTTON_4_TOUCH_HYSTERESIS, BUTTON_4_PROX_EVENT_TIMEOUT, BUTTON_4_TOUCH_EVENT_TIMEOUT,
+        BUTTON_5_PROX_THRESHOLD, BUTTON_5_ENTER_EXIT, BUTTON_5_TOUCH_THRESHOLD, BUTTON_5_TOUCH_HYSTERESIS, BUTTON_5_PROX_EVENT_TIMEOUT, BUTTON_5_TOUCH_EVENT_TIMEOUT,
+        BUTTON_6_PROX_THRESHOLD, BUTTON_6_ENTER_EXIT, BUTTON_6_TOUCH_THRESHOLD, BUTTON_6_TOUCH_HYSTERESIS, BUTTON_6_PROX_EVENT_TIMEOUT, BUTTON_6_TOUCH_EVENT_TIMEOUT,
+        BUTTON_7_PROX_THRESHOLD, BUTTON_7_ENTER_EXIT, BUTTON_7_TOUCH_THRESHOLD, BUTTON_7_TOUCH_HYSTERESIS, BUTTON_7_PROX_EVENT_TIMEOUT, BUTTON_7_TOUCH_EVENT_TIMEOUT,
+        BUTTON_8_PROX_THRESHOLD, BUTTON_8_ENTER_EXIT, BUTTON_8_TOUCH_THRESHOLD, BUTTON_8_TOUCH_HYSTERESIS, BUTTON_8_PROX_EVENT_TIMEOUT, BUTTON_8_TOUCH_EVENT_TIMEOUT,
+        BUTTON_9_PROX_THRESHOLD, BUTTON_9_ENTER_EXIT, BUTTON_9_TOUCH_THRESHOLD, BUTTON_9_TOUCH_HYSTERESIS, BUTTON_9_PROX_EVENT_TIMEOUT, BUTTON_9_TOUCH_EVENT_TIMEOUT,
+        CH0_SETUP_0, CH0_SETUP_1, CH0_ATI_SETTINGS_0, CH0_ATI_SETTINGS_1, CH0_MULTIPLIERS_0, CH0_MULTIPLIERS_1, CH0_ATI_COMPENSATION_0, CH0_ATI_COMPENSATION_1, CH0_REF_PTR_0, CH0_REF_PTR_1, CH0_REFMASK_0, CH0_REFMASK_1,
+        CH1_SETUP_0, CH1_SETUP_1, CH1_ATI_SETTINGS_0, CH1_ATI_SETTINGS_1, CH1_MULTIPLIERS_0, CH1_MULTIPLIERS_1, CH1_ATI_COMPENSATION_0, CH1_ATI_COMPENSATION_1, CH1_REF_PTR_0, CH1_REF_PTR_1, CH1_REFMASK_0, CH1_REFMASK_1,
+        CH2_SETUP_0, CH2_SETUP_1, CH2_ATI_SETTINGS_0, CH2_ATI_SETTINGS_1, CH2_MULTIPLIERS_0, CH2_MULTIPLIERS_1, CH2_ATI_COMPENSATION_0, CH2_ATI_COMPENSATION_1, CH2_REF_PTR_0, CH2_REF_PTR_1, CH2_REFMASK_0, CH2_REFMASK_1,
+        CH3_SETUP_0, CH3_SETUP_1, CH3_ATI_SETTINGS_0, CH3_ATI_SETTINGS_1, CH3_MULTIPLIERS_0, CH3_MULTIPLIERS_1, CH3_ATI_COMPENSATION_0, CH3_ATI_COMPENSATION_1, CH3_REF_PTR_0, CH3_REF_PTR_1, CH3_REFMASK_0, CH3_REFMASK_1,
+        CH4_SETUP_0, CH4_SETUP_1, CH4_ATI_SETTINGS_0, CH4_ATI_SETTINGS_1, CH4_MULTIPLIERS_0, CH4_MULTIPLIERS_1, CH4_ATI_COMPENSATION_0, CH4_ATI_COMPENSATION_1, CH4_REF_PTR_0, CH4_REF_PTR_1, CH4_REFMASK_0, CH4_REFMASK_1,
+        CH5_SETUP_0, CH5_SETUP_1, CH5_ATI_SETTINGS_0, CH5_ATI_SETTINGS_1, CH5_MULTIPLIERS_0, CH5_MULTIPLIERS_1, CH5_ATI_COMPENSATION_0, CH5_ATI_COMPENSATION_1, CH5_REF_PTR_0, CH5_REF_PTR_1, CH5_REFMASK_0, CH5_REFMASK_1,
+        CH6_SETUP_0, CH6_SETUP_1, CH6_ATI_SETTINGS_0, CH6_ATI_SETTINGS_1, CH6_MULTIPLIERS_0, CH6_MULTIPLIERS_1, CH6_ATI_COMPENSATION_0, CH6_ATI_COMPENSATION_1, CH6_REF_PTR_0, CH6_REF_PTR_1, CH6_REFMASK_0, CH6_REFMASK_1,
+        CH7_SETUP_0, CH7_SETUP_1, CH7_ATI_SETTINGS_0, CH7_ATI_SETTINGS_1, CH7_MULTIPLIERS_0, CH7_MULTIPLIERS_1, CH7_ATI_COMPENSATION_0, CH7_ATI_COMPENSATION_1, CH7_REF_PTR_0, CH7_REF_PTR_1, CH7_REFMASK_0, CH7_REFMASK_1,
+        CH8_SETUP_0, CH8_SETUP_1, CH8_ATI_SETTINGS_0, CH8_ATI_SETTINGS_1, CH8_MULTIPLIERS_0, CH8_MULTIPLIERS_1, CH8_ATI_COMPENSATION_0, CH8_ATI_COMPENSATION_1, CH8_REF_PTR_0, CH8_REF_PTR_1, CH8_REFMASK_0, CH8_REFMASK_1,
+        CH9_SETUP_0, CH9_SETUP_1, CH9_ATI_SETTINGS_0, CH9_ATI_SETTINGS_1, CH9_MULTIPLIERS_0, CH9_MULTIPLIERS_1, CH9_ATI_COMPENSATION_0, CH9_ATI_COMPENSATION_1, CH9_REF_PTR_0, CH9_REF_PTR_1, CH9_REFMASK_0, CH9_REFMASK_1,
+        COUNTS_BETA_FILTER, LTA_BETA_FILTER, LTA_FAST_BETA_FILTER, RESERVED_FILTER_0,
+        SLIDER0SETUP_GENERAL, SLIDER0_LOWER_CAL, SLIDER0_UPPER_CAL, SLIDER0_BOTTOM_SPEED, SLIDER0_TOPSPEED_0, SLIDER0_TOPSPEED_1, SLIDER0_RESOLUTION_0, SLIDER0_RESOLUTION_1, SLIDER0_ENABLE_MASK_0_7, SLIDER0_ENABLE_MASK_8_9, SLIDER0_ENABLESTATUSLINK_0, SLIDER0_ENABLESTATUSLINK_1, SLIDER0_DELTA0_0, SLIDER0_DELTA0_1, SLIDER0_DELTA1_0, SLIDER0_DELTA1_1, SLIDER0_DELTA2_0, SLIDER0_DELTA2_1, SLIDER0_DELTA3_0, SLIDER0_DELTA3_1,
+        SLIDER1SETUP_GENERAL, SLIDER1_LOWER_CAL, SLIDER1_UPPER_CAL, SLIDER1_BOTTOM_SPEED, SLIDER1_TOPSPEED_0, SLIDER1_TOPSPEED_1, SLIDER1_RESOLUTION_0, SLIDER1_RESOLUTION_1, SLIDER1_ENABLE_MASK_0_7, SLIDER1_ENABLE_MASK_8_9, SLIDER1_ENABLESTATUSLINK_0, SLIDER1_ENABLESTATUSLINK_1, SLIDER1_DELTA0_0, SLIDER1_DELTA0_1, SLIDER1_DELTA1_0, SLIDER1_DELTA1_1, SLIDER1_DELTA2_0, SLIDER1_DELTA2_1, SLIDER1_DELTA3_0, SLIDER1_DELTA3_1,
+        GPIO0_SETUP_0, GPIO0_SETUP_1, ENABLE_MASK_0_7, ENABLE_MASK_8_9, ENABLESTATUSLINK_0, ENABLESTATUSLINK_1,
+        SYSTEM_CONTROL_0, SYSTEM_CONTROL_1, ATI_ERROR_TIMEOUT_0, ATI_ERROR_TIMEOUT_1, ATI_REPORT_RATE_0, ATI_REPORT_RATE_1, NORMAL_MODE_TIMEOUT_0, NORMAL_MODE_TIMEOUT_1, NORMAL_MODE_REPORT_RATE_0, NORMAL_MODE_REPORT_RATE_1, LP_MODE_TIMEOUT_0, LP_MODE_TIMEOUT_1, LP_MODE_REPORT_RATE_0, LP_MODE_REPORT_RATE_1, ULP_MODE_TIMEOUT_0, ULP_MODE_TIMEOUT_1, ULP_MODE_REPORT_RATE_0, ULP_MODE_REPORT_RATE_1, TOUCH_PROX_EVENT_MASK, POWER_ATI_EVENT_MASK, I2CCOMMS_0
+    };
+
+    memcpy(profile.image, defaultImage, PROFILE_IMAGE_SIZE);
+}
+#endif
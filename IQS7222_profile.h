@@ -0,0 +1,91 @@
+/**
+  **********************************************************************************
+  * @file     IQS7222_profile.h
+  * @author   Colin Laganier
+  * @version  V0.1
+  * @date     2026-10-18
+  * @brief   This file contains the binary configuration profile format used to load
+  *          the IQS7222 register settings at runtime instead of selecting a single
+  *          initialisation header at compile time.
+  **********************************************************************************
+  * @attention  A serialised profile is laid out as follows (multi-byte fields are little endian):
+  *             Byte 0-3   : Magic "IQ72"
+  *             Byte 4     : Format version (PROFILE_VERSION)
+  *             Byte 5     : Reserved, written as 0
+  *             Byte 6-7   : Register image length (PROFILE_IMAGE_SIZE)
+  *             Byte 8-294 : Register image, blocks in the order of profileBlocks[]
+  *             Byte 295-296: CRC-16/CCITT of bytes 0-294
+  */
+
+#ifndef IQS7222_PROFILE_H
+#define IQS7222_PROFILE_H
+
+// Include Files
+#include "Arduino.h"
+#include "IQS7222_addresses.h"
+
+// Profile format
+#define PROFILE_MAGIC_0 'I'
+#define PROFILE_MAGIC_1 'Q'
+#define PROFILE_MAGIC_2 '7'
+#define PROFILE_MAGIC_3 '2'
+#define PROFILE_VERSION 1
+#define PROFILE_HEADER_SIZE 8
+#define PROFILE_CRC_SIZE 2
+#define PROFILE_NUM_BLOCKS 31
+#define PROFILE_IMAGE_SIZE 287
+#define PROFILE_SIZE (PROFILE_HEADER_SIZE + PROFILE_IMAGE_SIZE + PROFILE_CRC_SIZE)
+
+// Image offsets of the blocks that are referenced by the driver
+#define PROFILE_CYCLE_OFFSET 0
+#define PROFILE_GLOBAL_CYCLE_OFFSET 30
+#define PROFILE_BUTTON_OFFSET 36
+#define PROFILE_CHANNEL_OFFSET 96
+#define PROFILE_FILTER_OFFSET 216
+#define PROFILE_SLIDER_OFFSET 220
+#define PROFILE_GPIO_OFFSET 260
+#define PROFILE_SYSTEM_OFFSET 266
+#define PROFILE_CYCLE_SIZE 6
+#define PROFILE_CYCLE_FREQ_FRAC 0	// Byte offsets within a cycle setup block
+#define PROFILE_CYCLE_FREQ_PERIOD 1
+#define PROFILE_CYCLE_SETTINGS 2
+#define PROFILE_CYCLE_CTX_SELECT 3
+#define PROFILE_BUTTON_SIZE 6
+#define PROFILE_CHANNEL_SIZE 12
+#define PROFILE_SLIDER_SIZE 20
+
+// Index in profileBlocks[] of the first button setup block
+#define PROFILE_BUTTON_BLOCK 6
+// Index in profileBlocks[] of the first channel setup block, channel n is at PROFILE_CHANNEL_BLOCK + n
+#define PROFILE_CHANNEL_BLOCK 16
+#define PROFILE_NUM_CHANNELS 10
+
+// Default profile is only available when an initialisation header has been included
+#if defined(IQS7222C_INIT_H)
+#define IQS7222_HAS_DEFAULT_PROFILE
+#endif
+
+// Contiguous register block written with a single burst
+typedef struct {
+	uint16_t address;	// Register address of the first word in the block
+	uint8_t length;		// Number of bytes in the block
+	uint16_t offset;	// Offset of the block in the register image
+} Profile_block;
+
+// Register image holding every setting written by the initial setup
+typedef struct {
+	uint8_t image[PROFILE_IMAGE_SIZE];
+} IQS7222_profile;
+
+extern const Profile_block profileBlocks[PROFILE_NUM_BLOCKS];
+
+uint16_t profileCrc(const uint8_t buffer[], size_t length);
+bool profileValidate(const uint8_t buffer[], size_t length);
+bool profileLoad(const uint8_t buffer[], size_t length, IQS7222_profile& profile);
+size_t profileSerialise(const IQS7222_profile& profile, uint8_t buffer[], size_t length);
+uint32_t profileDiff(const IQS7222_profile& first, const IQS7222_profile& second);
+#if defined(IQS7222_HAS_DEFAULT_PROFILE)
+void profileDefault(IQS7222_profile& profile);
+#endif
+
+#endif // IQS7222_PROFILE_H
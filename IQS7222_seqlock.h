@@ -0,0 +1,96 @@
+/**
+  **********************************************************************************
+  * @file     IQS7222_seqlock.h
+  * @author   Colin Laganier
+  * @version  V0.1
+  * @date     2026-10-18
+  * @brief   This file contains a sequence counted double buffer which publishes a value
+  *          from one writer to any number of lock-free readers.
+  **********************************************************************************
+  * @attention  The writer updates the two copies in turn and the sequence counter tells the
+  *             readers which copy is stable, so a reader never waits for the writer and only
+  *             copies again if a whole update completed during its copy. Readers may run in an
+  *             interrupt which preempted the writer, or in another thread. There must be a
+  *             single writer. The counter is one byte on AVR so that it is read atomically,
+  *             a reader would have to be preempted by 128 updates to be misled.
+  */
+
+#ifndef IQS7222_SEQLOCK_H
+#define IQS7222_SEQLOCK_H
+
+// Include Files
+#include "Arduino.h"
+
+// Sequence counter, read and written in a single access
+#if defined(__AVR__)
+typedef uint8_t Seqlock_count;
+#else
+typedef uint32_t Seqlock_count;
+#endif
+
+// Orders the accesses to the counter and the copies, for the compiler and the CPU
+#define SEQLOCK_BARRIER() __sync_synchronize()
+
+template <typename T>
+class Seqlock
+{
+public:
+	/**
+	  * @name   update
+	  * @brief  Method which applies a change to both copies of the value.
+	  * @param  apply -> Callable taking a T&, called once per copy, must make the same change to both.
+	  * @retval None.
+	  * @notes  Readers take the copy which is not being changed, an update never waits.
+	  */
+	template <typename F>
+	void update(F apply)
+	{
+		_sequence = _sequence + 1;
+		SEQLOCK_BARRIER();
+		apply(_copies[0]);
+		SEQLOCK_BARRIER();
+		_sequence = _sequence + 1;
+		SEQLOCK_BARRIER();
+		apply(_copies[1]);
+		SEQLOCK_BARRIER();
+	}
+
+	/**
+	  * @name   read
+	  * @brief  Method which copies a consistent value.
+	  * @param  value -> Receives the value.
+	  * @retval Number of updates published so far, modulo the counter size.
+	  * @notes  The copy is repeated only if an update was published while it was taken.
+	  */
+	Seqlock_count read(T& value) const
+	{
+		Seqlock_count sequence;
+
+		do
+		{
+			sequence = _sequence;
+			SEQLOCK_BARRIER();
+			value = _copies[sequence & 0x01];
+			SEQLOCK_BARRIER();
+		} while (sequence != _sequence);
+		return sequence >> 1;
+	}
+
+	/**
+	  * @name   version
+	  * @brief  Method which returns the number of updates published so far.
+	  * @param  None.
+	  * @retval Number of updates, modulo the counter size.
+	  * @notes  Compare with the value returned by read to skip copying an unchanged value.
+	  */
+	Seqlock_count version(void) const
+	{
+		return _sequence >> 1;
+	}
+
+private:
+	volatile Seqlock_count _sequence = 0;
+	T _copies[2] = {};
+};
+
+#endif // IQS7222_SEQLOCK_H
@@ -0,0 +1,47 @@
+/**
+  **********************************************************************************
+  * @file     IQS7222_stats.h
+  * @author   Colin Laganier
+  * @version  V0.1
+  * @date     2026-10-18
+  * @brief   This file contains the optional instrumentation of the IQS7222 library:
+  *          operation counters and log2 latency histograms of the bus and decode paths.
+  **********************************************************************************
+  * @attention  Define IQS7222_ENABLE_STATS to compile the instrumentation in, every hook
+  *             expands to nothing otherwise. The hooks are defined in IQS7222_trace.h.
+  */
+
+#ifndef IQS7222_STATS_H
+#define IQS7222_STATS_H
+
+// Include Files
+#include "Arduino.h"
+
+// Number of log2 buckets per histogram, bucket n counts durations in [2^n, 2^(n+1)) probe clock ticks
+#define STATS_NUM_BUCKETS 16
+
+// Latency histograms
+typedef enum {
+	HIST_RDY_WAIT = 0,		// Time spent in requestComms waiting for the RDY window
+	HIST_TRANSACTION = 1,	// Time spent in a single I2C read or write
+	HIST_DECODE = 2,		// Time spent decoding flags and counts into driver state
+	HIST_GESTURE = 3,		// Time spent in the gesture recognition
+	HIST_COUNT = 4
+} STATS_HISTOGRAM;
+
+typedef struct {
+	uint32_t rdyRequests;	// Number of communication requests
+	uint32_t rdyTimeouts;	// Number of requests without a response from the device
+	uint32_t reads;			// Number of read transactions
+	uint32_t writes;		// Number of write transactions
+	uint32_t readRetries;	// Number of additional requestFrom attempts needed by the reads
+	uint32_t bytesRead;		// Number of payload bytes read
+	uint32_t bytesWritten;	// Number of payload bytes written
+	uint32_t resets;		// Number of device resets detected in the read path
+	uint32_t pollAttempts;	// Number of headless polls, see pollReport
+	uint32_t pollMisses;	// Number of headless polls not acknowledged by the device
+	uint32_t recoveryTime;	// Probe clock ticks taken by the last reset recovery
+	uint32_t histogram[HIST_COUNT][STATS_NUM_BUCKETS];
+} IQS7222_stats;
+
+#endif // IQS7222_STATS_H
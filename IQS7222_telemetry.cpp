@@ -0,0 +1,391 @@
+/**
+  **********************************************************************************
+  * @file     IQS7222_telemetry.cpp
+  * @author   Colin Laganier
+  * @version  V0.1
+  * @date     2026-10-18
+  * @brief   This file contains the encoder and the block decoder of the telemetry log.
+  **********************************************************************************
+  * @attention  Requires standard Arduino Libraries: Arduino.h. The file does not depend on the
+  *             driver so that host tools can decode logs with it.
+  */
+
+  // Include Files
+#include "IQS7222_telemetry.h"
+
+/**************************************************************************************************************/
+/*                                              PRIVATE FUNCTIONS                                             */
+/**************************************************************************************************************/
+
+/**
+  * @name   writeVarint
+  * @brief  Writes a value with 7 bits per byte, least significant first, the top bit set on all but the last byte.
+  * @param  out   -> Receives up to 5 bytes.
+  *         value -> The value to write.
+  * @retval Number of bytes written.
+  * @notes  None.
+  */
+static uint8_t writeVarint(uint8_t out[], uint32_t value)
+{
+    uint8_t length = 0;
+
+    while (value >= 0x80)
+    {
+        out[length++] = (uint8_t)value | 0x80;
+        value >>= 7;
+    }
+    out[length++] = (uint8_t)value;
+    return length;
+}
+
+/**
+  * @name   readVarint
+  * @brief  Reads a value written by writeVarint.
+  * @param  data  -> Position of the value, moved past it.
+  *         end   -> End of the data.
+  *         value -> Receives the value.
+  * @retval False if the value runs past the end of the data or is longer than 5 bytes.
+  * @notes  None.
+  */
+static inline bool readVarint(const uint8_t*& data, const uint8_t* end, uint32_t& value)
+{
+    uint8_t shift = 0;
+
+    if ((data < end) && !(*data & 0x80))
+    {
+        value = *data++;
+        return true;
+    }
+
+    value = 0;
+    while ((data < end) && (shift < 35))
+    {
+        uint8_t byte = *data++;
+        value |= (uint32_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80))
+            return true;
+        shift += 7;
+    }
+    return false;
+}
+
+// Maps signed values to unsigned ones of the same magnitude, 0, -1, 1, -2... to 0, 1, 2, 3...
+static inline uint32_t zigzag(int32_t value)
+{
+    return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+static inline int32_t unzigzag(uint32_t value)
+{
+    return (int32_t)(value >> 1) ^ -(int32_t)(value & 0x01);
+}
+
+#if defined(TELEMETRY_CRC_TABLES)
+// entries[k][b] is the CRC, from 0, of byte b followed by k zero bytes
+typedef struct Crc_tables {
+    uint16_t entries[8][256];
+
+    Crc_tables()
+    {
+        for (uint16_t b = 0; b < 256; b++)
+        {
+            uint16_t crc = b << 8;
+            for (uint8_t bit = 0; bit < 8; bit++)
+                crc = (crc & 0x8000) ? ((crc << 1) ^ 0x1021) : (crc << 1);
+            entries[0][b] = crc;
+        }
+        for (uint8_t k = 1; k < 8; k++)
+        {
+            for (uint16_t b = 0; b < 256; b++)
+                entries[k][b] = (entries[k - 1][b] << 8) ^ entries[0][entries[k - 1][b] >> 8];
+        }
+    }
+} Crc_tables;
+#endif
+
+static inline void writeLe16(uint8_t out[], uint16_t value)
+{
+    out[0] = (uint8_t)value;
+    out[1] = (uint8_t)(value >> 8);
+}
+
+static inline uint16_t readLe16(const uint8_t data[])
+{
+    return data[0] | ((uint16_t)data[1] << 8);
+}
+
+/**************************************************************************************************************/
+/*                                              PUBLIC METHODS                                                */
+/**************************************************************************************************************/
+
+/**
+  * @name   begin
+  * @brief  Method to start a log on a sink.
+  * @param  sink -> Destination of the blocks, must outlive the encoder.
+  * @retval None.
+  * @notes  The time of the log starts at 0 with the first frame appended.
+  */
+void Telemetry_encoder::begin(Telemetry_sink& sink)
+{
+    _sink = &sink;
+    _used = 0;
+    _frames = 0;
+    _time = 0;
+    _started = false;
+    _sequence = 0;
+    _lost = 0;
+}
+
+/**
+  * @name   append
+  * @brief  Method to add a frame to the log.
+  * @param  time   -> micros() when the values were read, e.g. Sensor_snapshot::readTick.
+  *         values -> TELEMETRY_NUM_VALUES values, see TELEMETRY_COUNTS and TELEMETRY_LTA.
+  * @retval False if the log is not started or a full block could not be written to the sink.
+  * @notes  The frame is encoded into the block in RAM, the block is written to the sink when the next frame does not
+  *         fit and a new block starts with that frame as keyframe. With counts changing by a few units per report a
+  *         frame of 10 channels takes about 14 bytes instead of 44. The time wraps with micros(), appending at least
+  *         once every 71 minutes keeps it unwrapped.
+  */
+bool Telemetry_encoder::append(uint32_t time, const uint16_t values[])
+{
+    uint8_t frame[TELEMETRY_MAX_FRAME_SIZE];
+    uint8_t length;
+    uint32_t interval;
+    uint32_t mask = 0;
+    bool stored = true;
+
+    if (_sink == NULL)
+        return false;
+
+    interval = _started ? (time - _lastTick) : 0;
+    _time += interval;
+    _lastTick = time;
+    _started = true;
+
+    if (_frames == 0)
+    {
+        startBlock(values);
+        return true;
+    }
+
+    for (uint8_t i = 0; i < TELEMETRY_NUM_VALUES; i++)
+    {
+        if (values[i] != _previous[i])
+            mask |= 1UL << i;
+    }
+
+    length = writeVarint(frame, zigzag((int32_t)(interval - _interval)));
+    length += writeVarint(&frame[length], mask);
+    for (uint8_t i = 0; i < TELEMETRY_NUM_VALUES; i++)
+    {
+        if (mask & (1UL << i))
+            length += writeVarint(&frame[length], zigzag((int16_t)(values[i] - _previous[i])));
+    }
+
+    if ((_used + length) > TELEMETRY_BLOCK_SIZE)
+    {
+        stored = flush();
+        startBlock(values);
+        return stored;
+    }
+
+    memcpy(&_block[_used], frame, length);
+    memcpy(_previous, values, sizeof(_previous));
+    _used += length;
+    _frames++;
+    _interval = interval;
+    return true;
+}
+
+/**
+  * @name   flush
+  * @brief  Method to write the block in progress to the sink.
+  * @param  None.
+  * @retval False if the sink did not store the block.
+  * @notes  The unused end of the block is zeroed. Call before the storage is removed or powered down, the frames of
+  *         the block in progress are lost otherwise. The next frame starts a new block. A block the sink fails to store
+  *         keeps its sequence number, so the decoder counts the gap as a lost block. A sink which failed part way
+  *         through leaves the next blocks shifted, the decoder finds them by their headers.
+  */
+bool Telemetry_encoder::flush(void)
+{
+    bool stored;
+
+    if ((_sink == NULL) || (_frames == 0))
+        return true;
+
+    writeLe16(&_block[6], _frames);
+    writeLe16(&_block[8], _used - TELEMETRY_HEADER_SIZE);
+    writeLe16(&_block[10], telemetryCrc(&_block[TELEMETRY_HEADER_SIZE], _used - TELEMETRY_HEADER_SIZE));
+    memset(&_block[_used], 0, TELEMETRY_BLOCK_SIZE - _used);
+
+    stored = _sink->write(_block, TELEMETRY_BLOCK_SIZE);
+    if (!stored)
+        _lost++;
+    _sequence++;
+    _frames = 0;
+    return stored;
+}
+
+/**************************************************************************************************************/
+/*                                              PRIVATE METHODS                                               */
+/**************************************************************************************************************/
+
+/**
+ * @name    startBlock
+ * @brief   A method which starts a block with a keyframe.
+ * @param   values -> The values of the keyframe, the time is the time of the last frame appended.
+ * @retval  None.
+ * @notes   The frame count, payload size and CRC of the header are written by flush.
+ */
+void Telemetry_encoder::startBlock(const uint16_t values[])
+{
+    writeLe16(&_block[0], TELEMETRY_MAGIC);
+    _block[2] = TELEMETRY_VERSION;
+    _block[3] = TELEMETRY_NUM_VALUES;
+    writeLe16(&_block[4], TELEMETRY_BLOCK_SIZE);
+    writeLe16(&_block[6], 0);
+    writeLe16(&_block[8], 0);
+    writeLe16(&_block[10], 0);
+    for (uint8_t i = 0; i < 4; i++)
+        _block[12 + i] = (uint8_t)(_sequence >> (8 * i));
+    for (uint8_t i = 0; i < 8; i++)
+        _block[16 + i] = (uint8_t)(_time >> (8 * i));
+
+    for (uint8_t i = 0; i < TELEMETRY_NUM_VALUES; i++)
+        writeLe16(&_block[TELEMETRY_HEADER_SIZE + 2 * i], values[i]);
+
+    memcpy(_previous, values, sizeof(_previous));
+    _used = TELEMETRY_HEADER_SIZE + 2 * TELEMETRY_NUM_VALUES;
+    _frames = 1;
+    _interval = 0;
+}
+
+/**************************************************************************************************************/
+/*                                                FUNCTIONS                                                   */
+/**************************************************************************************************************/
+
+/**
+  * @name   telemetryCrc
+  * @brief  Computes the CRC-16/CCITT-FALSE of a payload.
+  * @param  data   -> The bytes to check.
+  *         length -> Number of bytes.
+  * @retval The CRC, polynomial 0x1021 and initial value 0xFFFF.
+  * @notes  Computed a byte at a time without a table on MCUs. With TELEMETRY_CRC_TABLES, 8 bytes at a time with
+  *         the tables of crcTables, a decoder would otherwise spend most of its time checking CRCs.
+  */
+uint16_t telemetryCrc(const uint8_t data[], size_t length)
+{
+    uint16_t crc = 0xFFFF;
+    size_t i = 0;
+
+#if defined(TELEMETRY_CRC_TABLES)
+    static const Crc_tables tables;
+
+    for (; (i + 8) <= length; i += 8)
+    {
+        crc = tables.entries[7][data[i] ^ (crc >> 8)] ^ tables.entries[6][data[i + 1] ^ (uint8_t)crc]
+            ^ tables.entries[5][data[i + 2]] ^ tables.entries[4][data[i + 3]] ^ tables.entries[3][data[i + 4]]
+            ^ tables.entries[2][data[i + 5]] ^ tables.entries[1][data[i + 6]] ^ tables.entries[0][data[i + 7]];
+    }
+#endif
+
+    for (; i < length; i++)
+    {
+        uint8_t x = (uint8_t)(crc >> 8) ^ data[i];
+        x ^= x >> 4;
+        crc = (crc << 8) ^ ((uint16_t)x << 12) ^ ((uint16_t)x << 5) ^ x;
+    }
+    return crc;
+}
+
+/**
+  * @name   telemetryReadHeader
+  * @brief  Reads and checks the header of a block.
+  * @param  block  -> The block.
+  *         length -> Bytes available from block.
+  *         header -> Receives the header.
+  * @retval False if the magic or the version do not match, a frame has no values, or the sizes are not consistent with
+  *         length.
+  * @notes  The CRC of the payload is checked by telemetryDecodeBlock. A block never written reads as zeros and fails.
+  */
+bool telemetryReadHeader(const uint8_t block[], size_t length, Telemetry_header& header)
+{
+    if ((length < TELEMETRY_HEADER_SIZE) || (readLe16(&block[0]) != TELEMETRY_MAGIC))
+        return false;
+
+    header.version = block[2];
+    header.numValues = block[3];
+    header.blockSize = readLe16(&block[4]);
+    header.frames = readLe16(&block[6]);
+    header.payloadSize = readLe16(&block[8]);
+    header.crc = readLe16(&block[10]);
+    header.sequence = 0;
+    for (uint8_t i = 0; i < 4; i++)
+        header.sequence |= (uint32_t)block[12 + i] << (8 * i);
+    header.time = 0;
+    for (uint8_t i = 0; i < 8; i++)
+        header.time |= (uint64_t)block[16 + i] << (8 * i);
+
+    return (header.version == TELEMETRY_VERSION) && (header.numValues != 0) && (header.numValues <= TELEMETRY_MAX_VALUES)
+        && (header.blockSize <= length) && ((header.payloadSize + TELEMETRY_HEADER_SIZE) <= header.blockSize)
+        && (header.payloadSize >= 2 * header.numValues) && (header.frames != 0);
+}
+
+/**
+  * @name   telemetryDecodeBlock
+  * @brief  Decodes the frames of a block.
+  * @param  block     -> The block.
+  *         length    -> Bytes available from block.
+  *         frames    -> Receives the frames.
+  *         maxFrames -> Size of frames, a block holds at most 1 + (blockSize - TELEMETRY_HEADER_SIZE) / 2 frames.
+  * @retval Number of frames decoded, 0 if the header or the CRC is not valid.
+  * @notes  The values of a log written with another layout are decoded too, the first header.numValues of each frame
+  *         are set and the others are 0. Decoding stops early at maxFrames or if the payload is truncated.
+  */
+uint16_t telemetryDecodeBlock(const uint8_t block[], size_t length, Telemetry_frame frames[], uint16_t maxFrames)
+{
+    Telemetry_header header;
+    const uint8_t* data;
+    const uint8_t* end;
+    uint32_t interval = 0;
+    uint16_t count;
+
+    if ((maxFrames == 0) || !telemetryReadHeader(block, length, header))
+        return 0;
+
+    data = &block[TELEMETRY_HEADER_SIZE];
+    end = data + header.payloadSize;
+    if (telemetryCrc(data, header.payloadSize) != header.crc)
+        return 0;
+
+    frames[0].time = header.time;
+    memset(frames[0].values, 0, sizeof(frames[0].values));
+    for (uint8_t i = 0; i < header.numValues; i++)
+        frames[0].values[i] = readLe16(&data[2 * i]);
+    data += 2 * header.numValues;
+
+    for (count = 1; (count < header.frames) && (count < maxFrames); count++)
+    {
+        Telemetry_frame& frame = frames[count];
+        uint32_t change;
+        uint32_t mask;
+
+        if (!readVarint(data, end, change) || !readVarint(data, end, mask) || (mask >> 1 >> (header.numValues - 1)))
+            break;
+        interval += (uint32_t)unzigzag(change);
+        frame.time = frames[count - 1].time + interval;
+        memcpy(frame.values, frames[count - 1].values, sizeof(frame.values));
+
+        while (mask)
+        {
+            uint8_t i = __builtin_ctzl(mask);
+            mask &= mask - 1;
+            if (!readVarint(data, end, change))
+                return count;
+            frame.values[i] += (uint16_t)unzigzag(change);
+        }
+    }
+    return count;
+}
@@ -0,0 +1,140 @@
+/**
+  **********************************************************************************
+  * @file     IQS7222_telemetry.h
+  * @author   Colin Laganier
+  * @version  V0.1
+  * @date     2026-10-18
+  * @brief   This file contains the compact telemetry log which records the flags, counts
+  *          and LTA of every channel at the report rate.
+  **********************************************************************************
+  * @attention  A log is a sequence of fixed size blocks, each one self-contained: a header,
+  *             a keyframe holding every value and then frames holding the zigzag/varint
+  *             encoded change of each value from the previous frame. Block n starts at
+  *             n * blockSize and the headers carry the time of their keyframe, so the blocks
+  *             are their own index: a reader seeks by a binary search over the headers and
+  *             decodes the blocks independently. Blocks are written whole, aligned to the
+  *             sectors of an SD card or the pages of a flash. A decoder for host builds is
+  *             in utils/telemetry_decode.cpp.
+  *
+  *             Block header, little endian:
+  *               0  magic 'T' 'L'        2  version        3  values per frame
+  *               4  block size           6  frames         8  payload bytes
+  *               10 CRC-16 of payload    12 block sequence 16 keyframe time (64bit, us)
+  *             Keyframe: every value as 16bit little endian.
+  *             Frame: varint(zigzag(interval - previous interval)), varint(mask of the changed
+  *                    values), varint(zigzag(change)) of each value in the mask.
+  */
+
+#ifndef IQS7222_TELEMETRY_H
+#define IQS7222_TELEMETRY_H
+
+// Include Files
+#include "Arduino.h"
+#include "IQS7222_layout.h"
+
+// Log parameters
+#if !defined(TELEMETRY_BLOCK_SIZE)
+#define TELEMETRY_BLOCK_SIZE 512		// Bytes per block, one SD sector
+#endif
+#define TELEMETRY_MAGIC 0x4C54			// "TL"
+#define TELEMETRY_VERSION 1
+#define TELEMETRY_HEADER_SIZE 24
+#define TELEMETRY_MAX_VALUES 32			// Limited by the 32bit mask of changed values
+
+// Host builds check the CRC with 8 lookup tables (4 kB), MCUs a byte at a time without RAM
+#if !defined(TELEMETRY_CRC_TABLES) && (defined(__linux__) || defined(_WIN32) || defined(__APPLE__))
+#define TELEMETRY_CRC_TABLES
+#endif
+
+// Values of a frame: the proximity and touch flags, then the counts and the LTA of each channel
+#define TELEMETRY_PROX_FLAGS 0
+#define TELEMETRY_TOUCH_FLAGS 1
+#define TELEMETRY_COUNTS(channel) (2 + (channel))
+#define TELEMETRY_LTA(channel) (2 + IQS7222_NUM_CHANNELS + (channel))
+#define TELEMETRY_NUM_VALUES (2 + 2 * IQS7222_NUM_CHANNELS)
+
+// Largest encoded frame: interval, mask, then 3 bytes per value
+#define TELEMETRY_MAX_FRAME_SIZE (5 + 5 + 3 * TELEMETRY_NUM_VALUES)
+
+static_assert(TELEMETRY_NUM_VALUES <= TELEMETRY_MAX_VALUES, "A frame holds at most 32 values");
+static_assert(TELEMETRY_BLOCK_SIZE >= TELEMETRY_HEADER_SIZE + 2 * TELEMETRY_NUM_VALUES + TELEMETRY_MAX_FRAME_SIZE,
+	"A block must hold a keyframe and a frame");
+
+// Destination of the blocks, e.g. a file on an SD card
+class Telemetry_sink
+{
+public:
+	// Public methods
+	// Writes one whole block, returns false if it was not stored
+	virtual bool write(const uint8_t data[], size_t length) = 0;
+};
+
+// Sink on any type with write(const uint8_t*, size_t), e.g. File or Serial
+template <typename T>
+class Telemetry_stream_sink : public Telemetry_sink
+{
+public:
+	// Public constructor
+	Telemetry_stream_sink(T& stream) : _stream(stream) {}
+
+	// Public methods
+	bool write(const uint8_t data[], size_t length) override
+	{
+		return _stream.write(data, length) == length;
+	}
+
+private:
+	// Private variables
+	T& _stream;
+};
+
+class Telemetry_encoder
+{
+public:
+	// Public methods
+	void begin(Telemetry_sink& sink);
+	bool append(uint32_t time, const uint16_t values[]);
+	bool flush(void);
+	uint32_t blocksWritten(void) const { return _sequence - _lost; }
+	uint32_t blocksLost(void) const { return _lost; }
+
+private:
+	// Private methods
+	void startBlock(const uint16_t values[]);
+
+	// Private variables
+	Telemetry_sink* _sink = NULL;
+	uint8_t _block[TELEMETRY_BLOCK_SIZE];
+	uint16_t _used = 0;				// Bytes of the block used, header included
+	uint16_t _frames = 0;			// Frames in the block, 0 if no block is started
+	uint16_t _previous[TELEMETRY_NUM_VALUES];
+	uint64_t _time = 0;				// Time of the last frame, unwrapped
+	uint32_t _lastTick = 0;			// micros() of the last frame
+	uint32_t _interval = 0;			// Time between the last two frames
+	uint32_t _sequence = 0;			// Blocks completed, stored or lost
+	uint32_t _lost = 0;				// Blocks the sink failed to store
+	bool _started = false;			// A frame was appended since begin
+};
+
+// Block header, see the layout above
+typedef struct {
+	uint8_t version;
+	uint8_t numValues;
+	uint16_t blockSize;
+	uint16_t frames;
+	uint16_t payloadSize;
+	uint16_t crc;
+	uint32_t sequence;
+	uint64_t time;
+} Telemetry_header;
+
+typedef struct {
+	uint64_t time;		// Microseconds since the log was started
+	uint16_t values[TELEMETRY_MAX_VALUES];
+} Telemetry_frame;
+
+uint16_t telemetryCrc(const uint8_t data[], size_t length);
+bool telemetryReadHeader(const uint8_t block[], size_t length, Telemetry_header& header);
+uint16_t telemetryDecodeBlock(const uint8_t block[], size_t length, Telemetry_frame frames[], uint16_t maxFrames);
+
+#endif // IQS7222_TELEMETRY_H
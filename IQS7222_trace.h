@@ -0,0 +1,69 @@
+/**
+  **********************************************************************************
+  * @file     IQS7222_trace.h
+  * @author   Colin Laganier
+  * @version  V0.1
+  * @date     2026-10-18
+  * @brief   This file contains the optional timing trace of the IQS7222 library and the
+  *          probe hooks shared with the instrumentation counters.
+  **********************************************************************************
+  * @attention  Define IQS7222_ENABLE_TRACE to record every RDY window, I2C transaction,
+  *             decode step and gesture decision as a span in a ring buffer. The spans can
+  *             be drained with readTrace, written as raw bytes to any stream and converted
+  *             to Chrome trace / Perfetto JSON with utils/trace_to_perfetto.py.
+  *             Define IQS7222_PROBE_CLOCK before including the library to use another time
+  *             base, e.g. the DWT cycle counter on Cortex-M, micros() is used by default.
+  */
+
+#ifndef IQS7222_TRACE_H
+#define IQS7222_TRACE_H
+
+// Include Files
+#include "Arduino.h"
+#include "IQS7222_stats.h"
+
+// Number of spans kept in the ring buffer, the oldest spans are overwritten
+#ifndef TRACE_DEPTH
+#define TRACE_DEPTH 64
+#endif
+
+// Time base of the probes
+#ifndef IQS7222_PROBE_CLOCK
+#define IQS7222_PROBE_CLOCK() micros()
+#endif
+
+// Operations recorded by the probes
+typedef enum {
+	PROBE_RDY_WAIT = 0,		// Communication request until the RDY window opens
+	PROBE_READ = 1,			// I2C read transaction
+	PROBE_WRITE = 2,		// I2C write transaction
+	PROBE_DECODE = 3,		// Decoding of the read bytes into driver state
+	PROBE_GESTURE = 4,		// Gesture recognition
+	PROBE_SETUP = 5			// Write of the full initial configuration
+} PROBE_OP;
+
+// Span stored in the ring buffer, 12 bytes with no padding on 8bit and 32bit targets
+typedef struct {
+	uint32_t begin;		// Probe clock at the start of the operation
+	uint32_t end;		// Probe clock at the end of the operation
+	uint16_t address;	// Register address of the transaction, 0 for other operations
+	uint8_t op;			// Operation, see PROBE_OP
+	uint8_t length;		// Number of bytes transferred, 0 for other operations
+} Trace_span;
+
+#if defined(IQS7222_ENABLE_STATS) || defined(IQS7222_ENABLE_TRACE)
+// Probe hooks, only usable inside IQS7222 methods
+#define IQS7222_PROBE_START(name) uint32_t name = IQS7222_PROBE_CLOCK()
+#define IQS7222_PROBE_STOP(op, name, address, length) recordProbe(op, name, IQS7222_PROBE_CLOCK(), address, length)
+#else
+#define IQS7222_PROBE_START(name) do { } while (0)
+#define IQS7222_PROBE_STOP(op, name, address, length) do { } while (0)
+#endif
+
+#if defined(IQS7222_ENABLE_STATS)
+#define IQS7222_COUNT(field, amount) do { _stats.field += (amount); } while (0)
+#else
+#define IQS7222_COUNT(field, amount) do { } while (0)
+#endif
+
+#endif // IQS7222_TRACE_H
@@ -0,0 +1,151 @@
+/**
+  **********************************************************************************
+  * @file     IQS7222_transport.cpp
+  * @author   Colin Laganier
+  * @version  V0.1
+  * @date     2026-10-18
+  * @brief   This file contains the Wire backend of the IQS7222 bus transport.
+  **********************************************************************************
+  * @attention  Requires standard Arduino Libraries: Arduino.h, Wire.h.
+  */
+
+  // Include Files
+#include "IQS7222.h"
+
+Wire_transport wireTransport(Wire);
+
+/**************************************************************************************************************/
+/*                                              PUBLIC METHODS                                                */
+/**************************************************************************************************************/
+
+/**
+  * @name   readMany
+  * @brief  Method to send several write-reads as one transaction.
+  * @param  address -> 7bit address of the device.
+  *         reads -> The write-reads, in order.
+  *         numReads -> Number of write-reads, at most TRANSPORT_MAX_READS.
+  *         stopOrRestart -> STOP ends the transaction after the last read, RESTART keeps the bus for the next one.
+  * @retval Returns true if every write-read succeeded, returns false at the first one which failed.
+  * @notes  Default for the backends whose writeRead keeps the window with RESTART: the write-reads are issued in turn.
+  */
+bool IQS7222_transport::readMany(uint8_t address, const Transport_read reads[], uint8_t numReads, bool stopOrRestart)
+{
+    for (uint8_t i = 0; i < numReads; i++)
+    {
+        if (!writeRead(address, reads[i].tx, reads[i].txLength, reads[i].rx, reads[i].rxLength,
+            (i == numReads - 1) ? stopOrRestart : RESTART))
+            return false;
+    }
+    return true;
+}
+
+/**
+  * @name   begin
+  * @brief  Method to initialise the Wire instance.
+  * @param  None.
+  * @retval None.
+  * @notes  None.
+  */
+void Wire_transport::begin(void)
+{
+    _wire.begin();
+}
+
+/**
+  * @name   setClock
+  * @brief  Method to set the bus clock.
+  * @param  frequency -> Clock frequency in Hz.
+  * @retval Returns true, the Wire library does not report whether the frequency is supported.
+  * @notes  None.
+  */
+bool Wire_transport::setClock(uint32_t frequency)
+{
+    _wire.setClock(frequency);
+    return true;
+}
+
+/**
+  * @name   write
+  * @brief  Method to write a register address followed by its payload.
+  * @param  address -> 7bit address of the device.
+  *         header -> Register address bytes, may be NULL if headerLength is 0.
+  *         headerLength -> Number of header bytes.
+  *         data -> Payload, may be NULL if dataLength is 0.
+  *         dataLength -> Number of payload bytes.
+  *         stopOrRestart -> STOP ends the transaction, RESTART keeps the bus for the next one.
+  * @retval Returns true if the device acknowledged every byte, returns false if not.
+  * @notes  None.
+  */
+bool Wire_transport::write(uint8_t address, const uint8_t header[], uint8_t headerLength,
+    const uint8_t data[], uint8_t dataLength, bool stopOrRestart)
+{
+    _wire.beginTransmission(address);
+    if (headerLength != 0)
+        _wire.write(header, headerLength);
+    if (dataLength != 0)
+        _wire.write(data, dataLength);
+    return _wire.endTransmission(stopOrRestart) == 0;
+}
+
+/**
+  * @name   writeRead
+  * @brief  Method to write a register address and read its payload after a repeated start.
+  * @param  address -> 7bit address of the device.
+  *         tx -> Register address bytes.
+  *         txLength -> Number of address bytes.
+  *         rx -> Buffer receiving the payload.
+  *         rxLength -> Number of payload bytes.
+  *         stopOrRestart -> STOP ends the transaction, RESTART keeps the bus for the next one.
+  * @retval Returns true if the address was acknowledged and every payload byte received, returns false if not.
+  * @notes  The Wire library has no combined primitive, the two phases are issued back to back without a STOP.
+  */
+bool Wire_transport::writeRead(uint8_t address, const uint8_t tx[], uint8_t txLength,
+    uint8_t rx[], uint8_t rxLength, bool stopOrRestart)
+{
+    _wire.beginTransmission(address);
+    _wire.write(tx, txLength);
+    if (_wire.endTransmission(RESTART) != 0)
+        return false;
+
+    if (_wire.requestFrom(address, rxLength, (uint8_t)stopOrRestart) != rxLength)
+        return false;
+    for (uint8_t i = 0; i < rxLength; i++)
+        rx[i] = _wire.read();
+    return true;
+}
+
+/**
+  * @name   readMany
+  * @brief  Method to send several write-reads as one transaction.
+  * @param  address -> 7bit address of the device.
+  *         reads -> The write-reads, in order.
+  *         numReads -> Number of write-reads, at most TRANSPORT_MAX_READS.
+  *         stopOrRestart -> STOP ends the transaction after the last read, RESTART keeps the bus for the next one.
+  * @retval Returns true if every write-read succeeded, returns false if not.
+  * @notes  On Linux the reads are sent in a single ioctl by TwoWire::requestMany, elsewhere they are issued in turn.
+  */
+bool Wire_transport::readMany(uint8_t address, const Transport_read reads[], uint8_t numReads, bool stopOrRestart)
+{
+#if defined(IQS7222_LINUX_WIRE_H)
+    (void)stopOrRestart;
+    return _wire.requestMany(address, reads, numReads);
+#else
+    return IQS7222_transport::readMany(address, reads, numReads, stopOrRestart);
+#endif
+}
+
+/**
+  * @name   keepsWindow
+  * @brief  Method which tells whether a read ended with RESTART keeps the communication window open.
+  * @param  None.
+  * @retval Returns false on Linux, where requestFrom ends every read with a STOP, returns true otherwise.
+  * @notes  None.
+  */
+bool Wire_transport::keepsWindow(void)
+{
+#if defined(IQS7222_LINUX_WIRE_H)
+    return false;
+#else
+    return true;
+#endif
+}
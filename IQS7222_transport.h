@@ -0,0 +1,82 @@
+/**
+  **********************************************************************************
+  * @file     IQS7222_transport.h
+  * @author   Colin Laganier
+  * @version  V0.1
+  * @date     2026-10-18
+  * @brief   This file contains the bus transport interface used by the IQS7222 library
+  *          and its default backend on the Arduino Wire library.
+  **********************************************************************************
+  * @attention  A transport moves the register address and the payload of one transaction.
+  *             writeRead sends the address and reads the payload into the caller's buffer
+  *             as one combined transaction with a repeated start, backends which support it
+  *             natively (e.g. I2C_RDWR on Linux, see platform/linux) avoid any intermediate
+  *             buffer. A mock backend for host builds is in platform/mock.
+  *             Backends whose reads always end with a STOP (keepsWindow returns false) close
+  *             the communication window of the device after every read, the driver then reads
+  *             the registers of a report with readMany, several write-reads in one transaction.
+  */
+
+#ifndef IQS7222_TRANSPORT_H
+#define IQS7222_TRANSPORT_H
+
+// Include Files
+#include "Arduino.h"
+#include <Wire.h>
+
+// Attempts of a read before it is reported as failed
+#define TRANSPORT_READ_ATTEMPTS 4
+// Write-reads of one readMany transaction
+#define TRANSPORT_MAX_READS 3
+
+// Write-read of a readMany transaction
+typedef struct Transport_read {
+	const uint8_t* tx;		// Register address bytes
+	uint8_t txLength;
+	uint8_t* rx;			// Buffer receiving the payload
+	uint8_t rxLength;
+} Transport_read;
+
+class IQS7222_transport
+{
+public:
+	// Public methods
+	virtual void begin(void) = 0;
+	virtual bool setClock(uint32_t frequency) = 0;
+	// Writes header followed by data, an empty write only addresses the device
+	virtual bool write(uint8_t address, const uint8_t header[], uint8_t headerLength,
+		const uint8_t data[], uint8_t dataLength, bool stopOrRestart) = 0;
+	// Writes tx then reads rxLength bytes into rx after a repeated start
+	virtual bool writeRead(uint8_t address, const uint8_t tx[], uint8_t txLength,
+		uint8_t rx[], uint8_t rxLength, bool stopOrRestart) = 0;
+	// Sends the write-reads with repeated starts between them, the last one ends with stopOrRestart
+	virtual bool readMany(uint8_t address, const Transport_read reads[], uint8_t numReads, bool stopOrRestart);
+	// True if a read ended with RESTART keeps the communication window open for the next transaction
+	virtual bool keepsWindow(void) { return true; }
+};
+
+class Wire_transport : public IQS7222_transport
+{
+public:
+	// Public constructor
+	Wire_transport(TwoWire& wire) : _wire(wire) {}
+
+	// Public methods
+	void begin(void) override;
+	bool setClock(uint32_t frequency) override;
+	bool write(uint8_t address, const uint8_t header[], uint8_t headerLength,
+		const uint8_t data[], uint8_t dataLength, bool stopOrRestart) override;
+	bool writeRead(uint8_t address, const uint8_t tx[], uint8_t txLength,
+		uint8_t rx[], uint8_t rxLength, bool stopOrRestart) override;
+	bool readMany(uint8_t address, const Transport_read reads[], uint8_t numReads, bool stopOrRestart) override;
+	bool keepsWindow(void) override;
+
+private:
+	// Private variables
+	TwoWire& _wire;
+};
+
+// Transport on the default Wire instance, used unless IQS7222::setTransport is called
+extern Wire_transport wireTransport;
+
+#endif // IQS7222_TRANSPORT_H
@@ -0,0 +1,45 @@
+/**
+  **********************************************************************************
+  * @file     IQS7222C_grid_layout.h
+  * @author   Colin Laganier
+  * @version  V0.1
+  * @date     2026-10-18
+  * @brief   This file contains the electrode layout of the IQS7222C prototypes: a 2x3 grid
+  *          with the left column on CH1/CH3/CH5 and the right column on CH2/CH4/CH6.
+  **********************************************************************************
+  * @attention  Each row of the grid is driven by one conversion cycle (cycles 1 to 3), the
+  *             self capacitance cycle 0 (channels 0 and 5) and cycle 4 are not used by the grid.
+  */
+
+#ifndef IQS7222C_GRID_LAYOUT_H
+#define IQS7222C_GRID_LAYOUT_H
+
+// Number of channels of the device
+#define IQS7222_NUM_CHANNELS 10
+
+// Conversion cycles of the device, cycle n converts channels n and n + 5 at the same time
+#define IQS7222_NUM_CYCLES 5
+#define IQS7222_CYCLE_CHANNELS(cycle) ((uint16_t)((1U << (cycle)) | (1U << ((cycle) + 5))))
+
+// Electrode grid dimensions
+#define IQS7222_GRID_ROWS 3
+#define IQS7222_GRID_COLS 2
+
+// Channel of each grid cell from the bottom row to the top row, left to right, -1 where there is no electrode
+#define IQS7222_GRID { \
+	1, 6, \
+	2, 7, \
+	3, 8 }
+
+// Electrodes of the grid, named along the columns from the bottom left
+typedef enum
+{
+	CH1 = 1,
+	CH2 = 6,
+	CH3 = 2,
+	CH4 = 7,
+	CH5 = 3,
+	CH6 = 8
+} CHANNELS;
+
+#endif // IQS7222C_GRID_LAYOUT_H
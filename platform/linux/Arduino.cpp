@@ -0,0 +1,433 @@
+/**
+  **********************************************************************************
+  * @file     Arduino.cpp
+  * @author   Colin Laganier
+  * @version  V0.1
+  * @date     2026-10-18
+  * @brief   This file contains the Linux implementation of the Arduino timing and pin
+  *          functions used by the IQS7222 library.
+  **********************************************************************************
+  * @attention  Pins are requested from the GPIO character device (uAPI v2) on first use.
+  *             Inputs are requested with falling edge detection so that linuxWaitPinLow can
+  *             sleep until the device pulls its READY pin LOW instead of polling it.
+  *             attachInterrupt runs the handler on a thread per line, woken by the line's
+  *             edge events. Link with -pthread.
+  */
+
+  // Include Files
+#include "Arduino.h"
+#include "Wire.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sched.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/gpio.h>
+#include <atomic>
+#include <thread>
+
+// Longest sleep of an interrupt thread before it checks whether it was detached, in milliseconds
+#define LINUX_INTERRUPT_POLL_TIME 100
+
+// GPIO line requested by pinMode
+typedef struct {
+	uint8_t pin;	// Line offset on the chip
+	uint8_t mode;	// INPUT, OUTPUT or INPUT_PULLUP
+	int fd;			// Line request, -1 if the slot is free
+	void (*handler)(void);		// Handler attached with attachInterrupt
+	std::atomic<bool> attached;	// True while the interrupt thread runs
+	std::thread thread;			// Interrupt thread
+} Linux_pin;
+
+static int chipFd = -1;
+static Linux_pin pins[LINUX_MAX_PINS];
+static struct timespec startTime = {};
+static bool simulatedTime = false;	// True while micros() returns simulatedMicros, see linuxSimulateTime
+static uint64_t simulatedMicros = 0;
+
+/**************************************************************************************************************/
+/*                                                 HELPERS                                                    */
+/**************************************************************************************************************/
+
+/**
+  * @name   findPin
+  * @brief  Returns the slot of a requested line.
+  * @param  pin -> Line offset.
+  * @retval The slot, NULL if the line has not been requested.
+  * @notes  None.
+  */
+static Linux_pin* findPin(uint8_t pin)
+{
+    for (auto& slot : pins)
+    {
+        if ((slot.fd >= 0) && (slot.pin == pin))
+            return &slot;
+    }
+    return NULL;
+}
+
+/**
+  * @name   pinConfig
+  * @brief  Builds the line configuration of a pin mode.
+  * @param  mode -> INPUT, OUTPUT or INPUT_PULLUP.
+  *         config -> Receives the configuration.
+  * @retval None.
+  * @notes  Outputs are open drain as the READY line is shared with the device.
+  */
+static void pinConfig(uint8_t mode, struct gpio_v2_line_config& config)
+{
+    memset(&config, 0, sizeof(config));
+    if (mode == OUTPUT)
+        config.flags = GPIO_V2_LINE_FLAG_OUTPUT | GPIO_V2_LINE_FLAG_OPEN_DRAIN;
+    else
+        config.flags = GPIO_V2_LINE_FLAG_INPUT | GPIO_V2_LINE_FLAG_EDGE_FALLING
+            | ((mode == INPUT_PULLUP) ? GPIO_V2_LINE_FLAG_BIAS_PULL_UP : 0);
+}
+
+/**
+  * @name   interruptThread
+  * @brief  Calls the handler of a line for each of its edge events until the line is detached.
+  * @param  slot -> The line.
+  * @retval None.
+  * @notes  None.
+  */
+static void interruptThread(Linux_pin* slot)
+{
+    struct pollfd descriptor = { slot->fd, POLLIN, 0 };
+    struct gpio_v2_line_event event;
+
+    while (slot->attached)
+    {
+        if ((poll(&descriptor, 1, LINUX_INTERRUPT_POLL_TIME) > 0) && (read(slot->fd, &event, sizeof(event)) == sizeof(event)))
+            slot->handler();
+    }
+}
+
+/**************************************************************************************************************/
+/*                                                FUNCTIONS                                                   */
+/**************************************************************************************************************/
+
+/**
+  * @name   linuxPlatformBegin
+  * @brief  Opens the I2C adapter used by Wire and the GPIO chip used for the pins.
+  * @param  i2cDevice -> Path of the i2c-dev adapter, e.g. "/dev/i2c-1".
+  *         gpioChip -> Path of the GPIO chip, e.g. "/dev/gpiochip0", NULL if no pin is used.
+  * @retval Returns true if both could be opened, returns false if not.
+  * @notes  Must be called before IQS7222::begin.
+  */
+bool linuxPlatformBegin(const char* i2cDevice, const char* gpioChip)
+{
+    clock_gettime(CLOCK_MONOTONIC, &startTime);
+    for (auto& slot : pins)
+        slot.fd = -1;
+
+    if (!Wire.open(i2cDevice))
+        return false;
+    if (gpioChip != NULL)
+    {
+        chipFd = open(gpioChip, O_RDWR | O_CLOEXEC);
+        if (chipFd < 0)
+            return false;
+    }
+    return true;
+}
+
+/**
+  * @name   linuxPlatformEnd
+  * @brief  Releases the pins and closes the GPIO chip and I2C adapter.
+  * @param  None.
+  * @retval None.
+  * @notes  None.
+  */
+void linuxPlatformEnd(void)
+{
+    for (auto& slot : pins)
+    {
+        if (slot.attached)
+            detachInterrupt(slot.pin);
+        if (slot.fd >= 0)
+            close(slot.fd);
+        slot.fd = -1;
+    }
+    if (chipFd >= 0)
+        close(chipFd);
+    chipFd = -1;
+    Wire.end();
+}
+
+/**
+  * @name   millis
+  * @brief  Returns the milliseconds elapsed since linuxPlatformBegin.
+  * @param  None.
+  * @retval Milliseconds, wrapping at 32bit like on the Arduino cores.
+  * @notes  None.
+  */
+unsigned long millis(void)
+{
+    return (uint32_t)(micros() / 1000);
+}
+
+/**
+  * @name   micros
+  * @brief  Returns the microseconds elapsed since linuxPlatformBegin.
+  * @param  None.
+  * @retval Microseconds, wrapping at 32bit like on the Arduino cores.
+  * @notes  None.
+  */
+unsigned long micros(void)
+{
+    if (simulatedTime)
+        return (uint32_t)simulatedMicros;
+
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    int64_t elapsed = (int64_t)(now.tv_sec - startTime.tv_sec) * 1000000 + (now.tv_nsec - startTime.tv_nsec) / 1000;
+    return (uint32_t)elapsed;
+}
+
+/**
+  * @name   delay
+  * @brief  Sleeps for a number of milliseconds.
+  * @param  ms -> Milliseconds.
+  * @retval None.
+  * @notes  None.
+  */
+void delay(unsigned long ms)
+{
+    delayMicroseconds(ms * 1000);
+}
+
+/**
+  * @name   delayMicroseconds
+  * @brief  Sleeps for a number of microseconds.
+  * @param  us -> Microseconds.
+  * @retval None.
+  * @notes  The sleep is resumed when interrupted by a signal. With simulated time the clock is advanced instead.
+  */
+void delayMicroseconds(unsigned int us)
+{
+    if (simulatedTime)
+    {
+        simulatedMicros += us;
+        return;
+    }
+
+    struct timespec duration = { (time_t)(us / 1000000), (long)(us % 1000000) * 1000 };
+    while ((clock_nanosleep(CLOCK_MONOTONIC, 0, &duration, &duration) == EINTR))
+        ;
+}
+
+/**
+  * @name   yield
+  * @brief  Gives the processor to another thread.
+  * @param  None.
+  * @retval None.
+  * @notes  None.
+  */
+void yield(void)
+{
+    sched_yield();
+}
+
+/**
+  * @name   linuxSimulateTime
+  * @brief  Replaces the monotonic clock of millis and micros with a simulated clock, for host tests and benchmarks.
+  * @param  simulate -> True to use the simulated clock, false to go back to the monotonic clock.
+  * @retval None.
+  * @notes  The simulated clock starts at 0 and only moves with linuxAdvanceTime, delay and delayMicroseconds, which
+  *         return at once.
+  */
+void linuxSimulateTime(bool simulate)
+{
+    simulatedTime = simulate;
+    simulatedMicros = 0;
+}
+
+/**
+  * @name   linuxAdvanceTime
+  * @brief  Advances the simulated clock.
+  * @param  us -> Microseconds.
+  * @retval None.
+  * @notes  No effect unless linuxSimulateTime is enabled.
+  */
+void linuxAdvanceTime(uint32_t us)
+{
+    if (simulatedTime)
+        simulatedMicros += us;
+}
+
+/**
+  * @name   pinMode
+  * @brief  Requests a GPIO line, or reconfigures it if already requested.
+  * @param  pin -> Line offset on the GPIO chip.
+  *         mode -> INPUT, OUTPUT or INPUT_PULLUP.
+  * @retval None.
+  * @notes  Outputs start HIGH (released), as the READY line idles HIGH.
+  */
+void pinMode(uint8_t pin, uint8_t mode)
+{
+    Linux_pin* slot = findPin(pin);
+
+    if (slot != NULL)
+    {
+        struct gpio_v2_line_config config;
+        pinConfig(mode, config);
+        if (mode == OUTPUT)
+        {
+            config.num_attrs = 1;
+            config.attrs[0].attr.id = GPIO_V2_LINE_ATTR_ID_OUTPUT_VALUES;
+            config.attrs[0].attr.values = 1;
+            config.attrs[0].mask = 1;
+        }
+        ioctl(slot->fd, GPIO_V2_LINE_SET_CONFIG_IOCTL, &config);
+        slot->mode = mode;
+        return;
+    }
+
+    for (auto& free : pins)
+    {
+        if (free.fd >= 0)
+            continue;
+
+        struct gpio_v2_line_request request;
+        memset(&request, 0, sizeof(request));
+        request.offsets[0] = pin;
+        request.num_lines = 1;
+        strncpy(request.consumer, "IQS7222", sizeof(request.consumer) - 1);
+        pinConfig(mode, request.config);
+        if (mode == OUTPUT)
+        {
+            request.config.num_attrs = 1;
+            request.config.attrs[0].attr.id = GPIO_V2_LINE_ATTR_ID_OUTPUT_VALUES;
+            request.config.attrs[0].attr.values = 1;
+            request.config.attrs[0].mask = 1;
+        }
+        if ((chipFd < 0) || (ioctl(chipFd, GPIO_V2_GET_LINE_IOCTL, &request) < 0))
+            return;
+
+        free.pin = pin;
+        free.mode = mode;
+        free.fd = request.fd;
+        return;
+    }
+}
+
+/**
+  * @name   digitalWrite
+  * @brief  Sets the level of an output line.
+  * @param  pin -> Line offset on the GPIO chip.
+  *         value -> HIGH or LOW.
+  * @retval None.
+  * @notes  None.
+  */
+void digitalWrite(uint8_t pin, uint8_t value)
+{
+    Linux_pin* slot = findPin(pin);
+    struct gpio_v2_line_values values = { (uint64_t)(value ? 1 : 0), 1 };
+
+    if ((slot != NULL) && (slot->mode == OUTPUT))
+        ioctl(slot->fd, GPIO_V2_LINE_SET_VALUES_IOCTL, &values);
+}
+
+/**
+  * @name   digitalRead
+  * @brief  Reads the level of a line.
+  * @param  pin -> Line offset on the GPIO chip.
+  * @retval HIGH or LOW, HIGH if the line has not been requested.
+  * @notes  None.
+  */
+int digitalRead(uint8_t pin)
+{
+    Linux_pin* slot = findPin(pin);
+    struct gpio_v2_line_values values = { 0, 1 };
+
+    if ((slot == NULL) || (ioctl(slot->fd, GPIO_V2_LINE_GET_VALUES_IOCTL, &values) < 0))
+        return HIGH;
+    return (values.bits & 1) ? HIGH : LOW;
+}
+
+/**
+  * @name   attachInterrupt
+  * @brief  Calls a handler on the edges of an input line.
+  * @param  interrupt -> Line offset on the GPIO chip, configured as INPUT or INPUT_PULLUP, see digitalPinToInterrupt.
+  *         handler -> Function called for each edge.
+  *         mode -> FALLING, RISING or CHANGE.
+  * @retval None.
+  * @notes  The handler runs on a thread of the library, not in interrupt context, and must be thread safe. The line
+  *         keeps the edge detection of mode until detachInterrupt, do not use it with linuxWaitPinLow meanwhile.
+  */
+void attachInterrupt(uint8_t interrupt, void (*handler)(void), int mode)
+{
+    Linux_pin* slot = findPin(interrupt);
+    struct gpio_v2_line_config config;
+
+    if ((slot == NULL) || (slot->mode == OUTPUT) || (handler == NULL))
+        return;
+    if (slot->attached)
+        detachInterrupt(interrupt);
+
+    pinConfig(slot->mode, config);
+    config.flags &= ~(GPIO_V2_LINE_FLAG_EDGE_RISING | GPIO_V2_LINE_FLAG_EDGE_FALLING);
+    config.flags |= ((mode != FALLING) ? GPIO_V2_LINE_FLAG_EDGE_RISING : 0)
+        | ((mode != RISING) ? GPIO_V2_LINE_FLAG_EDGE_FALLING : 0);
+    if (ioctl(slot->fd, GPIO_V2_LINE_SET_CONFIG_IOCTL, &config) < 0)
+        return;
+
+    slot->handler = handler;
+    slot->attached = true;
+    slot->thread = std::thread(interruptThread, slot);
+}
+
+/**
+  * @name   detachInterrupt
+  * @brief  Stops calling the handler of a line.
+  * @param  interrupt -> Line offset on the GPIO chip.
+  * @retval None.
+  * @notes  Returns once the handler has returned, the line goes back to falling edge detection.
+  */
+void detachInterrupt(uint8_t interrupt)
+{
+    Linux_pin* slot = findPin(interrupt);
+    struct gpio_v2_line_config config;
+
+    if ((slot == NULL) || !slot->attached)
+        return;
+
+    slot->attached = false;
+    slot->thread.join();
+    pinConfig(slot->mode, config);
+    ioctl(slot->fd, GPIO_V2_LINE_SET_CONFIG_IOCTL, &config);
+}
+
+/**
+  * @name   linuxWaitPinLow
+  * @brief  Sleeps until an input line is LOW.
+  * @param  pin -> Line offset on the GPIO chip, configured as INPUT or INPUT_PULLUP.
+  *         timeoutUs -> Longest wait in microseconds.
+  * @retval Returns true if the line is LOW, returns false on timeout.
+  * @notes  Edge events queued before the call are discarded, the line level is then checked and the thread sleeps in
+  *         poll() until the next falling edge.
+  */
+bool linuxWaitPinLow(uint8_t pin, uint32_t timeoutUs)
+{
+    Linux_pin* slot = findPin(pin);
+    struct pollfd descriptor;
+    struct gpio_v2_line_event event;
+
+    if ((slot == NULL) || (slot->mode == OUTPUT))
+        return false;
+
+    descriptor.fd = slot->fd;
+    descriptor.events = POLLIN;
+    while ((poll(&descriptor, 1, 0) > 0) && (read(slot->fd, &event, sizeof(event)) == sizeof(event)))
+        ;
+
+    if (digitalRead(pin) == LOW)
+        return true;
+    if (poll(&descriptor, 1, (timeoutUs + 999) / 1000) <= 0)
+        return false;
+    read(slot->fd, &event, sizeof(event));
+    return true;
+}
@@ -0,0 +1,72 @@
+/**
+  **********************************************************************************
+  * @file     Arduino.h
+  * @author   Colin Laganier
+  * @version  V0.1
+  * @date     2026-10-18
+  * @brief   This file contains the subset of the Arduino API used by the IQS7222 library,
+  *          implemented on Linux with the GPIO character device and CLOCK_MONOTONIC.
+  **********************************************************************************
+  * @attention  Add platform/linux to the include path before the library sources so that
+  *             this file and Wire.h replace the Arduino core. Pin numbers are line offsets
+  *             on the GPIO chip passed to linuxPlatformBegin.
+  */
+
+#ifndef IQS7222_LINUX_ARDUINO_H
+#define IQS7222_LINUX_ARDUINO_H
+
+// Include Files
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <type_traits>
+
+// Pin levels and modes
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+
+// Interrupt modes, interrupt numbers are the pin numbers
+#define CHANGE 1
+#define FALLING 2
+#define RISING 3
+#define NOT_AN_INTERRUPT -1
+#define digitalPinToInterrupt(pin) (pin)
+
+// Number of GPIO lines which can be used at the same time
+#define LINUX_MAX_PINS 8
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+// Functions, not macros, so that the C++ standard headers can be included afterwards
+template <typename A, typename B>
+inline typename std::common_type<A, B>::type min(A a, B b) { return (b < a) ? b : a; }
+template <typename A, typename B>
+inline typename std::common_type<A, B>::type max(A a, B b) { return (a < b) ? b : a; }
+template <typename T, typename L, typename H>
+inline T constrain(T x, L low, H high) { return (x < low) ? low : ((high < x) ? high : x); }
+
+unsigned long millis(void);
+unsigned long micros(void);
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield(void);
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+void attachInterrupt(uint8_t interrupt, void (*handler)(void), int mode);
+void detachInterrupt(uint8_t interrupt);
+
+// Linux specific
+bool linuxPlatformBegin(const char* i2cDevice, const char* gpioChip);
+void linuxPlatformEnd(void);
+bool linuxWaitPinLow(uint8_t pin, uint32_t timeoutUs);
+void linuxSimulateTime(bool simulate);
+void linuxAdvanceTime(uint32_t us);
+
+#endif // IQS7222_LINUX_ARDUINO_H
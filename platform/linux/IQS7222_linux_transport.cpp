@@ -0,0 +1,228 @@
+/**
+  **********************************************************************************
+  * @file     IQS7222_linux_transport.cpp
+  * @author   Colin Laganier
+  * @version  V0.1
+  * @date     2026-10-18
+  * @brief   This file contains the IQS7222 bus transport on the Linux i2c-dev interface.
+  **********************************************************************************
+  * @attention  Requires the i2c-dev kernel module and an adapter supporting I2C_FUNC_I2C.
+  */
+
+  // Include Files
+#include "IQS7222_linux_transport.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/i2c.h>
+#include <linux/i2c-dev.h>
+
+static_assert(LINUX_TRANSPORT_MESSAGES + 2 <= I2C_RDWR_IOCTL_MAX_MSGS, "I2C_RDWR limits the messages of an ioctl");
+static_assert(2 * TRANSPORT_MAX_READS <= I2C_RDWR_IOCTL_MAX_MSGS, "I2C_RDWR limits the messages of an ioctl");
+static_assert(LINUX_TRANSPORT_MESSAGES >= PROFILE_NUM_BLOCKS, "The held chain must take every block of a profile");
+
+/**************************************************************************************************************/
+/*                                              PUBLIC METHODS                                                */
+/**************************************************************************************************************/
+
+/**
+  * @name   open
+  * @brief  Method to open an i2c-dev adapter.
+  * @param  path -> Path of the adapter, e.g. "/dev/i2c-1".
+  *         busFrequency -> Bus clock configured for the adapter by the kernel, in Hz.
+  * @retval Returns true if the adapter supports I2C_RDWR, returns false if not.
+  * @notes  None.
+  */
+bool Linux_transport::open(const char* path, uint32_t busFrequency)
+{
+    unsigned long functions = 0;
+
+    close();
+    _fd = ::open(path, O_RDWR | O_CLOEXEC);
+    if (_fd < 0)
+        return false;
+    if ((ioctl(_fd, I2C_FUNCS, &functions) < 0) || !(functions & I2C_FUNC_I2C))
+    {
+        close();
+        return false;
+    }
+    _busFrequency = busFrequency;
+    return true;
+}
+
+/**
+  * @name   close
+  * @brief  Method to close the adapter.
+  * @param  None.
+  * @retval None.
+  * @notes  None.
+  */
+void Linux_transport::close(void)
+{
+    if (_fd >= 0)
+        ::close(_fd);
+    _fd = -1;
+    _heldCount = 0;
+    _heldBytes = 0;
+}
+
+/**
+  * @name   begin
+  * @brief  Method to drop any held write.
+  * @param  None.
+  * @retval None.
+  * @notes  The adapter is opened with open.
+  */
+void Linux_transport::begin(void)
+{
+    _heldCount = 0;
+    _heldBytes = 0;
+}
+
+/**
+  * @name   setClock
+  * @brief  Method to check a bus clock against the one configured by the kernel.
+  * @param  frequency -> Clock frequency in Hz.
+  * @retval Returns true if the frequency is the one given to open, returns false if not.
+  * @notes  The clock of a Linux adapter cannot be changed at runtime.
+  */
+bool Linux_transport::setClock(uint32_t frequency)
+{
+    return frequency == _busFrequency;
+}
+
+/**
+  * @name   write
+  * @brief  Method to write a register address followed by its payload.
+  * @param  address -> 7bit address of the device.
+  *         header, headerLength -> Register address bytes.
+  *         data, dataLength -> Payload.
+  *         stopOrRestart -> STOP sends the held writes and this one in one ioctl, RESTART holds it for the next transaction.
+  * @retval Returns true on success, returns false if the transfer failed or the write does not fit in the held chain.
+  *         A held write succeeds, its errors are reported by the transaction it is sent with.
+  * @notes  A write which does not fit drops the held chain, sending part of it would end it with a STOP.
+  */
+bool Linux_transport::write(uint8_t address, const uint8_t header[], uint8_t headerLength,
+    const uint8_t data[], uint8_t dataLength, bool stopOrRestart)
+{
+    bool success = true;
+
+    if ((_heldCount == LINUX_TRANSPORT_MESSAGES) || ((_heldBytes + headerLength + dataLength) > LINUX_TRANSPORT_BUFFER))
+    {
+        begin();
+        return false;
+    }
+
+    memcpy(&_held[_heldBytes], header, headerLength);
+    memcpy(&_held[_heldBytes + headerLength], data, dataLength);
+    _heldLengths[_heldCount] = headerLength + dataLength;
+    _heldAddresses[_heldCount] = address;
+    _heldCount++;
+    _heldBytes += headerLength + dataLength;
+
+    if (stopOrRestart)
+    {
+        success = transfer(0, NULL, 0) && success;
+        begin();
+    }
+    return success;
+}
+
+/**
+  * @name   writeRead
+  * @brief  Method to write a register address and read its payload after a repeated start.
+  * @param  address -> 7bit address of the device.
+  *         tx, txLength -> Register address bytes.
+  *         rx, rxLength -> Buffer receiving the payload.
+  *         stopOrRestart -> Ignored, the read ends the ioctl with a STOP, see the limitation in the header.
+  * @retval Returns true on success, returns false if the transfer failed.
+  * @notes  The held writes are sent first in the same ioctl. They are kept when the transfer fails so that a retry
+  *         sends them again.
+  */
+bool Linux_transport::writeRead(uint8_t address, const uint8_t tx[], uint8_t txLength,
+    uint8_t rx[], uint8_t rxLength, bool stopOrRestart)
+{
+    Transport_read read = { tx, txLength, rx, rxLength };
+
+    return readMany(address, &read, 1, stopOrRestart);
+}
+
+/**
+  * @name   readMany
+  * @brief  Method to send several write-reads as one transaction.
+  * @param  address -> 7bit address of the device.
+  *         reads -> The write-reads, in order, their payloads are read straight into their buffers.
+  *         numReads -> Number of write-reads, at most TRANSPORT_MAX_READS.
+  *         stopOrRestart -> Ignored, the ioctl ends with a STOP.
+  * @retval Returns true on success, returns false if the transfer failed or does not fit in one ioctl.
+  * @notes  The held writes and the write-reads are sent in one ioctl, joined by repeated starts, so the reads are served
+  *         in the same communication window. The held writes are kept when the transfer fails so that a retry sends
+  *         them again.
+  */
+bool Linux_transport::readMany(uint8_t address, const Transport_read reads[], uint8_t numReads, bool stopOrRestart)
+{
+    (void)stopOrRestart;
+    if (!transfer(address, reads, numReads))
+        return false;
+    begin();
+    return true;
+}
+
+/**************************************************************************************************************/
+/*                                              PRIVATE METHODS                                               */
+/**************************************************************************************************************/
+
+/**
+  * @name   transfer
+  * @brief  A method which sends the held writes followed by write-reads in one I2C_RDWR ioctl.
+  * @param  address -> 7bit address of the write-reads.
+  *         reads -> The write-reads, an empty tx or rx is left out.
+  *         numReads -> Number of write-reads, 0 to only send the held writes.
+  * @retval Returns true on success, returns false if the transfer failed or does not fit in one ioctl.
+  * @notes  None.
+  */
+bool Linux_transport::transfer(uint8_t address, const Transport_read reads[], uint8_t numReads)
+{
+    struct i2c_msg messages[I2C_RDWR_IOCTL_MAX_MSGS];
+    struct i2c_rdwr_ioctl_data data;
+    uint8_t numMessages = 0;
+    uint16_t offset = 0;
+
+    if ((_fd < 0) || ((_heldCount + 2 * numReads) > I2C_RDWR_IOCTL_MAX_MSGS))
+        return false;
+
+    for (uint8_t i = 0; i < _heldCount; i++)
+    {
+        messages[numMessages].addr = _heldAddresses[i];
+        messages[numMessages].flags = 0;
+        messages[numMessages].len = _heldLengths[i];
+        messages[numMessages].buf = &_held[offset];
+        offset += _heldLengths[i];
+        numMessages++;
+    }
+    for (uint8_t i = 0; i < numReads; i++)
+    {
+        if (reads[i].txLength != 0)
+        {
+            messages[numMessages].addr = address;
+            messages[numMessages].flags = 0;
+            messages[numMessages].len = reads[i].txLength;
+            messages[numMessages].buf = const_cast<uint8_t*>(reads[i].tx);
+            numMessages++;
+        }
+        if (reads[i].rxLength != 0)
+        {
+            messages[numMessages].addr = address;
+            messages[numMessages].flags = I2C_M_RD;
+            messages[numMessages].len = reads[i].rxLength;
+            messages[numMessages].buf = reads[i].rx;
+            numMessages++;
+        }
+    }
+    if (numMessages == 0)
+        return true;
+
+    data.msgs = messages;
+    data.nmsgs = numMessages;
+    return ioctl(_fd, I2C_RDWR, &data) >= 0;
+}
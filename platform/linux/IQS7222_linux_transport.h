@@ -0,0 +1,64 @@
+/**
+  **********************************************************************************
+  * @file     IQS7222_linux_transport.h
+  * @author   Colin Laganier
+  * @version  V0.1
+  * @date     2026-10-18
+  * @brief   This file contains the IQS7222 bus transport on the Linux i2c-dev interface.
+  **********************************************************************************
+  * @attention  writeRead is a single I2C_RDWR ioctl which reads straight into the caller's
+  *             buffer. Writes ended with a RESTART are held and sent in the same ioctl as the
+  *             next transaction, so a chain of RESTART writes reaches the device as one
+  *             transaction. The chain holds the whole register image of a profile, a write
+  *             which does not fit fails and the chain is dropped, no STOP is inserted.
+  *             A read always ends its ioctl with a STOP, the caller needs its data before the
+  *             next write can be built: a RESTART after a read closes the communication window
+  *             and a read-modify-write (acknowledgeReset, setInterface, setEventMask, autoTune)
+  *             writes in the next window. Call them after requestComms. Reads which must share
+  *             a window, such as the flags, counts and LTA of a report, are sent in one ioctl
+  *             with readMany, keepsWindow returns false so that the driver does so.
+  *             The bus clock is set by the kernel, setClock only succeeds for the frequency
+  *             given to open.
+  */
+
+#ifndef IQS7222_LINUX_TRANSPORT_H
+#define IQS7222_LINUX_TRANSPORT_H
+
+// Include Files
+#include "IQS7222_transport.h"
+#include "IQS7222_profile.h"
+
+// Held writes, messages and bytes, I2C_RDWR sends at most 42 messages including the write-read
+#define LINUX_TRANSPORT_MESSAGES 40
+#define LINUX_TRANSPORT_BUFFER (PROFILE_IMAGE_SIZE + 2 * LINUX_TRANSPORT_MESSAGES)
+
+class Linux_transport : public IQS7222_transport
+{
+public:
+	// Public methods
+	bool open(const char* path, uint32_t busFrequency);
+	void close(void);
+	void begin(void) override;
+	bool setClock(uint32_t frequency) override;
+	bool write(uint8_t address, const uint8_t header[], uint8_t headerLength,
+		const uint8_t data[], uint8_t dataLength, bool stopOrRestart) override;
+	bool writeRead(uint8_t address, const uint8_t tx[], uint8_t txLength,
+		uint8_t rx[], uint8_t rxLength, bool stopOrRestart) override;
+	bool readMany(uint8_t address, const Transport_read reads[], uint8_t numReads, bool stopOrRestart) override;
+	bool keepsWindow(void) override { return false; }
+
+private:
+	// Private variables
+	int _fd = -1;
+	uint32_t _busFrequency = 0;
+	uint8_t _held[LINUX_TRANSPORT_BUFFER];
+	uint16_t _heldLengths[LINUX_TRANSPORT_MESSAGES];
+	uint8_t _heldAddresses[LINUX_TRANSPORT_MESSAGES];
+	uint8_t _heldCount = 0;
+	uint16_t _heldBytes = 0;
+
+	// Private methods
+	bool transfer(uint8_t address, const Transport_read reads[], uint8_t numReads);
+};
+
+#endif // IQS7222_LINUX_TRANSPORT_H
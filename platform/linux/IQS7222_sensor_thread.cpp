@@ -0,0 +1,167 @@
+/**
+  **********************************************************************************
+  * @file     IQS7222_sensor_thread.cpp
+  * @author   Colin Laganier
+  * @version  V0.1
+  * @date     2026-10-18
+  * @brief   This file contains the Linux sensor thread which services the communication
+  *          windows of an IQS7222 and publishes the snapshots to consumer threads.
+  **********************************************************************************
+  * @attention  Requires POSIX threads.
+  */
+
+  // Include Files
+#include "IQS7222_sensor_thread.h"
+#include <pthread.h>
+#include <sched.h>
+
+/**************************************************************************************************************/
+/*                                              PUBLIC METHODS                                                */
+/**************************************************************************************************************/
+
+IQS7222_sensor_thread::IQS7222_sensor_thread(IQS7222& device, uint8_t readyPin)
+    : _device(device), _readyPin(readyPin)
+{
+    for (auto& dropped : _dropped)
+        dropped.store(0);
+}
+
+IQS7222_sensor_thread::~IQS7222_sensor_thread()
+{
+    stop();
+}
+
+/**
+  * @name   addConsumer
+  * @brief  Method to add a consumer queue.
+  * @param  None.
+  * @retval Index of the consumer, passed to pop and getDropped, -1 if SENSOR_MAX_CONSUMERS are already registered or
+  *         the thread is running.
+  * @notes  Consumers must be added before start.
+  */
+int IQS7222_sensor_thread::addConsumer(void)
+{
+    if (_running.load() || (_numConsumers == SENSOR_MAX_CONSUMERS))
+        return -1;
+    return _numConsumers++;
+}
+
+/**
+  * @name   start
+  * @brief  Method to start the sensor thread.
+  * @param  priority -> SCHED_FIFO priority (1 to 99), 0 to keep the default scheduling policy.
+  * @retval Returns true if the thread is running, returns false if it could not be created.
+  * @notes  The thread keeps running with the default policy if the real-time priority is refused, see isRealtime.
+  *         The device must already be initialised and its READY pin configured as an input.
+  */
+bool IQS7222_sensor_thread::start(int priority)
+{
+    if (_running.load())
+        return true;
+
+    _running.store(true);
+    try
+    {
+        _thread = std::thread(&IQS7222_sensor_thread::run, this);
+    }
+    catch (...)
+    {
+        _running.store(false);
+        return false;
+    }
+
+    _realtime = false;
+    if (priority > 0)
+    {
+        struct sched_param parameters = {};
+        parameters.sched_priority = priority;
+        _realtime = (pthread_setschedparam(_thread.native_handle(), SCHED_FIFO, &parameters) == 0);
+    }
+    return true;
+}
+
+/**
+  * @name   stop
+  * @brief  Method to stop the sensor thread and wait for it to exit.
+  * @param  None.
+  * @retval None.
+  * @notes  Returns within SENSOR_WAIT_TIMEOUT plus one report.
+  */
+void IQS7222_sensor_thread::stop(void)
+{
+    _running.store(false);
+    if (_thread.joinable())
+        _thread.join();
+}
+
+/**
+  * @name   isRealtime
+  * @brief  Method which returns whether the thread runs with the SCHED_FIFO policy.
+  * @param  None.
+  * @retval Returns true if the requested real-time priority was applied, returns false if not.
+  * @notes  None.
+  */
+bool IQS7222_sensor_thread::isRealtime(void)
+{
+    return _realtime;
+}
+
+/**
+  * @name   pop
+  * @brief  Method which takes the oldest snapshot of a consumer queue.
+  * @param  consumer -> Index returned by addConsumer.
+  *         snapshot -> Receives the snapshot.
+  * @retval Returns true if a snapshot was taken, returns false if the queue is empty.
+  * @notes  Must only be called from the thread owning the consumer, never blocks.
+  */
+bool IQS7222_sensor_thread::pop(int consumer, Sensor_snapshot& snapshot)
+{
+    if ((consumer < 0) || (consumer >= _numConsumers))
+        return false;
+    return _queues[consumer].pop(snapshot);
+}
+
+/**
+  * @name   getDropped
+  * @brief  Method which returns the number of snapshots dropped because a consumer queue was full.
+  * @param  consumer -> Index returned by addConsumer.
+  * @retval Number of dropped snapshots.
+  * @notes  None.
+  */
+uint32_t IQS7222_sensor_thread::getDropped(int consumer)
+{
+    if ((consumer < 0) || (consumer >= _numConsumers))
+        return 0;
+    return _dropped[consumer].load();
+}
+
+/**************************************************************************************************************/
+/*                                              PRIVATE METHODS                                               */
+/**************************************************************************************************************/
+
+/**
+  * @name   run
+  * @brief  Body of the sensor thread.
+  * @param  None.
+  * @retval None.
+  * @notes  Sleeps until the device opens a communication window, reads the report with updateStream and pushes the
+  *         snapshot to every consumer queue. A report which could not be read is not pushed.
+  */
+void IQS7222_sensor_thread::run(void)
+{
+    Sensor_snapshot snapshot;
+
+    while (_running.load(std::memory_order_relaxed))
+    {
+        if (!linuxWaitPinLow(_readyPin, SENSOR_WAIT_TIMEOUT))
+            continue;
+
+        if (!_device.updateStream(snapshot, STOP))
+            continue;
+        for (int i = 0; i < _numConsumers; i++)
+        {
+            if (!_queues[i].push(snapshot))
+                _dropped[i].fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+}
@@ -0,0 +1,96 @@
+/**
+  **********************************************************************************
+  * @file     IQS7222_sensor_thread.h
+  * @author   Colin Laganier
+  * @version  V0.1
+  * @date     2026-10-18
+  * @brief   This file contains the Linux sensor thread which services the communication
+  *          windows of an IQS7222 and publishes the snapshots to consumer threads.
+  **********************************************************************************
+  * @attention  Once started, the thread is the only user of the IQS7222 object. Each consumer
+  *             has its own single producer single consumer queue, so publishing and reading
+  *             never lock. A slow consumer only loses its own reports: while its queue is
+  *             full the newest reports are not queued and counted by getDropped, the queued
+  *             ones are kept.
+  *             SCHED_FIFO requires CAP_SYS_NICE (or a suitable RLIMIT_RTPRIO).
+  */
+
+#ifndef IQS7222_SENSOR_THREAD_H
+#define IQS7222_SENSOR_THREAD_H
+
+// Include Files
+#include <atomic>
+#include <thread>
+#include "IQS7222.h"
+
+// Queue settings
+#define SENSOR_QUEUE_DEPTH 16		// Snapshots per consumer queue, must be a power of two
+#define SENSOR_MAX_CONSUMERS 4
+#define SENSOR_WAIT_TIMEOUT 100000	// Longest wait for a window in microseconds, bounds the latency of stop
+
+static_assert((SENSOR_QUEUE_DEPTH & (SENSOR_QUEUE_DEPTH - 1)) == 0, "SENSOR_QUEUE_DEPTH must be a power of two");
+
+// Lock-free single producer single consumer ring buffer
+template <typename T, size_t N>
+class Spsc_queue
+{
+public:
+	// Called by the producer only, returns false if the queue is full
+	bool push(const T& item)
+	{
+		size_t head = _head.load(std::memory_order_relaxed);
+		if ((head - _tail.load(std::memory_order_acquire)) == N)
+			return false;
+		_items[head & (N - 1)] = item;
+		_head.store(head + 1, std::memory_order_release);
+		return true;
+	}
+
+	// Called by the consumer only, returns false if the queue is empty
+	bool pop(T& item)
+	{
+		size_t tail = _tail.load(std::memory_order_relaxed);
+		if (tail == _head.load(std::memory_order_acquire))
+			return false;
+		item = _items[tail & (N - 1)];
+		_tail.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+private:
+	T _items[N];
+	std::atomic<size_t> _head{ 0 };		// Written by the producer
+	std::atomic<size_t> _tail{ 0 };		// Written by the consumer
+};
+
+class IQS7222_sensor_thread
+{
+public:
+	// Public constructor
+	IQS7222_sensor_thread(IQS7222& device, uint8_t readyPin);
+	~IQS7222_sensor_thread();
+
+	// Public methods
+	int addConsumer(void);
+	bool start(int priority);
+	void stop(void);
+	bool isRealtime(void);
+	bool pop(int consumer, Sensor_snapshot& snapshot);
+	uint32_t getDropped(int consumer);
+
+private:
+	// Private variables
+	IQS7222& _device;
+	uint8_t _readyPin;
+	std::thread _thread;
+	std::atomic<bool> _running{ false };
+	bool _realtime = false;
+	int _numConsumers = 0;
+	Spsc_queue<Sensor_snapshot, SENSOR_QUEUE_DEPTH> _queues[SENSOR_MAX_CONSUMERS];
+	std::atomic<uint32_t> _dropped[SENSOR_MAX_CONSUMERS];
+
+	// Private methods
+	void run(void);
+};
+
+#endif // IQS7222_SENSOR_THREAD_H
@@ -0,0 +1,404 @@
+/**
+  **********************************************************************************
+  * @file     Wire.cpp
+  * @author   Colin Laganier
+  * @version  V0.1
+  * @date     2026-10-18
+  * @brief   This file contains the Arduino TwoWire interface implemented on the Linux
+  *          i2c-dev interface.
+  **********************************************************************************
+  * @attention  Requires the i2c-dev kernel module.
+  */
+
+  // Include Files
+#include "Wire.h"
+#include "IQS7222_transport.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/i2c.h>
+#include <linux/i2c-dev.h>
+
+static_assert(LINUX_WIRE_MESSAGES + 1 <= I2C_RDWR_IOCTL_MAX_MSGS, "I2C_RDWR limits the messages of an ioctl");
+
+TwoWire Wire;
+
+/**************************************************************************************************************/
+/*                                              PUBLIC METHODS                                                */
+/**************************************************************************************************************/
+
+/**
+  * @name   open
+  * @brief  Method to open an i2c-dev adapter.
+  * @param  path -> Path of the adapter, e.g. "/dev/i2c-1".
+  * @retval Returns true if the adapter supports I2C_RDWR or SMBus I2C block transfers, returns false if not.
+  * @notes  Called by linuxPlatformBegin.
+  */
+bool TwoWire::open(const char* path)
+{
+    unsigned long functions = 0;
+
+    end();
+    _fd = ::open(path, O_RDWR);
+    if (_fd < 0)
+        return false;
+
+    if (ioctl(_fd, I2C_FUNCS, &functions) < 0)
+    {
+        end();
+        return false;
+    }
+    _combined = (functions & I2C_FUNC_I2C) != 0;
+    if (!_combined && !(functions & I2C_FUNC_SMBUS_I2C_BLOCK))
+    {
+        end();
+        return false;
+    }
+    return true;
+}
+
+/**
+  * @name   begin
+  * @brief  Method kept for compatibility, the adapter is opened by linuxPlatformBegin.
+  * @param  None.
+  * @retval None.
+  * @notes  None.
+  */
+void TwoWire::begin(void)
+{
+    _txLength = 0;
+    _heldCount = 0;
+    _heldBytes = 0;
+}
+
+/**
+  * @name   end
+  * @brief  Method to close the adapter.
+  * @param  None.
+  * @retval None.
+  * @notes  None.
+  */
+void TwoWire::end(void)
+{
+    if (_fd >= 0)
+        close(_fd);
+    _fd = -1;
+    begin();
+}
+
+/**
+  * @name   setClock
+  * @brief  Method kept for compatibility, the bus clock of a Linux adapter is set by the kernel (device tree).
+  * @param  frequency -> Ignored.
+  * @retval None.
+  * @notes  None.
+  */
+void TwoWire::setClock(uint32_t frequency)
+{
+    (void)frequency;
+}
+
+/**
+  * @name   beginTransmission
+  * @brief  Method to start buffering a write to a device.
+  * @param  address -> 7bit address of the device.
+  * @retval None.
+  * @notes  None.
+  */
+void TwoWire::beginTransmission(uint8_t address)
+{
+    _address = address;
+    _txLength = 0;
+}
+
+/**
+  * @name   write
+  * @brief  Method to buffer a byte of the current write.
+  * @param  data -> The byte.
+  * @retval Number of bytes buffered, 0 if the buffer is full.
+  * @notes  None.
+  */
+size_t TwoWire::write(uint8_t data)
+{
+    if (_txLength >= LINUX_WIRE_BUFFER)
+        return 0;
+    _txBuffer[_txLength++] = data;
+    return 1;
+}
+
+/**
+  * @name   write
+  * @brief  Method to buffer bytes of the current write.
+  * @param  data -> The bytes.
+  *         length -> Number of bytes.
+  * @retval Number of bytes buffered.
+  * @notes  None.
+  */
+size_t TwoWire::write(const uint8_t data[], size_t length)
+{
+    size_t written = 0;
+    while ((written < length) && write(data[written]))
+        written++;
+    return written;
+}
+
+/**
+  * @name   endTransmission
+  * @brief  Method to end the current write.
+  * @param  sendStop -> True sends the held writes followed by a STOP, false holds the write for the next transfer.
+  * @retval 0 on success, 1 if the write does not fit in the held chain, 4 if the transfer failed.
+  * @notes  A held write is only sent with the next STOP or read, its errors are reported by that transfer. A write which
+  *         does not fit drops the held chain, sending part of it would end it with a STOP.
+  */
+uint8_t TwoWire::endTransmission(bool sendStop)
+{
+    if ((_heldCount == LINUX_WIRE_MESSAGES) || ((_heldBytes + _txLength) > LINUX_WIRE_HELD_BUFFER))
+    {
+        begin();
+        return 1;
+    }
+
+    memcpy(&_heldBuffer[_heldBytes], _txBuffer, _txLength);
+    _heldLengths[_heldCount] = _txLength;
+    _heldAddresses[_heldCount] = _address;
+    _heldCount++;
+    _heldBytes += _txLength;
+    _txLength = 0;
+
+    if (!sendStop)
+        return 0;
+
+    bool sent = transfer(0);
+    begin();
+    return sent ? 0 : 4;
+}
+
+/**
+  * @name   requestFrom
+  * @brief  Method to read bytes from a device, preceded by the held writes in the same transaction.
+  * @param  address -> 7bit address of the device.
+  *         quantity -> Number of bytes to read.
+  *         sendStop -> Ignored, the read ends the ioctl with a STOP, see the limitation in the header.
+  * @retval Number of bytes read, 0 if the transfer failed.
+  * @notes  The held writes are kept when the transfer fails so that a repeated requestFrom sends them again.
+  */
+uint8_t TwoWire::requestFrom(uint8_t address, uint8_t quantity, bool sendStop)
+{
+    (void)sendStop;
+    _rxLength = 0;
+    _rxIndex = 0;
+    _address = address;
+    quantity = min(quantity, (uint8_t)LINUX_WIRE_BUFFER);
+
+    if (!transfer(quantity))
+        return 0;
+
+    begin();
+    _rxLength = quantity;
+    return quantity;
+}
+
+/**
+  * @name   requestMany
+  * @brief  Method to send several write-reads to a device as one transaction, preceded by the held writes.
+  * @param  address -> 7bit address of the device.
+  *         reads -> The write-reads, in order, their payloads are read straight into their buffers.
+  *         numReads -> Number of write-reads.
+  * @retval Returns true on success, returns false if the transfer failed or does not fit in one ioctl.
+  * @notes  Linux specific. The reads are joined by repeated starts and the ioctl ends with a single STOP, so they are
+  *         served in one communication window. Adapters without I2C_RDWR send them as separate SMBus transfers. The
+  *         held writes are kept when the transfer fails so that a retry sends them again.
+  */
+bool TwoWire::requestMany(uint8_t address, const Transport_read reads[], uint8_t numReads)
+{
+    struct i2c_msg messages[I2C_RDWR_IOCTL_MAX_MSGS];
+    struct i2c_rdwr_ioctl_data data;
+    uint8_t numMessages = 0;
+    uint16_t offset = 0;
+
+    if (_fd < 0)
+        return false;
+
+    if (!_combined)
+    {
+        for (uint8_t i = 0; i < numReads; i++)
+        {
+            beginTransmission(address);
+            write(reads[i].tx, reads[i].txLength);
+            if ((endTransmission(false) != 0) || (requestFrom(address, reads[i].rxLength) != reads[i].rxLength))
+                return false;
+            memcpy(reads[i].rx, _rxBuffer, reads[i].rxLength);
+        }
+        return true;
+    }
+
+    if ((_heldCount + 2 * numReads) > I2C_RDWR_IOCTL_MAX_MSGS)
+        return false;
+    for (uint8_t i = 0; i < _heldCount; i++)
+    {
+        messages[numMessages].addr = _heldAddresses[i];
+        messages[numMessages].flags = 0;
+        messages[numMessages].len = _heldLengths[i];
+        messages[numMessages].buf = &_heldBuffer[offset];
+        offset += _heldLengths[i];
+        numMessages++;
+    }
+    for (uint8_t i = 0; i < numReads; i++)
+    {
+        messages[numMessages].addr = address;
+        messages[numMessages].flags = 0;
+        messages[numMessages].len = reads[i].txLength;
+        messages[numMessages].buf = const_cast<uint8_t*>(reads[i].tx);
+        numMessages++;
+        messages[numMessages].addr = address;
+        messages[numMessages].flags = I2C_M_RD;
+        messages[numMessages].len = reads[i].rxLength;
+        messages[numMessages].buf = reads[i].rx;
+        numMessages++;
+    }
+
+    data.msgs = messages;
+    data.nmsgs = numMessages;
+    if (ioctl(_fd, I2C_RDWR, &data) < 0)
+        return false;
+    begin();
+    return true;
+}
+
+/**
+  * @name   available
+  * @brief  Method which returns the number of bytes left to read from the last requestFrom.
+  * @param  None.
+  * @retval Number of bytes.
+  * @notes  None.
+  */
+int TwoWire::available(void)
+{
+    return _rxLength - _rxIndex;
+}
+
+/**
+  * @name   read
+  * @brief  Method which returns the next byte of the last requestFrom.
+  * @param  None.
+  * @retval The byte, -1 if no byte is left.
+  * @notes  None.
+  */
+int TwoWire::read(void)
+{
+    if (_rxIndex >= _rxLength)
+        return -1;
+    return _rxBuffer[_rxIndex++];
+}
+
+/**************************************************************************************************************/
+/*                                              PRIVATE METHODS                                               */
+/**************************************************************************************************************/
+
+/**
+  * @name   transfer
+  * @brief  A method which sends the held writes, followed by a read if requested, in one I2C_RDWR ioctl.
+  * @param  readLength -> Number of bytes to read from _address into the receive buffer, 0 for none.
+  * @retval Returns true on success, returns false if not.
+  * @notes  Falls back to SMBus transfers on adapters without I2C_RDWR.
+  */
+bool TwoWire::transfer(uint8_t readLength)
+{
+    struct i2c_msg messages[LINUX_WIRE_MESSAGES + 1];
+    struct i2c_rdwr_ioctl_data data;
+    uint8_t numMessages = 0;
+    uint16_t offset = 0;
+
+    if (_fd < 0)
+        return false;
+    if (!_combined)
+        return transferSmbus(readLength);
+
+    for (uint8_t i = 0; i < _heldCount; i++)
+    {
+        messages[numMessages].addr = _heldAddresses[i];
+        messages[numMessages].flags = 0;
+        messages[numMessages].len = _heldLengths[i];
+        messages[numMessages].buf = &_heldBuffer[offset];
+        offset += _heldLengths[i];
+        numMessages++;
+    }
+    if (readLength != 0)
+    {
+        messages[numMessages].addr = _address;
+        messages[numMessages].flags = I2C_M_RD;
+        messages[numMessages].len = readLength;
+        messages[numMessages].buf = _rxBuffer;
+        numMessages++;
+    }
+    if (numMessages == 0)
+        return true;
+
+    data.msgs = messages;
+    data.nmsgs = numMessages;
+    return ioctl(_fd, I2C_RDWR, &data) >= 0;
+}
+
+/**
+  * @name   transferSmbus
+  * @brief  A method which sends the held writes, followed by a read if requested, as SMBus transfers.
+  * @param  readLength -> Number of bytes to read from _address into the receive buffer, 0 for none.
+  * @retval Returns true on success, returns false if not.
+  * @notes  A read must be preceded by a one byte register write, which becomes the SMBus command. Each write is sent
+  *         as a quick write, a byte write or an I2C block write of at most I2C_SMBUS_BLOCK_MAX bytes.
+  */
+bool TwoWire::transferSmbus(uint8_t readLength)
+{
+    union i2c_smbus_data block;
+    struct i2c_smbus_ioctl_data data;
+    uint8_t writes = _heldCount;
+    uint16_t offset = 0;
+
+    // The register write of a read becomes its command
+    if (readLength != 0)
+    {
+        if ((writes == 0) || (_heldLengths[writes - 1] != 1) || (_heldAddresses[writes - 1] != _address)
+            || (readLength > I2C_SMBUS_BLOCK_MAX))
+        {
+            errno = EOPNOTSUPP;
+            return false;
+        }
+        writes--;
+    }
+
+    for (uint8_t i = 0; i < writes; i++)
+    {
+        uint8_t length = _heldLengths[i];
+        if ((length > (I2C_SMBUS_BLOCK_MAX + 1)) || (ioctl(_fd, I2C_SLAVE, _heldAddresses[i]) < 0))
+            return false;
+
+        data.read_write = I2C_SMBUS_WRITE;
+        data.command = (length != 0) ? _heldBuffer[offset] : 0;
+        data.size = (length == 0) ? I2C_SMBUS_QUICK : ((length == 1) ? I2C_SMBUS_BYTE : I2C_SMBUS_I2C_BLOCK_DATA);
+        data.data = &block;
+        if (length > 1)
+        {
+            block.block[0] = length - 1;
+            memcpy(&block.block[1], &_heldBuffer[offset + 1], length - 1);
+        }
+        if (ioctl(_fd, I2C_SMBUS, &data) < 0)
+            return false;
+        offset += length;
+    }
+
+    if (readLength == 0)
+        return true;
+
+    if (ioctl(_fd, I2C_SLAVE, _address) < 0)
+        return false;
+    data.read_write = I2C_SMBUS_READ;
+    data.command = _heldBuffer[offset];
+    data.size = I2C_SMBUS_I2C_BLOCK_DATA;
+    data.data = &block;
+    block.block[0] = readLength;
+    if (ioctl(_fd, I2C_SMBUS, &data) < 0)
+        return false;
+    memcpy(_rxBuffer, &block.block[1], readLength);
+    return true;
+}
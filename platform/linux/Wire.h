@@ -0,0 +1,80 @@
+/**
+  **********************************************************************************
+  * @file     Wire.h
+  * @author   Colin Laganier
+  * @version  V0.1
+  * @date     2026-10-18
+  * @brief   This file contains the Arduino TwoWire interface implemented on the Linux
+  *          i2c-dev interface (/dev/i2c-N).
+  **********************************************************************************
+  * @attention  Writes ended with a RESTART are held and sent with the next transfer in a
+  *             single I2C_RDWR ioctl, so an address write followed by requestFrom is one
+  *             combined transaction with a repeated start. A chain of RESTART writes is sent
+  *             whole, a write which does not fit fails and drops the chain, no STOP is
+  *             inserted. A read always ends its ioctl with a STOP whatever sendStop is, the
+  *             caller needs its data first: the communication window therefore closes after
+  *             every read and a write built from a read is sent in the next window. Reads which
+  *             must share a window are sent together with requestMany.
+  *             Adapters without I2C_RDWR support, such as the i2c-stub module, only
+  *             implement SMBus transfers: 8bit register reads and writes of up to 32 bytes
+  *             are then sent as SMBus I2C block transfers, 16bit registers cannot be used.
+  */
+
+#ifndef IQS7222_LINUX_WIRE_H
+#define IQS7222_LINUX_WIRE_H
+
+// Include Files
+#include "Arduino.h"
+
+// Bytes buffered per write or read
+#define LINUX_WIRE_BUFFER 64
+// Messages and bytes held until the next STOP or read, I2C_RDWR sends at most 42 messages including the read
+#define LINUX_WIRE_MESSAGES 41
+#define LINUX_WIRE_HELD_BUFFER 512
+
+// Write-read of requestMany, see IQS7222_transport.h
+struct Transport_read;
+
+class TwoWire
+{
+public:
+	// Public methods
+	void begin(void);
+	void end(void);
+	void setClock(uint32_t frequency);
+	void beginTransmission(uint8_t address);
+	size_t write(uint8_t data);
+	size_t write(const uint8_t data[], size_t length);
+	uint8_t endTransmission(bool sendStop = true);
+	uint8_t requestFrom(uint8_t address, uint8_t quantity, bool sendStop = true);
+	int available(void);
+	int read(void);
+
+	// Linux specific
+	bool open(const char* path);
+	bool requestMany(uint8_t address, const Transport_read reads[], uint8_t numReads);
+
+private:
+	// Private variables
+	int _fd = -1;
+	bool _combined = false;		// True if the adapter supports I2C_RDWR
+	uint8_t _address = 0;
+	uint8_t _txBuffer[LINUX_WIRE_BUFFER];
+	uint8_t _txLength = 0;
+	uint8_t _heldBuffer[LINUX_WIRE_HELD_BUFFER];	// Writes waiting for the next STOP or read
+	uint8_t _heldLengths[LINUX_WIRE_MESSAGES];
+	uint8_t _heldAddresses[LINUX_WIRE_MESSAGES];
+	uint8_t _heldCount = 0;
+	uint16_t _heldBytes = 0;
+	uint8_t _rxBuffer[LINUX_WIRE_BUFFER];
+	uint8_t _rxLength = 0;
+	uint8_t _rxIndex = 0;
+
+	// Private methods
+	bool transfer(uint8_t readLength);
+	bool transferSmbus(uint8_t readLength);
+};
+
+extern TwoWire Wire;
+
+#endif // IQS7222_LINUX_WIRE_H
@@ -0,0 +1,290 @@
+/**
+  **********************************************************************************
+  * @file     IQS7222_mock_transport.cpp
+  * @author   Colin Laganier
+  * @version  V0.1
+  * @date     2026-10-18
+  * @brief   This file contains a simulated IQS7222 register file behind the bus transport
+  *          interface.
+  **********************************************************************************
+  * @attention  Host builds only.
+  */
+
+  // Include Files
+#include "IQS7222_mock_transport.h"
+
+/**************************************************************************************************************/
+/*                                              PUBLIC METHODS                                                */
+/**************************************************************************************************************/
+
+Mock_transport::Mock_transport(uint8_t deviceAddress)
+    : _deviceAddress(deviceAddress), _registers(0x10000, 0)
+{
+}
+
+/**
+  * @name   begin
+  * @brief  Method kept for the transport interface, the register file keeps its content.
+  * @param  None.
+  * @retval None.
+  * @notes  None.
+  */
+void Mock_transport::begin(void)
+{
+}
+
+/**
+  * @name   setClock
+  * @brief  Method to set the clock used by the bus time model.
+  * @param  frequency -> Clock frequency in Hz.
+  * @retval Returns true if the frequency is up to MOCK_MAX_CLOCK, returns false if not.
+  * @notes  None.
+  */
+bool Mock_transport::setClock(uint32_t frequency)
+{
+    if ((frequency == 0) || (frequency > MOCK_MAX_CLOCK))
+        return false;
+    _clock = frequency;
+    return true;
+}
+
+/**
+  * @name   write
+  * @brief  Method to write registers of the simulated device.
+  * @param  address -> 7bit address, transactions to other addresses are not acknowledged.
+  *         header, headerLength -> Register address, 1 byte for 8bit and 2 bytes (big endian) for 16bit addresses.
+  *         data, dataLength -> Payload.
+  *         stopOrRestart -> STOP closes the communication window.
+  * @retval Returns true if acknowledged, returns false if not.
+  * @notes  An empty write only addresses the device.
+  */
+bool Mock_transport::write(uint8_t address, const uint8_t header[], uint8_t headerLength,
+    const uint8_t data[], uint8_t dataLength, bool stopOrRestart)
+{
+    if (!accept(address, 2 + 9 * (1 + headerLength + dataLength), headerLength + dataLength, stopOrRestart))
+        return false;
+    if (headerLength == 0)
+        return true;
+
+    uint16_t memoryAddress = decodeAddress(header, headerLength);
+    for (uint8_t i = 0; i < dataLength; i++)
+    {
+        uint16_t& word = _registers[(uint16_t)(memoryAddress + (i >> 1))];
+        word = (i & 0x01) ? ((word & 0x00FF) | (data[i] << 8)) : ((word & 0xFF00) | data[i]);
+    }
+
+    // Acknowledging a reset clears the reset flag
+    if ((memoryAddress == CONTROL_SETTING) && (dataLength != 0) && (data[0] & ACK_RESET_BIT))
+    {
+        _registers[SYS_FLAGS] &= ~SHOW_RESET_BIT;
+        _registers[CONTROL_SETTING] &= ~ACK_RESET_BIT;
+    }
+    return true;
+}
+
+/**
+  * @name   writeRead
+  * @brief  Method to read registers of the simulated device.
+  * @param  address -> 7bit address, transactions to other addresses are not acknowledged.
+  *         tx, txLength -> Register address, 1 byte for 8bit and 2 bytes (big endian) for 16bit addresses.
+  *         rx, rxLength -> Buffer receiving the payload.
+  *         stopOrRestart -> STOP closes the communication window, always the case after setReadStop.
+  * @retval Returns true if acknowledged, returns false if not.
+  * @notes  None.
+  */
+bool Mock_transport::writeRead(uint8_t address, const uint8_t tx[], uint8_t txLength,
+    uint8_t rx[], uint8_t rxLength, bool stopOrRestart)
+{
+    return readRegisters(address, tx, txLength, rx, rxLength, stopOrRestart || _readStop);
+}
+
+/**
+  * @name   readMany
+  * @brief  Method to read several register blocks of the simulated device in one transaction.
+  * @param  address -> 7bit address, transactions to other addresses are not acknowledged.
+  *         reads -> The write-reads, in order.
+  *         numReads -> Number of write-reads.
+  *         stopOrRestart -> STOP closes the communication window after the last read, always the case after setReadStop.
+  * @retval Returns true if every read was acknowledged, returns false if not.
+  * @notes  The reads are joined by repeated starts, the window stays open until the last one.
+  */
+bool Mock_transport::readMany(uint8_t address, const Transport_read reads[], uint8_t numReads, bool stopOrRestart)
+{
+    for (uint8_t i = 0; i < numReads; i++)
+    {
+        bool last = (i == numReads - 1);
+        if (!readRegisters(address, reads[i].tx, reads[i].txLength, reads[i].rx, reads[i].rxLength,
+            last && (stopOrRestart || _readStop)))
+            return false;
+    }
+    return true;
+}
+
+/**
+  * @name   getRegister
+  * @brief  Method which returns a register of the simulated device.
+  * @param  address -> Register address.
+  * @retval The register value.
+  * @notes  None.
+  */
+uint16_t Mock_transport::getRegister(uint16_t address)
+{
+    return _registers[address];
+}
+
+/**
+  * @name   setRegister
+  * @brief  Method which sets a register of the simulated device.
+  * @param  address -> Register address.
+  *         value -> The register value.
+  * @retval None.
+  * @notes  None.
+  */
+void Mock_transport::setRegister(uint16_t address, uint16_t value)
+{
+    _registers[address] = value;
+}
+
+/**
+  * @name   failNext
+  * @brief  Method which makes the next transactions fail as if the device did not acknowledge them.
+  * @param  count -> Number of transactions to fail.
+  * @retval None.
+  * @notes  None.
+  */
+void Mock_transport::failNext(uint8_t count)
+{
+    _failNext = count;
+}
+
+/**
+  * @name   setReportPeriod
+  * @brief  Method which simulates the communication windows of a device read without the ready pin.
+  * @param  period -> Report period in microseconds, 0 to acknowledge every transaction.
+  * @retval None.
+  * @notes  A window opens at every multiple of period in micros() and closes at the next transaction ended with a STOP,
+  *         a report whose window is not closed before the next one opens is skipped.
+  */
+void Mock_transport::setReportPeriod(uint32_t period)
+{
+    _reportPeriod = period;
+    _servedReport = (period != 0) ? (micros() / period) : 0;
+}
+
+/**
+  * @name   setReadStop
+  * @brief  Method which simulates a transport whose reads always end with a STOP, as i2c-dev on Linux.
+  * @param  readStop -> True to end every read with a STOP, false to honour RESTART.
+  * @retval None.
+  * @notes  keepsWindow returns false while set, only readMany keeps several reads in one window.
+  */
+void Mock_transport::setReadStop(bool readStop)
+{
+    _readStop = readStop;
+}
+
+/**
+  * @name   getClock
+  * @brief  Method which returns the clock used by the bus time model.
+  * @param  None.
+  * @retval Clock frequency in Hz.
+  * @notes  None.
+  */
+uint32_t Mock_transport::getClock(void)
+{
+    return _clock;
+}
+
+/**
+  * @name   resetCounters
+  * @brief  Method which clears the transaction counters and the modelled bus time.
+  * @param  None.
+  * @retval None.
+  * @notes  None.
+  */
+void Mock_transport::resetCounters(void)
+{
+    transactions = 0;
+    failures = 0;
+    bytesMoved = 0;
+    windows = 0;
+    busTime = 0;
+}
+
+/**************************************************************************************************************/
+/*                                              PRIVATE METHODS                                               */
+/**************************************************************************************************************/
+
+/**
+  * @name   accept
+  * @brief  A method which accounts for a transaction and decides whether it is acknowledged.
+  * @param  address -> 7bit address of the transaction.
+  *         bits -> Bit times of the transaction on the bus.
+  *         length -> Bytes transferred after the address byte.
+  *         stopOrRestart -> STOP closes the communication window.
+  * @retval Returns true if acknowledged, returns false if not.
+  * @notes  A transaction which is not acknowledged only costs its address byte.
+  */
+bool Mock_transport::accept(uint8_t address, uint32_t bits, uint8_t length, bool stopOrRestart)
+{
+    uint32_t report = (_reportPeriod != 0) ? (micros() / _reportPeriod) : 0;
+
+    transactions++;
+    if ((address != _deviceAddress) || (_failNext != 0) || ((_reportPeriod != 0) && (report == _servedReport)))
+    {
+        if (_failNext != 0)
+            _failNext--;
+        failures++;
+        busTime += (uint64_t)(2 + 9) * 1000000000 / _clock;
+        return false;
+    }
+
+    bytesMoved += length;
+    busTime += (uint64_t)bits * 1000000000 / _clock;
+    if (stopOrRestart)
+    {
+        windows++;
+        _servedReport = report;
+    }
+    return true;
+}
+
+/**
+  * @name   decodeAddress
+  * @brief  A method which decodes a register address as sent on the bus.
+  * @param  bytes -> Address bytes.
+  *         length -> 1 for 8bit addresses, 2 for 16bit addresses sent high byte first.
+  * @retval The register address.
+  * @notes  None.
+  */
+uint16_t Mock_transport::decodeAddress(const uint8_t bytes[], uint8_t length)
+{
+    if (length == 1)
+        return bytes[0];
+    return (bytes[0] << 8) | bytes[1];
+}
+
+/**
+  * @name   readRegisters
+  * @brief  A method which accounts for a read transaction and copies the registers it reads.
+  * @param  address -> 7bit address of the transaction.
+  *         tx, txLength -> Register address, 1 byte for 8bit and 2 bytes (big endian) for 16bit addresses.
+  *         rx, rxLength -> Buffer receiving the payload.
+  *         stopOrRestart -> STOP closes the communication window.
+  * @retval Returns true if acknowledged, returns false if not.
+  * @notes  None.
+  */
+bool Mock_transport::readRegisters(uint8_t address, const uint8_t tx[], uint8_t txLength, uint8_t rx[], uint8_t rxLength,
+    bool stopOrRestart)
+{
+    if (!accept(address, 3 + 9 * (2 + txLength + rxLength), txLength + rxLength, stopOrRestart))
+        return false;
+
+    uint16_t memoryAddress = decodeAddress(tx, txLength);
+    for (uint8_t i = 0; i < rxLength; i++)
+    {
+        uint16_t word = _registers[(uint16_t)(memoryAddress + (i >> 1))];
+        rx[i] = (i & 0x01) ? (word >> 8) : (word & 0xFF);
+    }
+    return true;
+}
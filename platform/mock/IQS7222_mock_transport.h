@@ -0,0 +1,81 @@
+/**
+  **********************************************************************************
+  * @file     IQS7222_mock_transport.h
+  * @author   Colin Laganier
+  * @version  V0.1
+  * @date     2026-10-18
+  * @brief   This file contains a simulated IQS7222 register file behind the bus transport
+  *          interface, used to run the driver on a host without hardware.
+  **********************************************************************************
+  * @attention  Every register is a 16bit word, payload bytes map to consecutive words in
+  *             little endian order as on the device. Setting the ACK_RESET bit of
+  *             CONTROL_SETTING clears SHOW_RESET in SYS_FLAGS, no other device behaviour is
+  *             simulated: the test drives the flags, counts and LTA with setRegister.
+  *             The bus time of every transaction is modelled from its length and the clock
+  *             (9 bit times per byte plus start, repeated start and stop conditions).
+  *             With setReportPeriod the device only acknowledges inside a communication window,
+  *             one window opens every report period of micros() and closes at the next STOP.
+  *             With setReadStop every read ends with a STOP as on Linux, only readMany serves
+  *             several reads in one window.
+  */
+
+#ifndef IQS7222_MOCK_TRANSPORT_H
+#define IQS7222_MOCK_TRANSPORT_H
+
+// Include Files
+#include <vector>
+#include "IQS7222.h"
+
+// Default 7bit address of the IQS7222C
+#define MOCK_DEFAULT_ADDRESS 0x44
+// Highest bus clock accepted by setClock, in Hz
+#define MOCK_MAX_CLOCK 1000000
+
+class Mock_transport : public IQS7222_transport
+{
+public:
+	// Public constructor
+	Mock_transport(uint8_t deviceAddress = MOCK_DEFAULT_ADDRESS);
+
+	// Public variables
+	uint32_t transactions = 0;	// Transactions addressed to the device, including failed ones
+	uint32_t failures = 0;		// Transactions not acknowledged
+	uint32_t bytesMoved = 0;	// Payload and address bytes transferred
+	uint32_t windows = 0;		// Transactions ended with a STOP, i.e. communication windows closed
+	uint64_t busTime = 0;		// Modelled bus time in nanoseconds
+
+	// Public methods
+	void begin(void) override;
+	bool setClock(uint32_t frequency) override;
+	bool write(uint8_t address, const uint8_t header[], uint8_t headerLength,
+		const uint8_t data[], uint8_t dataLength, bool stopOrRestart) override;
+	bool writeRead(uint8_t address, const uint8_t tx[], uint8_t txLength,
+		uint8_t rx[], uint8_t rxLength, bool stopOrRestart) override;
+	bool readMany(uint8_t address, const Transport_read reads[], uint8_t numReads, bool stopOrRestart) override;
+	bool keepsWindow(void) override { return !_readStop; }
+	uint16_t getRegister(uint16_t address);
+	void setRegister(uint16_t address, uint16_t value);
+	void failNext(uint8_t count);
+	void setReportPeriod(uint32_t period);
+	void setReadStop(bool readStop);
+	uint32_t getClock(void);
+	void resetCounters(void);
+
+private:
+	// Private variables
+	uint8_t _deviceAddress;
+	uint32_t _clock = 100000;
+	uint8_t _failNext = 0;
+	uint32_t _reportPeriod = 0;		// Report period in microseconds, 0 acknowledges at any time
+	uint32_t _servedReport = 0;		// Report whose window was closed by a STOP
+	bool _readStop = false;			// True if every read ends with a STOP
+	std::vector<uint16_t> _registers;
+
+	// Private methods
+	bool accept(uint8_t address, uint32_t bits, uint8_t length, bool stopOrRestart);
+	uint16_t decodeAddress(const uint8_t bytes[], uint8_t length);
+	bool readRegisters(uint8_t address, const uint8_t tx[], uint8_t txLength, uint8_t rx[], uint8_t rxLength,
+		bool stopOrRestart);
+};
+
+#endif // IQS7222_MOCK_TRANSPORT_H
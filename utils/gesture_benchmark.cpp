@@ -0,0 +1,462 @@
+/**
+  **********************************************************************************
+  * @file     gesture_benchmark.cpp
+  * @author   Colin Laganier
+  * @version  V0.1
+  * @date     2026-10-18
+  * @brief   This file contains a host benchmark of the gesture recognition: synthetic
+  *          finger trajectories are rendered into reports of a simulated device and fed
+  *          through the driver, precision, recall, latency and CPU time are reported.
+  **********************************************************************************
+  * @attention  Build from the repository root:
+  *               g++ -std=gnu++11 -O2 -Iplatform/linux -Iplatform/mock -I. -DIQS7222_MAGNETIC
+  *                 utils/gesture_benchmark.cpp IQS7222*.cpp platform/linux/Arduino.cpp platform/linux/Wire.cpp
+  *                 platform/linux/IQS7222_linux_transport.cpp platform/mock/IQS7222_mock_transport.cpp
+  *                 -pthread -o gesture_benchmark
+  *             Usage: gesture_benchmark [trials per gesture] [speed in cells/s] [noise in counts]
+  *                                      [multi-touch rate] [seed]
+  *             The clock is simulated, the run takes a fraction of the simulated time.
+  */
+
+  // Include Files
+#include "IQS7222_mock_transport.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <vector>
+
+// Simulated device
+#define BENCH_REPORT_PERIOD 10000		// Report period, in microseconds
+#define BENCH_LTA 1000					// LTA of every channel
+#define BENCH_FINGER_DELTA 400			// Delta of a channel under the centre of a finger
+#define BENCH_FINGER_SIGMA 0.45f		// Radius of the footprint of a finger, in grid cells
+#define BENCH_TOUCH_THRESHOLD 120		// Delta which sets the touch flag of a channel
+#define BENCH_TOUCH_RELEASE 90			// Delta below which the touch flag is cleared
+#define BENCH_PROX_THRESHOLD 40			// Delta which sets the prox flag of a channel
+
+// Trials, times in microseconds
+#define BENCH_RAMP_TIME 20000			// Time a finger takes to land or lift
+#define BENCH_IDLE_TIME 400000			// Time without touch before each trial
+#define BENCH_TAIL_TIME 800000			// Time after the decision point during which a detection counts for the trial
+#define BENCH_TAP_TIME 80000
+#define BENCH_DOUBLE_TAP_GAP 150000
+#define BENCH_LONG_PRESS_TIME 900000
+#define BENCH_JITTER 0.15f				// Largest random offset of a trajectory, in grid cells
+#define BENCH_SPEED_SPREAD 0.2f			// Largest relative deviation of the speed of a trial
+
+// Gestures synthesised, the last class is the trials which must not be recognised
+static const uint8_t benchClasses[] = {
+    GESTURE_SWIPE_UP, GESTURE_SWIPE_DOWN, GESTURE_SWIPE_LEFT, GESTURE_SWIPE_RIGHT, GESTURE_CIRCLE_CW,
+    GESTURE_CIRCLE_CCW, GESTURE_TAP, GESTURE_DOUBLE_TAP, GESTURE_LONG_PRESS, GESTURE_NONE
+};
+static const char* benchClassNames[] = {
+    "swipe up", "swipe down", "swipe left", "swipe right", "circle cw", "circle ccw", "tap", "double tap",
+    "long press", "none"
+};
+#define BENCH_NUM_CLASSES (sizeof(benchClasses) / sizeof(benchClasses[0]))
+
+// Finger moving along a polyline at constant speed, x to the right and y up in grid cells
+typedef struct {
+    uint32_t start;
+    uint32_t end;
+    std::vector<float> x;
+    std::vector<float> y;
+} Bench_stroke;
+
+typedef struct {
+    uint8_t expected;		// Index in benchClasses
+    uint32_t decision;		// Time from which the gesture can be recognised, relative to the trial start
+    uint32_t length;		// Duration of the trial, relative to the trial start
+    std::vector<Bench_stroke> strokes;
+} Bench_trial;
+
+typedef struct {
+    uint32_t trials;
+    uint32_t truePositives;	// Recognised as expected, left unrecognised for the GESTURE_NONE class
+    uint32_t falsePositives;
+    uint32_t falseNegatives;
+    uint32_t extra;			// Detections of a trial beyond the one scored
+    std::vector<uint32_t> latencies;
+} Bench_result;
+
+// Recognition engine under test, add replacement engines to main
+class Bench_engine
+{
+public:
+    virtual ~Bench_engine() {}
+    virtual const char* name(void) = 0;
+    virtual void reset(IQS7222& device) = 0;
+    virtual uint8_t report(IQS7222& device, const Sensor_snapshot& snapshot) = 0;
+};
+
+// Template engine of the driver, see IQS7222::updateGesture
+class Template_engine : public Bench_engine
+{
+public:
+    const char* name(void) override { return "templates"; }
+    void reset(IQS7222& device) override { device.useGestureTemplates(NULL, 0); }
+    uint8_t report(IQS7222& device, const Sensor_snapshot& snapshot) override
+    {
+        (void)snapshot;
+        return device.updateGesture();
+    }
+};
+
+// Legacy swipe history of the driver, see IQS7222::addTouch, it only recognises vertical swipes
+class Legacy_engine : public Bench_engine
+{
+public:
+    const char* name(void) override { return "legacy"; }
+    void reset(IQS7222& device) override { device.clearTouch(); }
+    uint8_t report(IQS7222& device, const Sensor_snapshot& snapshot) override
+    {
+        DIRECTION swipe = device.addTouch(snapshot);
+        return (swipe == NO_SWIPE) ? GESTURE_NONE : (GESTURE_SWIPE + swipe);
+    }
+};
+
+/**************************************************************************************************************/
+/*                                                TRAJECTORIES                                                */
+/**************************************************************************************************************/
+
+/**
+  * @name   makeStroke
+  * @brief  Builds a stroke along a polyline at a given speed.
+  * @param  start -> Time the finger lands, relative to the trial start.
+  *         x, y -> Points of the polyline.
+  *         speed -> Speed in cells per second, 0 for a still finger held for hold microseconds.
+  *         hold -> Duration of a still finger.
+  * @retval The stroke, including the landing and lifting ramps.
+  * @notes  None.
+  */
+static Bench_stroke makeStroke(uint32_t start, const std::vector<float>& x, const std::vector<float>& y, float speed, uint32_t hold)
+{
+    Bench_stroke stroke;
+    float length = 0;
+
+    for (size_t i = 1; i < x.size(); i++)
+        length += std::hypot(x[i] - x[i - 1], y[i] - y[i - 1]);
+
+    stroke.start = start;
+    stroke.end = start + 2 * BENCH_RAMP_TIME + ((speed > 0) ? (uint32_t)(length / speed * 1e6f) : hold);
+    stroke.x = x;
+    stroke.y = y;
+    return stroke;
+}
+
+/**
+  * @name   makeTrial
+  * @brief  Synthesises a trial of a gesture class.
+  * @param  expected -> Index in benchClasses.
+  *         speed -> Nominal speed of the finger in cells per second.
+  *         random -> Random generator.
+  * @retval The trial.
+  * @notes  Each trial starts from a random cell or column and speed. Trials of GESTURE_NONE have no touch.
+  */
+static Bench_trial makeTrial(uint8_t expected, float speed, std::mt19937& random)
+{
+    std::uniform_real_distribution<float> jitter(-BENCH_JITTER, BENCH_JITTER);
+    std::uniform_real_distribution<float> spread(1 - BENCH_SPEED_SPREAD, 1 + BENCH_SPEED_SPREAD);
+    float dx = jitter(random), dy = jitter(random);
+    float column = (float)(random() % IQS7222_GRID_COLS) + dx;
+    float row = (float)(random() % IQS7222_GRID_ROWS) + dy;
+    float top = IQS7222_GRID_ROWS - 1 + 0.4f, right = IQS7222_GRID_COLS - 1 + 0.4f;
+    Bench_trial trial;
+
+    speed *= spread(random);
+    trial.expected = expected;
+    switch (benchClasses[expected])
+    {
+    case GESTURE_SWIPE_UP:
+        trial.strokes.push_back(makeStroke(BENCH_IDLE_TIME, { column, column }, { -0.4f, top }, speed, 0));
+        break;
+    case GESTURE_SWIPE_DOWN:
+        trial.strokes.push_back(makeStroke(BENCH_IDLE_TIME, { column, column }, { top, -0.4f }, speed, 0));
+        break;
+    case GESTURE_SWIPE_LEFT:
+        trial.strokes.push_back(makeStroke(BENCH_IDLE_TIME, { right, -0.4f }, { row, row }, speed, 0));
+        break;
+    case GESTURE_SWIPE_RIGHT:
+        trial.strokes.push_back(makeStroke(BENCH_IDLE_TIME, { -0.4f, right }, { row, row }, speed, 0));
+        break;
+    case GESTURE_CIRCLE_CW:
+    case GESTURE_CIRCLE_CCW:
+    {
+        // From the bottom of the grid, clockwise goes left first
+        float direction = (benchClasses[expected] == GESTURE_CIRCLE_CW) ? -1.0f : 1.0f;
+        std::vector<float> x, y;
+        for (int i = 0; i <= 16; i++)
+        {
+            float angle = -(float)M_PI / 2 + direction * 2 * (float)M_PI * i / 16;
+            x.push_back((IQS7222_GRID_COLS - 1) / 2.0f + dx + (IQS7222_GRID_COLS / 2.0f) * std::cos(angle));
+            y.push_back((IQS7222_GRID_ROWS - 1) / 2.0f + dy + (IQS7222_GRID_ROWS / 2.0f) * std::sin(angle));
+        }
+        trial.strokes.push_back(makeStroke(BENCH_IDLE_TIME, x, y, speed, 0));
+        break;
+    }
+    case GESTURE_TAP:
+        trial.strokes.push_back(makeStroke(BENCH_IDLE_TIME, { column }, { row }, 0, BENCH_TAP_TIME));
+        break;
+    case GESTURE_DOUBLE_TAP:
+        trial.strokes.push_back(makeStroke(BENCH_IDLE_TIME, { column }, { row }, 0, BENCH_TAP_TIME));
+        trial.strokes.push_back(makeStroke(trial.strokes[0].end + BENCH_DOUBLE_TAP_GAP, { column }, { row }, 0, BENCH_TAP_TIME));
+        break;
+    case GESTURE_LONG_PRESS:
+        trial.strokes.push_back(makeStroke(BENCH_IDLE_TIME, { column }, { row }, 0, BENCH_LONG_PRESS_TIME));
+        break;
+    default:
+        break;
+    }
+
+    if (benchClasses[expected] == GESTURE_LONG_PRESS)
+        trial.decision = BENCH_IDLE_TIME + GESTURE_LONG_PRESS_TIME * 1000;
+    else
+        trial.decision = trial.strokes.empty() ? BENCH_IDLE_TIME : trial.strokes.back().end;
+    trial.length = trial.decision + BENCH_TAIL_TIME;
+    if (!trial.strokes.empty())
+        trial.length = std::max(trial.length, trial.strokes.back().end + BENCH_TAIL_TIME);
+    return trial;
+}
+
+/**
+  * @name   addSecondFinger
+  * @brief  Turns a trial into a multi-touch trial which must not be recognised.
+  * @param  trial -> The trial, its expected class becomes GESTURE_NONE.
+  *         random -> Random generator.
+  * @retval None.
+  * @notes  A still finger lands on a random cell for the middle 40% of the first stroke.
+  */
+static void addSecondFinger(Bench_trial& trial, std::mt19937& random)
+{
+    const Bench_stroke& first = trial.strokes[0];
+    uint32_t duration = first.end - first.start;
+    float column = (float)(random() % IQS7222_GRID_COLS);
+    float row = (float)(random() % IQS7222_GRID_ROWS);
+
+    trial.strokes.push_back(makeStroke(first.start + duration * 3 / 10, { column }, { row }, 0, duration * 4 / 10));
+    trial.expected = BENCH_NUM_CLASSES - 1;
+}
+
+/**
+  * @name   fingerAt
+  * @brief  Returns the position and pressure of the finger of a stroke.
+  * @param  stroke -> The stroke.
+  *         time -> Time relative to the trial start.
+  *         x, y -> Receive the position in grid cells.
+  * @retval Pressure from 0 (not touching) to 1.
+  * @notes  The finger moves along the polyline between the end of its landing ramp and the start of its lifting ramp.
+  */
+static float fingerAt(const Bench_stroke& stroke, uint32_t time, float& x, float& y)
+{
+    if ((time < stroke.start) || (time >= stroke.end))
+        return 0;
+
+    uint32_t moving = stroke.end - stroke.start - 2 * BENCH_RAMP_TIME;
+    float progress = (moving == 0) ? 0 : std::min(std::max((float)((int32_t)(time - stroke.start) - BENCH_RAMP_TIME) / moving, 0.0f), 1.0f);
+    float length = 0, target;
+
+    for (size_t i = 1; i < stroke.x.size(); i++)
+        length += std::hypot(stroke.x[i] - stroke.x[i - 1], stroke.y[i] - stroke.y[i - 1]);
+    target = progress * length;
+    x = stroke.x[0];
+    y = stroke.y[0];
+    for (size_t i = 1; i < stroke.x.size(); i++)
+    {
+        float segment = std::hypot(stroke.x[i] - stroke.x[i - 1], stroke.y[i] - stroke.y[i - 1]);
+        float part = (segment > 0) ? std::min(target / segment, 1.0f) : 1.0f;
+        x = stroke.x[i - 1] + part * (stroke.x[i] - stroke.x[i - 1]);
+        y = stroke.y[i - 1] + part * (stroke.y[i] - stroke.y[i - 1]);
+        target -= segment;
+        if (target <= 0)
+            break;
+    }
+
+    uint32_t edge = std::min(time - stroke.start, stroke.end - time);
+    return std::min((float)edge / BENCH_RAMP_TIME, 1.0f);
+}
+
+/**
+  * @name   renderReport
+  * @brief  Writes the flags, counts and LTA of a report into the simulated device.
+  * @param  mock -> The simulated device.
+  *         trial -> The trial.
+  *         time -> Time relative to the trial start.
+  *         noise -> Standard deviation of the count noise.
+  *         touched -> Touch flags of the previous report, updated, for the release hysteresis.
+  *         random -> Random generator.
+  * @retval None.
+  * @notes  Each finger adds a Gaussian footprint of BENCH_FINGER_SIGMA to the channels of the grid.
+  */
+static void renderReport(Mock_transport& mock, const Bench_trial& trial, uint32_t time, float noise, uint16_t& touched, std::mt19937& random)
+{
+    std::normal_distribution<float> countNoise(0, noise);
+    uint16_t prox = 0;
+
+    for (uint8_t i = 0; i < IQS7222_NUM_CHANNELS; i++)
+    {
+        float delta = (noise > 0) ? countNoise(random) : 0;
+
+        if (layoutColumnTable[i] >= 0)
+        {
+            for (const Bench_stroke& stroke : trial.strokes)
+            {
+                float x = 0, y = 0;
+                float pressure = fingerAt(stroke, time, x, y);
+                float distance = std::hypot(x - layoutColumnTable[i], y - layoutRowTable[i]);
+                delta += pressure * BENCH_FINGER_DELTA * std::exp(-distance * distance / (2 * BENCH_FINGER_SIGMA * BENCH_FINGER_SIGMA));
+            }
+        }
+
+        if (delta >= BENCH_PROX_THRESHOLD)
+            prox |= 0x01 << i;
+        if (delta >= BENCH_TOUCH_THRESHOLD)
+            touched |= 0x01 << i;
+        else if (delta < BENCH_TOUCH_RELEASE)
+            touched &= ~(0x01 << i);
+        mock.setRegister(CH0_COUNTS + i, (uint16_t)std::max(BENCH_LTA + (int32_t)std::lround(delta), (int32_t)0));
+        mock.setRegister(CH0_LTA + i, BENCH_LTA);
+    }
+    mock.setRegister(PROX_FLAGS, prox);
+    mock.setRegister(TOUCH_FLAGS, touched);
+    mock.setRegister(EVENT_FLAGS, ((prox != 0) ? PROX : 0) | ((touched != 0) ? TOUCH : 0));
+}
+
+/**************************************************************************************************************/
+/*                                                   MAIN                                                     */
+/**************************************************************************************************************/
+
+/**
+  * @name   runEngine
+  * @brief  Runs every trial through an engine and prints the scores.
+  * @param  engine -> The engine under test.
+  *         trials -> The trials.
+  *         noise -> Standard deviation of the count noise.
+  *         seed -> Seed of the noise.
+  * @retval None.
+  * @notes  The class of a trial is the last gesture recognised between its start and its end, so that the tap reported
+  *         before a double tap is not scored. Latency is from the decision point (last lift, or the long press time) to
+  *         the report which recognised the gesture.
+  */
+static void runEngine(Bench_engine& engine, const std::vector<Bench_trial>& trials, float noise, uint32_t seed)
+{
+    static IQS7222 device;
+    Mock_transport mock;
+    Sensor_snapshot snapshot;
+    std::mt19937 random(seed);
+    Bench_result results[BENCH_NUM_CLASSES] = {};
+    uint64_t decodeTime = 0, recogniseTime = 0, reports = 0;
+    uint16_t touched = 0;
+
+    device.setTransport(mock);
+    device.beginHeadless(MOCK_DEFAULT_ADDRESS);
+    engine.reset(device);
+
+    for (const Bench_trial& trial : trials)
+    {
+        uint32_t trialStart = micros();
+        uint8_t scored = GESTURE_NONE;
+        uint32_t scoredTime = 0;
+        uint32_t detections = 0;
+
+        for (uint32_t time = 0; time < trial.length; time += BENCH_REPORT_PERIOD)
+        {
+            linuxAdvanceTime(trialStart + time - micros());
+            renderReport(mock, trial, time, noise, touched, random);
+
+            auto begin = std::chrono::steady_clock::now();
+            device.updateStream(snapshot, STOP);
+            auto decoded = std::chrono::steady_clock::now();
+            uint8_t gesture = engine.report(device, snapshot);
+            auto recognised = std::chrono::steady_clock::now();
+
+            decodeTime += std::chrono::duration_cast<std::chrono::nanoseconds>(decoded - begin).count();
+            recogniseTime += std::chrono::duration_cast<std::chrono::nanoseconds>(recognised - decoded).count();
+            reports++;
+            if (gesture != GESTURE_NONE)
+            {
+                scored = gesture;
+                scoredTime = time;
+                detections++;
+            }
+        }
+
+        Bench_result& expected = results[trial.expected];
+        uint8_t expectedGesture = benchClasses[trial.expected];
+        expected.trials++;
+        expected.extra += (detections > 1) ? (detections - 1) : 0;
+        if (scored == expectedGesture)
+        {
+            expected.truePositives++;
+            if (scored != GESTURE_NONE)
+                expected.latencies.push_back((scoredTime > trial.decision) ? (scoredTime - trial.decision) : 0);
+            continue;
+        }
+        if (expectedGesture != GESTURE_NONE)
+            expected.falseNegatives++;
+        for (uint8_t i = 0; i < BENCH_NUM_CLASSES; i++)
+        {
+            if ((scored != GESTURE_NONE) && (benchClasses[i] == scored))
+                results[i].falsePositives++;
+        }
+    }
+
+    printf("Engine %s, %llu reports, decode %.0f ns/report, recognise %.0f ns/report\n", engine.name(),
+        (unsigned long long)reports, (double)decodeTime / reports, (double)recogniseTime / reports);
+    printf("  %-12s %6s %9s %7s %8s %8s %6s\n", "gesture", "trials", "precision", "recall", "lat p50", "lat p95", "extra");
+    for (uint8_t i = 0; i < BENCH_NUM_CLASSES; i++)
+    {
+        Bench_result& result = results[i];
+        std::sort(result.latencies.begin(), result.latencies.end());
+        uint32_t detected = result.truePositives + result.falsePositives;
+        uint32_t present = result.truePositives + result.falseNegatives;
+        uint32_t p50 = result.latencies.empty() ? 0 : result.latencies[result.latencies.size() / 2];
+        uint32_t p95 = result.latencies.empty() ? 0 : result.latencies[result.latencies.size() * 95 / 100];
+
+        if (benchClasses[i] == GESTURE_NONE)
+        {
+            // Trials which must not be recognised, the recall is the share left unrecognised
+            printf("  %-12s %6u %9s %6.1f%% %8s %8s %6u\n", benchClassNames[i], result.trials, "-",
+                result.trials ? 100.0 * result.truePositives / result.trials : 0.0, "-", "-", result.extra);
+            continue;
+        }
+        printf("  %-12s %6u %8.1f%% %6.1f%% %6.1fms %6.1fms %6u\n", benchClassNames[i], result.trials,
+            detected ? 100.0 * result.truePositives / detected : 0.0, present ? 100.0 * result.truePositives / present : 0.0,
+            p50 / 1000.0, p95 / 1000.0, result.extra);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    uint32_t trialsPerGesture = (argc > 1) ? atoi(argv[1]) : 50;
+    float speed = (argc > 2) ? atof(argv[2]) : 4.0f;
+    float noise = (argc > 3) ? atof(argv[3]) : 8.0f;
+    float multiTouchRate = (argc > 4) ? atof(argv[4]) : 0.1f;
+    uint32_t seed = (argc > 5) ? atoi(argv[5]) : 1;
+    std::mt19937 random(seed);
+    std::uniform_real_distribution<float> chance(0, 1);
+    std::vector<Bench_trial> trials;
+    Template_engine templateEngine;
+    Legacy_engine legacyEngine;
+    Bench_engine* engines[] = { &templateEngine, &legacyEngine };
+
+    linuxSimulateTime(true);
+    linuxPlatformBegin("/dev/null", NULL);
+
+    for (uint8_t expected = 0; expected < BENCH_NUM_CLASSES; expected++)
+    {
+        for (uint32_t i = 0; i < trialsPerGesture; i++)
+        {
+            trials.push_back(makeTrial(expected, speed, random));
+            if (!trials.back().strokes.empty() && (chance(random) < multiTouchRate))
+                addSecondFinger(trials.back(), random);
+        }
+    }
+    std::shuffle(trials.begin(), trials.end(), random);
+
+    printf("%u trials, speed %.1f cells/s, noise %.1f counts, multi-touch rate %.2f, seed %u\n",
+        (unsigned)trials.size(), speed, noise, multiTouchRate, seed);
+    for (Bench_engine* engine : engines)
+        runEngine(*engine, trials, noise, seed);
+    return 0;
+}
@@ -0,0 +1,161 @@
+#!/usr/bin/env python3
+
+# Correlates the MCU clock with the host clock and reports the end to end latency of the IQS7222 reports.
+# Usage: latency_monitor.py <serial port | pipe | -> [baud rate] [report interval in seconds]
+# The MCU sends one line per report, written with IQS7222::formatSnapshot:
+#   IQS,readyTick,readTick,sendTick,systemFlags,eventFlags,proxFlags,touchFlags,slider0,slider1
+# The ticks are micros() of the MCU. Lines which do not start with the prefix are ignored.
+
+import collections
+import sys
+import time
+
+from trace_to_perfetto import Unwrapper
+
+linePrefix = "IQS"
+segmentTime = 2000000		# Host time covered by one segment of the envelope, in microseconds
+maxSegments = 60			# Segments kept for the fit, i.e. the drift is estimated over the last 2 minutes
+historyLength = 1000		# Latency samples kept per stage for the percentiles
+stageNames = ["RDY -> read", "read -> send", "send -> host", "RDY -> host"]
+
+# Maps the MCU ticks to the host monotonic clock
+# The transmission delay of a line is never negative, so the smallest (arrival - sendTick) of each segment is the line
+# sent with the least delay. A line is fitted through these minima (offset and drift) and lowered until no minimum is
+# below it, the mapped send time of a line is then never after its arrival. A constant delay cannot be told apart from
+# the offset, the known time of the line on the wire is removed before the fit and the rest is part of the latency.
+class ClockCorrelator:
+	def __init__(self):
+		self.segments = collections.deque(maxlen=maxSegments)
+		self.offset = None
+		self.drift = 0.0
+		self.origin = None
+
+	def add(self, tick, arrival):
+		if self.origin is None:
+			self.origin = tick
+		offset = arrival - tick
+		if self.segments and ((arrival - self.segments[-1][2]) < segmentTime):
+			if offset < self.segments[-1][1]:
+				self.segments[-1] = (tick, offset, self.segments[-1][2])
+		else:
+			self.segments.append((tick, offset, arrival))
+		self.fit()
+
+	def fit(self):
+		if len(self.segments) < 2:
+			self.offset = min(offset for _, offset, _ in self.segments)
+			self.drift = 0.0
+			return
+
+		ticks = [tick - self.origin for tick, _, _ in self.segments]
+		offsets = [offset for _, offset, _ in self.segments]
+		meanTick = sum(ticks) / len(ticks)
+		meanOffset = sum(offsets) / len(offsets)
+		variance = sum((tick - meanTick) ** 2 for tick in ticks)
+		self.drift = sum((tick - meanTick) * (offset - meanOffset) for tick, offset in zip(ticks, offsets)) / variance if variance else 0.0
+		self.offset = meanOffset - self.drift * meanTick
+		self.offset += min(offset - (self.offset + self.drift * tick) for tick, offset in zip(ticks, offsets))
+
+	def toHost(self, tick):
+		return tick + self.offset + self.drift * (tick - self.origin)
+
+	# Rate error of the MCU clock, positive if it runs fast
+	def driftPpm(self):
+		return -self.drift * 1e6
+
+# Keeps the last latency samples of a stage
+class LatencyHistory:
+	def __init__(self):
+		self.samples = collections.deque(maxlen=historyLength)
+
+	def add(self, latency):
+		self.samples.append(latency)
+
+	def percentiles(self, fractions):
+		ordered = sorted(self.samples)
+		if not ordered:
+			return [0.0 for _ in fractions]
+		return [ordered[min(int(fraction * len(ordered)), len(ordered) - 1)] for fraction in fractions]
+
+# Parses a line, returns the three ticks and the flags, None if the line is not a report
+def parseLine(line):
+	fields = line.strip().split(",")
+	if (len(fields) < 10) or (fields[0] != linePrefix):
+		return None
+	try:
+		ticks = [int(field) for field in fields[1:4]]
+		flags = [int(field, 16) for field in fields[4:8]]
+	except ValueError:
+		return None
+	return ticks, flags
+
+# Reads the lines with the host monotonic time of their arrival and their time on the wire, in microseconds
+# A pipe or stdin must be fed live (e.g. by socat), the arrival time of a replayed file means nothing
+def readLines(source, baudRate):
+	isSerial = source.startswith("/dev/tty") or source.upper().startswith("COM")
+	if source == "-":
+		stream = sys.stdin
+	elif isSerial:
+		import serial
+		stream = serial.Serial(source, baudRate, timeout=1)
+	else:
+		stream = open(source, "r")
+
+	while True:
+		line = stream.readline()
+		arrival = time.monotonic_ns() // 1000
+		if not line:
+			if not isSerial:
+				return
+			continue
+		if isinstance(line, bytes):
+			line = line.decode("ascii", errors="replace")
+		# 10 bit times per character on a UART, the line arrives with its last character
+		yield line, arrival, (len(line) * 10 * 1000000 / baudRate) if isSerial else 0
+
+def printReport(histories, correlator, reports, touches):
+	print(f"{reports} reports, {touches} with touch, drift {correlator.driftPpm():+.1f} ppm")
+	for name, history in zip(stageNames, histories):
+		p50, p90, p99, worst = history.percentiles([0.5, 0.9, 0.99, 1.0])
+		print(f"  {name:<13} p50 {p50 / 1000:7.3f} ms  p90 {p90 / 1000:7.3f} ms  p99 {p99 / 1000:7.3f} ms  max {worst / 1000:7.3f} ms")
+
+
+if __name__ == "__main__":
+	if len(sys.argv) < 2:
+		print("Usage: latency_monitor.py <serial port | pipe | -> [baud rate] [report interval in seconds]")
+		sys.exit(1)
+
+	baudRate = int(sys.argv[2]) if len(sys.argv) > 2 else 115200
+	interval = float(sys.argv[3]) if len(sys.argv) > 3 else 5.0
+
+	unwrappers = [Unwrapper() for _ in range(3)]
+	correlator = ClockCorrelator()
+	histories = [LatencyHistory() for _ in stageNames]
+	reports = touches = 0
+	nextReport = time.monotonic() + interval
+
+	for line, arrival, wireTime in readLines(sys.argv[1], baudRate):
+		parsed = parseLine(line)
+		if parsed is None:
+			continue
+		(readyTick, readTick, sendTick), flags = parsed
+
+		# The three ticks wrap together, unwrap each against its own history
+		readyTick = unwrappers[0].unwrap(readyTick)
+		readTick = unwrappers[1].unwrap(readTick)
+		sendTick = unwrappers[2].unwrap(sendTick)
+		correlator.add(sendTick, arrival - wireTime)
+
+		histories[0].add(readTick - readyTick)
+		histories[1].add(sendTick - readTick)
+		histories[2].add(arrival - correlator.toHost(sendTick))
+		histories[3].add(arrival - correlator.toHost(readyTick))
+		reports += 1
+		if flags[3] != 0:
+			touches += 1
+
+		if time.monotonic() >= nextReport:
+			printReport(histories, correlator, reports, touches)
+			nextReport += interval
+
+	printReport(histories, correlator, reports, touches)
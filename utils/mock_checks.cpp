@@ -0,0 +1,166 @@
+/**
+  **********************************************************************************
+  * @file     mock_checks.cpp
+  * @author   Colin Laganier
+  * @version  V0.1
+  * @date     2026-10-18
+  * @brief   This file contains host checks of the driver against the simulated device:
+  *          bus clock selection and fallback, conversion cycle pruning, the report
+  *          period estimate and the reads of a report in one communication window.
+  **********************************************************************************
+  * @attention  Build from the repository root:
+  *               g++ -std=gnu++11 -O2 -Iplatform/linux -Iplatform/mock -I. -DIQS7222_MAGNETIC
+  *                 utils/mock_checks.cpp IQS7222*.cpp platform/linux/Arduino.cpp platform/linux/Wire.cpp
+  *                 platform/linux/IQS7222_linux_transport.cpp platform/mock/IQS7222_mock_transport.cpp
+  *                 -pthread -o mock_checks
+  *             Usage: mock_checks
+  *             Prints every check and returns the number of failed checks.
+  */
+
+  // Include Files
+#include "IQS7222_mock_transport.h"
+#include <cstdio>
+
+// Counts written to every channel before estimating the report period
+#define CHECK_COUNTS 1000
+// Report period of the windowed checks, in microseconds
+#define CHECK_REPORT_PERIOD 10000
+#define CHECK_REPORTS 10
+
+static uint32_t checkFailures = 0;
+
+/**
+  * @name   check
+  * @brief  Prints the outcome of a check and counts the failures.
+  * @param  passed -> The outcome.
+  *         name -> Description of the check.
+  * @retval None.
+  * @notes  None.
+  */
+static void check(bool passed, const char* name)
+{
+    printf("%s  %s\n", passed ? "pass" : "FAIL", name);
+    if (!passed)
+        checkFailures++;
+}
+
+/**
+  * @name   checkClock
+  * @brief  Checks the bus clock selected by probeClock and its fallback on NACKs.
+  * @param  None.
+  * @retval None.
+  * @notes  The mock accepts every clock up to MOCK_MAX_CLOCK and never corrupts a read, so the probe settles at 1 MHz.
+  */
+static void checkClock(void)
+{
+    IQS7222 device;
+    Mock_transport mock;
+    Mock_transport absent(MOCK_DEFAULT_ADDRESS + 1);
+    Sensor_snapshot snapshot;
+
+    device.setTransport(mock);
+    check(device.beginHeadless(MOCK_DEFAULT_ADDRESS), "beginHeadless finds the device");
+    check((device.getClock() == BUS_CLOCK_FAST_PLUS) && (mock.getClock() == BUS_CLOCK_FAST_PLUS),
+        "probeClock settles at 1 MHz");
+
+    // BUS_ERROR_LIMIT failed transactions lower the clock by one step
+    mock.failNext(BUS_ERROR_LIMIT);
+    for (uint8_t i = 0; i < 3; i++)
+        device.updateStream(snapshot, STOP);
+    check((device.getClock() == BUS_CLOCK_FAST) && (mock.getClock() == BUS_CLOCK_FAST),
+        "NACKed reads lower the clock to 400 kHz");
+
+    device.setTransport(absent);
+    check(!device.beginHeadless(MOCK_DEFAULT_ADDRESS), "beginHeadless fails without a device");
+}
+
+/**
+  * @name   checkCycles
+  * @brief  Checks the conversion cycles enabled by the initial setup and the report period estimate.
+  * @param  None.
+  * @retval None.
+  * @notes  The magnetic layout converts its grid in cycles 1 to 3, cycle 0 is pruned by the initial setup.
+  */
+static void checkCycles(void)
+{
+    IQS7222 device;
+    Mock_transport mock;
+    IQS7222_profile profile;
+    uint32_t pruned;
+    uint32_t full;
+
+    device.setTransport(mock);
+    device.beginHeadless(MOCK_DEFAULT_ADDRESS);
+    for (uint8_t i = 0; i < IQS7222_NUM_CHANNELS; i++)
+        mock.setRegister(CH0_COUNTS + i, CHECK_COUNTS);
+
+    check((layoutCycles == 0x0E) && (device.enabledCycles() == 0x0E), "initial setup enables cycles 1 to 3");
+    check((mock.getRegister(CYCLE0_SETUP1) == 0) && (mock.getRegister(CYCLE4_SETUP1) == 0),
+        "pruned cycles have their settings cleared");
+    pruned = device.estimateReportPeriod(STOP);
+
+    profileDefault(profile);
+    device.applyProfile(profile, STOP);
+    check(device.enabledCycles() == 0x0F, "applying the default profile enables cycle 0 again");
+    full = device.estimateReportPeriod(STOP);
+
+    printf("      report period %u us with cycle 0, %u us without\n", full, pruned);
+    check((full >= 4800) && (full <= 5000), "report period estimate is 4.9 ms with cycle 0");
+    check((pruned >= 2800) && (pruned <= 3000), "report period estimate is 2.9 ms once cycle 0 is pruned");
+    check(device.pruneCycles(0x02, STOP) == 0x02, "pruneCycles keeps only the cycle of channel 1");
+}
+
+/**
+  * @name   checkWindow
+  * @brief  Checks that touched reports are read whole when every read of the transport ends with a STOP.
+  * @param  None.
+  * @retval None.
+  * @notes  The mock only acknowledges inside the window of each report and closes it at the first STOP, as the device
+  *         behind i2c-dev on Linux. The counts and LTA must then come in the same transaction as the flags.
+  */
+static void checkWindow(void)
+{
+    IQS7222 device;
+    Mock_transport mock;
+    Sensor_snapshot snapshot;
+    uint32_t decoded = 0;
+    uint32_t complete = 0;
+
+    device.setTransport(mock);
+    device.beginHeadless(MOCK_DEFAULT_ADDRESS);
+    mock.setReadStop(true);
+    mock.setReportPeriod(CHECK_REPORT_PERIOD);
+    mock.setRegister(TOUCH_FLAGS, 0x02);
+    mock.setRegister(CH1_COUNTS, 1400);
+    mock.setRegister(CH1_LTA, 1000);
+    mock.resetCounters();
+
+    for (uint8_t i = 0; i < CHECK_REPORTS; i++)
+    {
+        linuxAdvanceTime(CHECK_REPORT_PERIOD);
+        if (!device.updateStream(snapshot, STOP))
+            continue;
+        decoded++;
+        if ((snapshot.countsMask & 0x02) && (snapshot.counts[1] == 1400) && (snapshot.lta[1] == 1000))
+            complete++;
+    }
+
+    printf("      %u of %u touched reports decoded, %u with their counts, %u windows\n", decoded, CHECK_REPORTS,
+        complete, mock.windows);
+    check(!mock.keepsWindow(), "reads of the windowed mock end with a STOP");
+    check((decoded == CHECK_REPORTS) && (complete == CHECK_REPORTS), "touched reports are decoded with their counts");
+    check(mock.windows == CHECK_REPORTS, "each report is read in one window");
+}
+
+int main(void)
+{
+    linuxSimulateTime(true);
+    linuxPlatformBegin("/dev/null", NULL);
+
+    checkClock();
+    checkCycles();
+    checkWindow();
+
+    printf("%u checks failed\n", checkFailures);
+    return checkFailures;
+}
@@ -0,0 +1,106 @@
+/**
+  **********************************************************************************
+  * @file     seqlock_stress.cpp
+  * @author   Colin Laganier
+  * @version  V0.1
+  * @date     2026-10-18
+  * @brief   This file contains a host stress test of the Seqlock which publishes the
+  *          sensor state: one writer updates a large value while reader threads check
+  *          every copy they take.
+  **********************************************************************************
+  * @attention  Build from the repository root:
+  *               g++ -std=gnu++11 -O2 -Iplatform/linux -I. utils/seqlock_stress.cpp -pthread -o seqlock_stress
+  *             Usage: seqlock_stress [updates] [readers]
+  *             Returns 1 if a reader took a torn or stale copy.
+  */
+
+  // Include Files
+#include "IQS7222_seqlock.h"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+// Words of the published value, larger than Sensor_state so that a torn copy is likely to show
+#define STRESS_WORDS 32
+
+typedef struct {
+    uint32_t words[STRESS_WORDS];	// Every word holds the number of the update which wrote it
+} Stress_value;
+
+typedef struct {
+    uint64_t reads;
+    uint64_t torn;			// Copies mixing two updates
+    uint64_t stale;			// Copies older than a previous copy, or not matching the returned count
+} Stress_result;
+
+static Seqlock<Stress_value> stressLock;
+static std::atomic<bool> stressDone(false);
+
+/**
+  * @name   stressReader
+  * @brief  Reads the value until the writer is done and checks every copy.
+  * @param  result -> Receives the counts of the reader.
+  * @retval None.
+  * @notes  Update n writes n to every word, so a consistent copy has equal words and the count returned by read
+  *         equals them. The copies of one reader never go back in time.
+  */
+static void stressReader(Stress_result& result)
+{
+    Stress_value value;
+    uint32_t last = 0;
+
+    while (!stressDone.load())
+    {
+        Seqlock_count count = stressLock.read(value);
+
+        result.reads++;
+        for (uint8_t i = 1; i < STRESS_WORDS; i++)
+        {
+            if (value.words[i] != value.words[0])
+            {
+                result.torn++;
+                break;
+            }
+        }
+        if ((value.words[0] < last) || (value.words[0] != count))
+            result.stale++;
+        last = value.words[0];
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    uint32_t updates = (argc > 1) ? atoi(argv[1]) : 5000000;
+    uint32_t numReaders = (argc > 2) ? atoi(argv[2]) : 3;
+    std::vector<Stress_result> results(numReaders, Stress_result{ 0, 0, 0 });
+    std::vector<std::thread> readers;
+    Stress_result total = { 0, 0, 0 };
+
+    for (uint32_t i = 0; i < numReaders; i++)
+        readers.push_back(std::thread(stressReader, std::ref(results[i])));
+
+    for (uint32_t n = 1; n <= updates; n++)
+    {
+        stressLock.update([n](Stress_value& value)
+        {
+            for (uint8_t i = 0; i < STRESS_WORDS; i++)
+                value.words[i] = n;
+        });
+    }
+    stressDone.store(true);
+
+    for (uint32_t i = 0; i < numReaders; i++)
+    {
+        readers[i].join();
+        total.reads += results[i].reads;
+        total.torn += results[i].torn;
+        total.stale += results[i].stale;
+    }
+
+    printf("%u updates, %u readers, %llu reads, %llu torn, %llu stale, version %u\n", updates, numReaders,
+        (unsigned long long)total.reads, (unsigned long long)total.torn, (unsigned long long)total.stale,
+        (unsigned)stressLock.version());
+    return ((total.torn == 0) && (total.stale == 0) && (stressLock.version() == updates)) ? 0 : 1;
+}
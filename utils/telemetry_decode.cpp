@@ -0,0 +1,464 @@
+/**
+  **********************************************************************************
+  * @file     telemetry_decode.cpp
+  * @author   Colin Laganier
+  * @version  V0.1
+  * @date     2026-10-18
+  * @brief   This file contains the host decoder of the telemetry log written by
+  *          Telemetry_encoder: summary, CSV export and per-channel statistics of a time range.
+  **********************************************************************************
+  * @attention  Build from the repository root:
+  *               g++ -std=gnu++11 -O3 -Iplatform/linux -I. -DIQS7222_MAGNETIC
+  *                 utils/telemetry_decode.cpp IQS7222_telemetry.cpp -pthread -o telemetry_decode
+  *             Usage: telemetry_decode <log> info
+  *                    telemetry_decode <log> csv [from s] [to s]
+  *                    telemetry_decode <log> stats [from s] [to s] [threads]
+  *             Times are seconds from the start of the log. The log is mapped rather than read,
+  *             the range is found by a binary search over the block headers and the blocks of
+  *             stats are decoded in parallel, so a range of a multi-GB log is decoded at about
+  *             the speed the memory delivers it. Blocks failing their CRC are skipped and counted.
+  *             Blocks are found by their headers rather than by their position: a block the sink
+  *             only partly wrote shifts the following ones, which are found again by their magic.
+  *             Build with the layout of the device (-DIQS7222_MAGNETIC...) to name the values,
+  *             the values of another layout are decoded as numbered values.
+  */
+
+  // Include Files
+#include "IQS7222_telemetry.h"
+#include <algorithm>
+#include <chrono>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#define DECODE_NO_TIME UINT64_MAX
+
+// Mapped log
+typedef struct {
+    const uint8_t* data;
+    size_t size;
+    uint16_t blockSize;
+    uint8_t numValues;
+} Decode_log;
+
+// Statistics of a range of blocks, merged across threads
+typedef struct {
+    uint64_t frames;
+    uint64_t blocks;
+    uint64_t corrupt;
+    uint64_t firstTime;
+    uint64_t lastTime;
+    uint64_t sum[TELEMETRY_MAX_VALUES];
+    uint16_t minimum[TELEMETRY_MAX_VALUES];
+    uint16_t maximum[TELEMETRY_MAX_VALUES];
+    uint64_t active[16];	// Frames with the touch flag of each channel set
+} Decode_stats;
+
+/**************************************************************************************************************/
+/*                                                FUNCTIONS                                                   */
+/**************************************************************************************************************/
+
+/**
+  * @name   findHeader
+  * @brief  Finds the first valid block header at or after an offset.
+  * @param  data, size -> The mapped log.
+  *         offset     -> Offset in bytes where the search starts.
+  *         header     -> Receives the header found.
+  * @retval Offset of the header, size if there is none.
+  * @notes  Only the offsets holding the first byte of the magic are checked.
+  */
+static size_t findHeader(const uint8_t* data, size_t size, size_t offset, Telemetry_header& header)
+{
+    while ((offset + TELEMETRY_HEADER_SIZE) <= size)
+    {
+        const uint8_t* magic = (const uint8_t*)memchr(&data[offset], (uint8_t)TELEMETRY_MAGIC, size - offset);
+
+        if (magic == NULL)
+            break;
+        offset = magic - data;
+        if (telemetryReadHeader(&data[offset], size - offset, header))
+            return offset;
+        offset++;
+    }
+    return size;
+}
+
+/**
+  * @name   openLog
+  * @brief  Maps a log and reads the block size from its first valid block.
+  * @param  path -> The log file.
+  *         log  -> Receives the mapping.
+  * @retval False if the file cannot be mapped or holds no valid block.
+  * @notes  The mapping is kept until the process exits.
+  */
+static bool openLog(const char* path, Decode_log& log)
+{
+    struct stat status;
+    Telemetry_header header;
+    int fd = open(path, O_RDONLY);
+
+    if ((fd < 0) || (fstat(fd, &status) != 0) || (status.st_size < TELEMETRY_HEADER_SIZE))
+        return false;
+    log.size = status.st_size;
+    log.data = (const uint8_t*)mmap(NULL, log.size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (log.data == MAP_FAILED)
+        return false;
+
+    for (size_t offset = 0; offset < log.size; offset++)
+    {
+        offset = findHeader(log.data, log.size, offset, header);
+        if ((offset < log.size) && (header.blockSize >= TELEMETRY_HEADER_SIZE))
+        {
+            log.blockSize = header.blockSize;
+            log.numValues = header.numValues;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+  * @name   nextBlock
+  * @brief  Finds the first block of the log starting at or after an offset.
+  * @param  log    -> The log.
+  *         offset -> Offset in bytes where the search starts, where the block is expected.
+  *         header -> Receives the header of the block found.
+  * @retval Offset of the block, log.size if there is none.
+  * @notes  Blocks follow each other every blockSize bytes. When the sink failed part way through a block the following
+  *         blocks are shifted and are found again by their header. A block must fit in the log and match its block
+  *         size and values per frame.
+  */
+static size_t nextBlock(const Decode_log& log, size_t offset, Telemetry_header& header)
+{
+    while (offset < log.size)
+    {
+        offset = findHeader(log.data, log.size, offset, header);
+        if ((offset + log.blockSize) > log.size)
+            break;
+        if ((header.blockSize == log.blockSize) && (header.numValues == log.numValues))
+            return offset;
+        offset++;
+    }
+    return log.size;
+}
+
+/**
+  * @name   blockTime
+  * @brief  Returns the keyframe time of the first valid block starting at or after an offset.
+  * @param  log    -> The log.
+  *         offset -> Offset in bytes.
+  * @retval Time in microseconds, DECODE_NO_TIME if no valid block follows.
+  * @notes  Only headers are read, the pages of the payloads are not touched.
+  */
+static uint64_t blockTime(const Decode_log& log, size_t offset)
+{
+    Telemetry_header header;
+
+    return (nextBlock(log, offset, header) < log.size) ? header.time : DECODE_NO_TIME;
+}
+
+/**
+  * @name   findBlock
+  * @brief  Finds the block holding a time.
+  * @param  log  -> The log.
+  *         time -> Time in microseconds.
+  * @retval Offset of the last block starting at or before time, of the first block if time is before the log, log.size
+  *         if the log holds no valid block.
+  * @notes  Binary search over the offsets, the keyframe times increase with the offset within a log. The first block
+  *         after the last offset whose next block is not later than time is that block itself.
+  */
+static size_t findBlock(const Decode_log& log, uint64_t time)
+{
+    Telemetry_header header;
+    size_t low = 0;
+    size_t high = log.size;
+
+    if (blockTime(log, 0) > time)
+        return nextBlock(log, 0, header);
+
+    while ((high - low) > 1)
+    {
+        size_t middle = low + (high - low) / 2;
+        if (blockTime(log, middle) <= time)
+            low = middle;
+        else
+            high = middle;
+    }
+    return nextBlock(log, low, header);
+}
+
+static void clearStats(Decode_stats& stats)
+{
+    memset(&stats, 0, sizeof(stats));
+    stats.firstTime = DECODE_NO_TIME;
+    std::fill(stats.minimum, stats.minimum + TELEMETRY_MAX_VALUES, UINT16_MAX);
+}
+
+/**
+  * @name   decodeStats
+  * @brief  Accumulates the statistics of the frames of a range of blocks inside a time range.
+  * @param  log          -> The log.
+  *         first, last  -> Offsets of the range, the blocks starting in it are decoded.
+  *         from, to     -> Time range in microseconds, to excluded.
+  *         stats        -> Receives the statistics.
+  * @retval None.
+  * @notes  Runs in a worker thread, only reads the log. The bytes skipped to find a block count as corrupt blocks.
+  */
+static void decodeStats(const Decode_log& log, size_t first, size_t last, uint64_t from, uint64_t to, Decode_stats& stats)
+{
+    uint16_t maxFrames = 1 + (log.blockSize - TELEMETRY_HEADER_SIZE) / 2;
+    std::vector<Telemetry_frame> frames(maxFrames);
+    uint8_t touchValue = (log.numValues == TELEMETRY_NUM_VALUES) ? TELEMETRY_TOUCH_FLAGS : UINT8_MAX;
+    Telemetry_header header;
+
+    clearStats(stats);
+    for (size_t offset = nextBlock(log, first, header); offset < last; )
+    {
+        uint16_t count = telemetryDecodeBlock(&log.data[offset], log.blockSize, frames.data(), maxFrames);
+        size_t next = nextBlock(log, offset + log.blockSize, header);
+
+        if (next < last)
+            stats.corrupt += (next - offset - 1) / log.blockSize;
+        offset = next;
+        if (count == 0)
+        {
+            stats.corrupt++;
+            continue;
+        }
+        stats.blocks++;
+
+        for (uint16_t i = 0; i < count; i++)
+        {
+            const Telemetry_frame& frame = frames[i];
+
+            if ((frame.time < from) || (frame.time >= to))
+                continue;
+            stats.firstTime = std::min(stats.firstTime, frame.time);
+            stats.lastTime = std::max(stats.lastTime, frame.time);
+            stats.frames++;
+            // Over every slot rather than numValues so that the loop is vectorised, the unused slots are 0
+            for (uint8_t j = 0; j < TELEMETRY_MAX_VALUES; j++)
+            {
+                stats.sum[j] += frame.values[j];
+                stats.minimum[j] = std::min(stats.minimum[j], frame.values[j]);
+                stats.maximum[j] = std::max(stats.maximum[j], frame.values[j]);
+            }
+            if (touchValue != UINT8_MAX)
+            {
+                for (uint16_t flags = frame.values[touchValue]; flags; flags &= flags - 1)
+                    stats.active[__builtin_ctz(flags)]++;
+            }
+        }
+    }
+}
+
+static void mergeStats(Decode_stats& total, const Decode_stats& part)
+{
+    total.frames += part.frames;
+    total.blocks += part.blocks;
+    total.corrupt += part.corrupt;
+    total.firstTime = std::min(total.firstTime, part.firstTime);
+    total.lastTime = std::max(total.lastTime, part.lastTime);
+    for (uint8_t j = 0; j < TELEMETRY_MAX_VALUES; j++)
+    {
+        total.sum[j] += part.sum[j];
+        total.minimum[j] = std::min(total.minimum[j], part.minimum[j]);
+        total.maximum[j] = std::max(total.maximum[j], part.maximum[j]);
+    }
+    for (uint8_t j = 0; j < 16; j++)
+        total.active[j] += part.active[j];
+}
+
+/**
+  * @name   printInfo
+  * @brief  Prints the size, time span and compression of a log from its headers.
+  * @param  log -> The log.
+  * @retval None.
+  * @notes  The payloads are not decoded, the CRCs are not checked. The blocks the sink failed to store are counted from
+  *         the gaps in the block sequence numbers.
+  */
+static void printInfo(const Decode_log& log)
+{
+    Telemetry_header header;
+    uint64_t frames = 0;
+    uint64_t payload = 0;
+    uint64_t first = DECODE_NO_TIME;
+    uint64_t last = 0;
+    size_t blocks = 0;
+    size_t invalid = 0;
+    size_t lost = 0;
+    size_t expected = 0;
+    uint32_t sequence = 0;
+
+    for (size_t offset = nextBlock(log, 0, header); offset < log.size; offset = nextBlock(log, expected, header))
+    {
+        size_t skipped = (offset - expected + log.blockSize - 1) / log.blockSize;
+
+        // Blocks missing from the sequence which left no bytes in the log
+        invalid += skipped;
+        if ((blocks != 0) && (header.sequence > (sequence + 1 + skipped)))
+            lost += header.sequence - sequence - 1 - skipped;
+        sequence = header.sequence;
+        expected = offset + log.blockSize;
+        blocks++;
+        frames += header.frames;
+        payload += header.payloadSize;
+        first = std::min(first, header.time);
+        last = std::max(last, header.time);
+    }
+    invalid += (log.size - std::min(expected, log.size)) / log.blockSize;
+
+    printf("%zu blocks of %u bytes, %zu without a valid header, %zu lost by the sink, %u values per frame\n",
+        blocks + invalid, log.blockSize, invalid, lost, log.numValues);
+    if (frames == 0)
+        return;
+    printf("%llu frames over %.1f s, %.2f bytes per frame (%.2f with padding), %.1fx smaller than raw frames\n",
+        (unsigned long long)frames, (last - first) / 1e6, (double)payload / frames, (double)log.size / frames,
+        (2.0 * log.numValues + 4) * frames / log.size);
+}
+
+/**
+  * @name   printCsv
+  * @brief  Prints the frames of a time range as CSV.
+  * @param  log      -> The log.
+  *         from, to -> Time range in microseconds, to excluded.
+  * @retval None.
+  * @notes  Flags in hexadecimal, counts and LTA in decimal.
+  */
+static void printCsv(const Decode_log& log, uint64_t from, uint64_t to)
+{
+    uint16_t maxFrames = 1 + (log.blockSize - TELEMETRY_HEADER_SIZE) / 2;
+    std::vector<Telemetry_frame> frames(maxFrames);
+    bool named = (log.numValues == TELEMETRY_NUM_VALUES);
+
+    printf("time");
+    for (uint8_t j = 0; j < log.numValues; j++)
+    {
+        if (!named)
+            printf(",v%u", j);
+        else if (j == TELEMETRY_PROX_FLAGS)
+            printf(",prox");
+        else if (j == TELEMETRY_TOUCH_FLAGS)
+            printf(",touch");
+        else if (j < TELEMETRY_LTA(0))
+            printf(",counts%u", j - TELEMETRY_COUNTS(0));
+        else
+            printf(",lta%u", j - TELEMETRY_LTA(0));
+    }
+    printf("\n");
+
+    Telemetry_header header;
+
+    for (size_t offset = findBlock(log, from); offset < log.size; offset = nextBlock(log, offset + log.blockSize, header))
+    {
+        uint16_t count = telemetryDecodeBlock(&log.data[offset], log.blockSize, frames.data(), maxFrames);
+
+        for (uint16_t i = 0; i < count; i++)
+        {
+            if (frames[i].time >= to)
+                return;
+            if (frames[i].time < from)
+                continue;
+            printf("%.6f", frames[i].time / 1e6);
+            for (uint8_t j = 0; j < log.numValues; j++)
+                printf(named && (j <= TELEMETRY_TOUCH_FLAGS) ? ",%04X" : ",%u", frames[i].values[j]);
+            printf("\n");
+        }
+    }
+}
+
+/**
+  * @name   printStats
+  * @brief  Decodes a time range on several threads and prints the statistics of each value.
+  * @param  log        -> The log.
+  *         from, to   -> Time range in microseconds, to excluded.
+  *         numThreads -> Number of worker threads.
+  * @retval None.
+  * @notes  The decode throughput is printed to stderr.
+  */
+static void printStats(const Decode_log& log, uint64_t from, uint64_t to, uint32_t numThreads)
+{
+    size_t first = findBlock(log, from);
+    size_t last = (to == DECODE_NO_TIME) ? log.size : std::min(findBlock(log, to) + 1, log.size);
+    size_t slots = (last - first + log.blockSize - 1) / log.blockSize;
+    std::vector<Decode_stats> parts(numThreads);
+    std::vector<std::thread> workers;
+    Decode_stats total;
+    bool named = (log.numValues == TELEMETRY_NUM_VALUES);
+    auto start = std::chrono::steady_clock::now();
+
+    // Each thread takes a range of blocksize slots, a shifted block belongs to the range it starts in
+    madvise((void*)&log.data[first], std::min(last + log.blockSize, log.size) - first, MADV_SEQUENTIAL);
+    for (uint32_t i = 0; i < numThreads; i++)
+    {
+        size_t begin = first + (slots * i / numThreads) * log.blockSize;
+        size_t end = std::min(first + (slots * (i + 1) / numThreads) * log.blockSize, last);
+        workers.push_back(std::thread(decodeStats, std::cref(log), begin, end, from, to, std::ref(parts[i])));
+    }
+    clearStats(total);
+    for (uint32_t i = 0; i < numThreads; i++)
+    {
+        workers[i].join();
+        mergeStats(total, parts[i]);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    fprintf(stderr, "Decoded %.1f MB in %.3f s on %u threads, %.0f MB/s, %.1f M frames/s\n",
+        (last - first) / 1e6, seconds, numThreads, (last - first) / 1e6 / seconds,
+        total.frames / 1e6 / seconds);
+    printf("%llu frames in %llu blocks, %llu blocks not decoded (header or CRC)\n",
+        (unsigned long long)total.frames, (unsigned long long)total.blocks, (unsigned long long)total.corrupt);
+    if (total.frames == 0)
+        return;
+    printf("%.3f s to %.3f s\n", total.firstTime / 1e6, total.lastTime / 1e6);
+
+    if (!named)
+    {
+        for (uint8_t j = 0; j < log.numValues; j++)
+            printf("v%-2u min %5u mean %8.1f max %5u\n", j, total.minimum[j], (double)total.sum[j] / total.frames, total.maximum[j]);
+        return;
+    }
+    printf("channel   counts min/mean/max        LTA min/mean/max       touch\n");
+    for (uint8_t i = 0; i < IQS7222_NUM_CHANNELS; i++)
+    {
+        uint8_t counts = TELEMETRY_COUNTS(i);
+        uint8_t lta = TELEMETRY_LTA(i);
+        printf("%7u  %5u %8.1f %5u    %5u %8.1f %5u    %5.1f%%\n", i,
+            total.minimum[counts], (double)total.sum[counts] / total.frames, total.maximum[counts],
+            total.minimum[lta], (double)total.sum[lta] / total.frames, total.maximum[lta],
+            100.0 * total.active[i] / total.frames);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    Decode_log log;
+    const char* command = (argc > 2) ? argv[2] : "info";
+    uint64_t from = (argc > 3) ? (uint64_t)(atof(argv[3]) * 1e6) : 0;
+    uint64_t to = (argc > 4) ? (uint64_t)(atof(argv[4]) * 1e6) : DECODE_NO_TIME;
+    uint32_t numThreads = (argc > 5) ? atoi(argv[5]) : std::max(1u, std::thread::hardware_concurrency());
+
+    if (argc < 2)
+    {
+        printf("Usage: telemetry_decode <log> [info | csv [from s] [to s] | stats [from s] [to s] [threads]]\n");
+        return 1;
+    }
+    if (!openLog(argv[1], log))
+    {
+        fprintf(stderr, "%s is not a telemetry log\n", argv[1]);
+        return 1;
+    }
+
+    if (strcmp(command, "csv") == 0)
+        printCsv(log, from, to);
+    else if (strcmp(command, "stats") == 0)
+        printStats(log, from, to, std::max(1u, numThreads));
+    else
+        printInfo(log);
+    return 0;
+}
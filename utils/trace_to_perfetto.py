@@ -0,0 +1,77 @@
+#!/usr/bin/env python3
+
+# Converts the raw spans drained with IQS7222::readTrace into Chrome trace / Perfetto JSON.
+# Usage: trace_to_perfetto.py <spans.bin> <trace.json> [ticks per microsecond]
+# The input is the concatenation of the 12 byte Trace_span structures written as raw bytes.
+
+import json
+import struct
+import sys
+
+# Span layout, see IQS7222_trace.h
+spanFormat = "<IIHBB"
+spanSize = struct.calcsize(spanFormat)
+
+# Operation names and the trace lane each operation is drawn on
+opNames = ["RDY wait", "I2C read", "I2C write", "Decode", "Gesture", "Initial setup"]
+opLanes = [1, 2, 2, 3, 4, 0]
+laneNames = ["Setup", "RDY", "I2C", "Decode", "Gesture"]
+
+# Unwraps the 32bit probe clock into a monotonic tick count
+class Unwrapper:
+	def __init__(self):
+		self.offset = 0
+		self.previous = None
+
+	def unwrap(self, tick):
+		if (self.previous != None) and (tick < self.previous) and ((self.previous - tick) > 0x80000000):
+			self.offset += 0x100000000
+		self.previous = tick
+		return tick + self.offset
+
+# Reads the spans from the binary dump
+def readSpans(path):
+	with open(path, "rb") as file:
+		data = file.read()
+	usable = len(data) - (len(data) % spanSize)
+	return [struct.unpack_from(spanFormat, data, offset) for offset in range(0, usable, spanSize)]
+
+# Builds the list of trace events from the spans
+def buildEvents(spans, ticksPerMicro):
+	events = []
+	unwrapper = Unwrapper()
+
+	for lane, name in enumerate(laneNames):
+		events.append({"name": "thread_name", "ph": "M", "pid": 1, "tid": lane, "args": {"name": name}})
+
+	for begin, end, address, op, length in spans:
+		start = unwrapper.unwrap(begin)
+		duration = (end - begin) & 0xFFFFFFFF
+		name = opNames[op] if op < len(opNames) else f"Op {op}"
+		event = {
+			"name": name,
+			"ph": "X",
+			"pid": 1,
+			"tid": opLanes[op] if op < len(opLanes) else 0,
+			"ts": start / ticksPerMicro,
+			"dur": duration / ticksPerMicro,
+		}
+		if (length != 0):
+			event["args"] = {"address": f"0x{address:04X}", "length": length}
+		events.append(event)
+
+	return events
+
+
+if __name__ == "__main__":
+	if len(sys.argv) < 3:
+		print("Usage: trace_to_perfetto.py <spans.bin> <trace.json> [ticks per microsecond]")
+		sys.exit(1)
+
+	ticksPerMicro = float(sys.argv[3]) if len(sys.argv) > 3 else 1.0
+	spans = readSpans(sys.argv[1])
+
+	with open(sys.argv[2], "w") as file:
+		json.dump({"traceEvents": buildEvents(spans, ticksPerMicro), "displayTimeUnit": "ns"}, file)
+
+	print(f"Converted {len(spans)} spans")